@@ -0,0 +1,24 @@
+#!/bin/bash
+
+LD_LIBRARY_PATH=../../import/lib; export LD_LIBRARY_PATH
+
+# Host-side benchmarks against a pseudo-terminal; no HVC-P2 is required.
+./HVCBench idle 3
+./HVCBench arrival 200
+./HVCBench wakeup 1000 6
+./HVCBench wakeup 1000 6 load
+./HVCBench wakeup 1000 6 rt+load
+./HVCBench throughput 16384
+./HVCBench throughput 16384 peek
+./HVCBench scaling 64 2
+./HVCBench transport 10000
+./HVCBench replay 5000
+./HVCBench execute 2000
+./HVCBench async 4 50
+./HVCBench stream 100
+./HVCBench progressive 3
+./HVCBench packed 1000
+./HVCBench config 20
+./HVCBench batch 100
+./HVCBench resync 1000
+./HVCBench check
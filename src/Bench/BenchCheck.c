@@ -0,0 +1,720 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Pass/fail checks of HVCApi against the simulated device: response framing
+    on a line with stray bytes, command batches and a full album
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCDef.h"
+#include "HVCSim.h"
+#include "HVCBench.h"
+
+#define CHECK_TIMEOUT           1000
+#define CHECK_BAD_USER          0xFFFF  /* Rejected by the device */
+#define CHECK_BATCH_MAX         101     /* Most commands in one checked batch */
+#define CHECK_VERIFY_THRESHOLD  0x1A3   /* Both bytes of the value differ from any noise */
+#define CHECK_EXEC              (HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_HAND_DETECTION | HVC_ACTIV_FACE_DETECTION)
+#define CHECK_HELD_MAX          4096    /* Longest response CHECK_EXEC gets */
+#define CHECK_ALBUM_USER        500     /* User IDs 0-499 */
+#define CHECK_ALBUM_DATA        2       /* Data IDs per user: every user fills the album */
+
+/* Commands and windows of the batch checks. A DeleteUser is 6 bytes, so 42  */
+/* fit one write: the counts cover one command, a write filled to the byte,   */
+/* one command more, and several writes; the windows split them elsewhere,   */
+/* and the largest keep several writes in flight.                            */
+static const int m_anBatchNum[] = { 1, 42, 43, 100 };
+static const INT32 m_anBatchWindow[] = { 0, 1, 4, 42, 43, 70, 100 };
+
+#define CHECK_COUNT(a)  (int)(sizeof(a)/sizeof((a)[0]))
+
+/* Stray bytes of the framing checks. Each burst holds false headers: a     */
+/* response code the device never sends, and a normal end whose length does */
+/* not fit the command; no burst ends with a sync byte.                      */
+static const UINT8 m_acNoiseHeader[] = {
+    0xFE, 0xE5, 0x02, 0x00, 0x00, 0x00,     /* Response code 0xE5 */
+    0xFE, 0x00, 0x05, 0x00, 0x00, 0x00,     /* 5 bytes for GetVerifyThreshold */
+    0x11, 0x22, 0xFE, 0x44
+};
+static const UINT8 m_acNoisePayload[] = {
+    0x11,                                   /* Taken as the upper byte of the value */
+    0xFE, 0xE5, 0x02, 0x00, 0x00, 0x00,
+    0x5A
+};
+static const UINT8 m_acNoiseAsync[] = {
+    0xFE, 0xE5, 0x02, 0x00, 0x00, 0x00,
+    0x31, 0x32, 0x33
+};
+
+/* Loopback line of the simulated device. Stray bytes go into one response; */
+/* that response may also be held back until the check puts it on the line. */
+typedef struct {
+    HVCSIM          *pSim;
+    HCOM            hCom;
+    const UINT8     *pNoise;    /* Stray bytes, NULL...clean line */
+    int             nNoise;
+    int             nResponse;  /* Responses passed clean before the noisy one */
+    int             nNoiseAt;   /* Bytes of that response ahead of the noise */
+    int             bHold;      /* Keep that response in held[], noise only */
+    UINT8           held[CHECK_HELD_MAX];
+    int             nHeld;
+} CHECK_LINE;
+
+/* Simulated device answering on a loopback port, inside com_send() */
+static void CheckOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    CHECK_LINE *pLine = (CHECK_LINE *)pParam;
+    int nAt;
+
+    (void)inCmdSize;
+    (void)inProcTime;
+    if ( pLine->pNoise == NULL || pLine->nResponse-- > 0 ) {
+        com_loopback_inject(pLine->hCom, inData, inSize);
+        return;
+    }
+
+    nAt = (pLine->nNoiseAt < inSize) ? pLine->nNoiseAt : inSize;
+    com_loopback_inject(pLine->hCom, inData, nAt);
+    com_loopback_inject(pLine->hCom, pLine->pNoise, pLine->nNoise);
+    if ( pLine->bHold && inSize - nAt <= (int)sizeof(pLine->held) ) {
+        memcpy(pLine->held, &inData[nAt], inSize - nAt);
+        pLine->nHeld = inSize - nAt;
+    }
+    else {
+        com_loopback_inject(pLine->hCom, &inData[nAt], inSize - nAt);
+    }
+    pLine->pNoise = NULL;
+}
+
+/* Stray bytes for a later response */
+static void CheckNoise(CHECK_LINE *pLine, const UINT8 *inNoise, int inSize, int inResponse, int inAt, int inHold)
+{
+    pLine->nNoise = inSize;
+    pLine->nResponse = inResponse;
+    pLine->nNoiseAt = inAt;
+    pLine->bHold = inHold;
+    pLine->nHeld = 0;
+    pLine->pNoise = inNoise;
+}
+
+static void CheckDevice(void *pParam, HCOM hCom, const unsigned char *buf, int len)
+{
+    (void)hCom;
+    HVCSim_Input((HVCSIM *)pParam, buf, len);
+}
+
+/* Prints one check and counts it if it failed */
+static void Report(int *ioFailed, int inOk, const char *inTitle, const char *inDetail)
+{
+    printf("%-36s %s%s%s\n", inTitle, inOk ? "ok" : "FAILED", (inDetail[0] != '\0') ? "  " : "", inDetail);
+    if ( !inOk ) (*ioFailed)++;
+}
+
+/* Header searches since com_reset_stats(): 0...one search skipped inSkips */
+static int CheckSkips(HCOM hCom, int inSkips, char *outDetail, int inDetailSize)
+{
+    COM_STATS stats;
+
+    com_get_stats(hCom, &stats);
+    if ( stats.nHeaderResyncs != 1 || stats.nHeaderSkips != (unsigned long long)inSkips ) {
+        snprintf(outDetail, inDetailSize, "%llu header search(es) skipped %llu byte(s), expected 1 and %d",
+                 stats.nHeaderResyncs, stats.nHeaderSkips, inSkips);
+        return -1;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* GetVerifyThreshold with false headers and stray bytes ahead of the header  */
+/*----------------------------------------------------------------------------*/
+static int CheckNoiseHeader(CHECK_LINE *pLine, char *outDetail, int inDetailSize)
+{
+    INT32 ret;
+    INT32 threshold = -1;
+    UINT8 status = 0xAA;
+
+    ret = HVC_SetVerifyThreshold(pLine->hCom, CHECK_TIMEOUT, CHECK_VERIFY_THRESHOLD, &status);
+    if ( ret != 0 || status != 0 ) {
+        snprintf(outDetail, inDetailSize, "SetVerifyThreshold: ret=%d status=0x%02X", ret, status);
+        return -1;
+    }
+
+    com_reset_stats(pLine->hCom);
+    CheckNoise(pLine, m_acNoiseHeader, sizeof(m_acNoiseHeader), 0, 0, 0);
+    ret = HVC_GetVerifyThreshold(pLine->hCom, CHECK_TIMEOUT, &threshold, &status);
+    if ( ret != 0 || status != 0 || threshold != CHECK_VERIFY_THRESHOLD ) {
+        snprintf(outDetail, inDetailSize, "ret=%d status=0x%02X threshold=%d", ret, status, threshold);
+        return -1;
+    }
+    return CheckSkips(pLine->hCom, sizeof(m_acNoiseHeader), outDetail, inDetailSize);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Batch of GetVerifyThreshold with stray bytes inside the second payload,    */
+/* after its first byte: that command reads the first stray byte as the upper */
+/* byte, the rest and its own upper byte are skipped ahead of the next header */
+/*----------------------------------------------------------------------------*/
+static int CheckNoisePayload(CHECK_LINE *pLine, HVC_BATCH_COMMAND *pCommand, char *outDetail, int inDetailSize)
+{
+    int i;
+    INT32 ret;
+    INT32 expect;
+    INT32 threshold[4];
+    HVC_BATCH batch;
+
+    HVC_BatchInit(&batch, pCommand, CHECK_BATCH_MAX);
+    for ( i = 0; i < CHECK_COUNT(threshold); i++ ) {
+        threshold[i] = -1;
+        HVC_BatchGetVerifyThreshold(&batch, &threshold[i]);
+    }
+
+    com_reset_stats(pLine->hCom);
+    CheckNoise(pLine, m_acNoisePayload, sizeof(m_acNoisePayload), 1, 6 + 1, 0);
+    ret = HVC_BatchRun(pLine->hCom, CHECK_TIMEOUT, &batch, 0);
+    for ( i = 0; i < CHECK_COUNT(threshold); i++ ) {
+        expect = (i == 1) ? ((CHECK_VERIFY_THRESHOLD & 0xFF) | (m_acNoisePayload[0] << 8)) : CHECK_VERIFY_THRESHOLD;
+        if ( pCommand[i].ret != 0 || pCommand[i].status != 0 || threshold[i] != expect ) {
+            snprintf(outDetail, inDetailSize, "ret=%d, command %d: ret=%d status=0x%02X threshold=0x%X", ret, i,
+                     pCommand[i].ret, pCommand[i].status, threshold[i]);
+            return -1;
+        }
+    }
+    return CheckSkips(pLine->hCom, sizeof(m_acNoisePayload), outDetail, inDetailSize);
+}
+
+/*----------------------------------------------------------------------------*/
+/* ExecuteEx polled while only stray bytes are on the line: every poll must   */
+/* return at once, and once the response follows the result must be the one  */
+/* of a clean line                                                            */
+/*----------------------------------------------------------------------------*/
+static int CheckNoiseAsync(CHECK_LINE *pLine, HVC_RESULT *pResult, HVC_RESULT *pExpect,
+                           char *outDetail, int inDetailSize)
+{
+    int i;
+    INT32 ret;
+    UINT8 status = 0xAA;
+    double start, slowest = 0;
+    HVC_ASYNC async;
+
+    /* The device gives the same people for the same frame number */
+    memset(pExpect, 0, sizeof(HVC_RESULT));
+    HVCSim_Reset(pLine->pSim);
+    ret = HVC_ExecuteEx(pLine->hCom, CHECK_TIMEOUT, CHECK_EXEC, HVC_EXECUTE_IMAGE_NONE, pExpect, &status);
+    if ( ret != 0 || status != 0 ) {
+        snprintf(outDetail, inDetailSize, "clean ExecuteEx: ret=%d status=0x%02X", ret, status);
+        return -1;
+    }
+
+    memset(pResult, 0, sizeof(HVC_RESULT));
+    HVCSim_Reset(pLine->pSim);
+    com_reset_stats(pLine->hCom);
+    CheckNoise(pLine, m_acNoiseAsync, sizeof(m_acNoiseAsync), 0, 0, 1);
+    status = 0xAA;
+    ret = HVC_ExecuteExBegin(&async, pLine->hCom, CHECK_TIMEOUT, CHECK_EXEC, HVC_EXECUTE_IMAGE_NONE,
+                             pResult, &status);
+    for ( i = 0; ret == 0 && i < 3; i++ ) {
+        start = Bench_NowUs();
+        ret = HVC_ExecuteExPoll(&async);
+        if ( Bench_NowUs() - start > slowest ) slowest = Bench_NowUs() - start;
+        ret = (ret == HVC_PENDING) ? 0 : ret;
+    }
+    if ( ret != 0 || pLine->nHeld == 0 || slowest > CHECK_TIMEOUT * 1000.0 / 4 ) {
+        snprintf(outDetail, inDetailSize, "poll on stray bytes: ret=%d, %d response byte(s) held, %.0f us",
+                 ret, pLine->nHeld, slowest);
+        return -1;
+    }
+
+    com_loopback_inject(pLine->hCom, pLine->held, pLine->nHeld);
+    do {
+        ret = HVC_ExecuteExPoll(&async);
+    } while ( ret == HVC_PENDING );
+    if ( ret != 0 || status != 0 || memcmp(pResult, pExpect, offsetof(HVC_RESULT, image)) != 0 ) {
+        snprintf(outDetail, inDetailSize, "ret=%d status=0x%02X, result %s", ret, status,
+                 (memcmp(pResult, pExpect, offsetof(HVC_RESULT, image)) == 0) ? "as on a clean line" : "differs");
+        return -1;
+    }
+    return CheckSkips(pLine->hCom, sizeof(m_acNoiseAsync), outDetail, inDetailSize);
+}
+
+/* Response framing on a line with stray bytes */
+static void CheckFraming(CHECK_LINE *pLine, int *ioFailed)
+{
+    char detail[128];
+    HVC_BATCH_COMMAND *pCommand;
+    HVC_RESULT *pResult;
+
+    pCommand = (HVC_BATCH_COMMAND *)malloc(sizeof(HVC_BATCH_COMMAND) * CHECK_BATCH_MAX);
+    pResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT) * 2);
+    if ( pCommand == NULL || pResult == NULL ) {
+        Report(ioFailed, 0, "framing", "out of memory");
+        free(pCommand);
+        free(pResult);
+        return;
+    }
+
+    detail[0] = '\0';
+    Report(ioFailed, CheckNoiseHeader(pLine, detail, sizeof(detail)) == 0,
+           "stray bytes ahead of a header", detail);
+    detail[0] = '\0';
+    Report(ioFailed, CheckNoisePayload(pLine, pCommand, detail, sizeof(detail)) == 0,
+           "stray bytes inside a batch payload", detail);
+    detail[0] = '\0';
+    Report(ioFailed, CheckNoiseAsync(pLine, &pResult[0], &pResult[1], detail, sizeof(detail)) == 0,
+           "stray bytes ahead of a polled header", detail);
+
+    free(pCommand);
+    free(pResult);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Full album: every user with CHECK_ALBUM_DATA data IDs, saved and loaded    */
+/* back; the saved album has the largest size the device sends                */
+/*----------------------------------------------------------------------------*/
+static int CheckAlbumFull(HCOM hCom, HVC_IMAGE *pImage, UINT8 *pAlbum, char *outDetail, int inDetailSize)
+{
+    int i, k;
+    INT32 ret;
+    INT32 size = 0;
+    INT32 dataNo = 0;
+    UINT8 status = 0xAA;
+
+    ret = HVC_SetRegistCount(hCom, CHECK_TIMEOUT, CHECK_ALBUM_DATA, &status);
+    if ( ret != 0 || status != 0 ) {
+        snprintf(outDetail, inDetailSize, "SetRegistCount: ret=%d status=0x%02X", ret, status);
+        return -1;
+    }
+    for ( i = 0; i < CHECK_ALBUM_USER; i++ ) {
+        for ( k = 0; k < CHECK_ALBUM_DATA; k++ ) {
+            ret = HVC_Registration(hCom, CHECK_TIMEOUT, i, k, pImage, &status);
+            if ( ret != 0 || status != 0 ) {
+                snprintf(outDetail, inDetailSize, "registration of user %d data %d: ret=%d status=0x%02X",
+                         i, k, ret, status);
+                return -1;
+            }
+        }
+    }
+
+    ret = HVC_SaveAlbum(hCom, CHECK_TIMEOUT, pAlbum, &size, &status);
+    if ( ret != 0 || status != 0 || size != HVC_ALBUM_SIZE_MAX + 8 ) {
+        snprintf(outDetail, inDetailSize, "SaveAlbum: ret=%d status=0x%02X size=%d", ret, status, size);
+        return -1;
+    }
+    ret = HVC_DeleteAll(hCom, CHECK_TIMEOUT, &status);
+    if ( ret == 0 && status == 0 ) {
+        ret = HVC_LoadAlbum(hCom, CHECK_TIMEOUT, pAlbum, size, &status);
+    }
+    if ( ret == 0 && status == 0 ) {
+        ret = HVC_GetUserData(hCom, CHECK_TIMEOUT, i - 1, &dataNo, &status);
+    }
+    if ( ret != 0 || status != 0 || dataNo != (1 << CHECK_ALBUM_DATA) - 1 ) {
+        snprintf(outDetail, inDetailSize, "load back: ret=%d status=0x%02X, user %d data 0x%X", ret, status,
+                 i - 1, dataNo);
+        return -1;
+    }
+    return 0;
+}
+
+/* Progress reports of an album upload */
+typedef struct {
+    int     nCalls;
+    int     nBad;       /* Reports that did not add one chunk */
+    INT32   sent;
+} CHECK_PROGRESS;
+
+static void CheckProgress(void *pParam, INT32 inSentSize, INT32 inTotalSize)
+{
+    CHECK_PROGRESS *pProgress = (CHECK_PROGRESS *)pParam;
+    INT32 step = inSentSize - pProgress->sent;
+
+    if ( step <= 0 || step > HVC_ALBUM_SEND_CHUNK || (step < HVC_ALBUM_SEND_CHUNK && inSentSize != inTotalSize) ) {
+        pProgress->nBad++;
+    }
+    pProgress->nCalls++;
+    pProgress->sent = inSentSize;
+}
+
+/* Port that takes nBudget more bytes and then stops taking data, like a */
+/* line that failed; the device behind it answers on the loopback port   */
+typedef struct {
+    struct COM_DEVICE   base;       /* Must be first */
+    HCOM                hLine;
+    int                 nBudget;
+} CHECK_SHORT_PORT;
+
+static void ShortClose(HCOM hDev)
+{
+    free(hDev);
+}
+
+static int ShortSendv(HCOM hDev, const COM_SPAN *pVec, int nVec)
+{
+    CHECK_SHORT_PORT *pPort = (CHECK_SHORT_PORT *)hDev;
+    COM_SPAN vec[COM_SENDV_MAX];
+    int i;
+    int nLeft = pPort->nBudget;
+    int nSent;
+
+    for ( i = 0; i < nVec; i++ ) {
+        vec[i].pData = pVec[i].pData;
+        vec[i].nSize = (pVec[i].nSize < nLeft) ? pVec[i].nSize : nLeft;
+        if ( vec[i].nSize > 0 ) nLeft -= vec[i].nSize;
+    }
+    nSent = com_sendv(pPort->hLine, vec, nVec);
+    pPort->nBudget -= nSent;
+    return nSent;
+}
+
+static int ShortSend(HCOM hDev, unsigned char *buf, int len)
+{
+    COM_SPAN vec;
+
+    vec.pData = buf;
+    vec.nSize = len;
+    return ShortSendv(hDev, &vec, 1);
+}
+
+static int ShortRecv(HCOM hDev, int inTimeOutTimer, unsigned char *buf, int len)
+{
+    return com_recv(((CHECK_SHORT_PORT *)hDev)->hLine, inTimeOutTimer, buf, len);
+}
+
+static int ShortLength(HCOM hDev)
+{
+    return com_length(((CHECK_SHORT_PORT *)hDev)->hLine);
+}
+
+static const COM_OPS m_shortOps = {
+    "short", NULL, ShortClose, ShortSend, ShortRecv, ShortLength,
+    NULL, NULL, ShortSendv,
+    NULL
+};
+
+/* Port budgets of the album upload checks: the whole command, a cut inside */
+/* the fourth chunk, and a cut inside the command header                    */
+static const int m_anLoadBudget[] = { 8 + HVC_ALBUM_SIZE_MAX + 8, 8 + 3 * HVC_ALBUM_SEND_CHUNK + 100, 5 };
+
+/*----------------------------------------------------------------------------*/
+/* LoadAlbumEx through a port that takes inBudget bytes. Every chunk that     */
+/* went out must be reported once; a short send must report how much of the   */
+/* album went out, after which the device is resynchronised (as a reconnect   */
+/* would) because it still waits for the rest.                                */
+/*----------------------------------------------------------------------------*/
+static int CheckAlbumLoad(CHECK_LINE *pLine, UINT8 *pAlbum, INT32 inSize, int inBudget,
+                          char *outDetail, int inDetailSize)
+{
+    INT32 ret;
+    INT32 sent = -1;
+    INT32 expect;
+    INT32 dataNo = 0;
+    UINT8 status = 0xAA;
+    int calls;
+    CHECK_PROGRESS progress;
+    CHECK_SHORT_PORT *pPort;
+
+    ret = HVC_DeleteAll(pLine->hCom, CHECK_TIMEOUT, &status);
+    if ( ret != 0 || status != 0 ) {
+        snprintf(outDetail, inDetailSize, "DeleteAll: ret=%d status=0x%02X", ret, status);
+        return -1;
+    }
+    pPort = (CHECK_SHORT_PORT *)calloc(1, sizeof(CHECK_SHORT_PORT));
+    if ( pPort == NULL ) {
+        snprintf(outDetail, inDetailSize, "out of memory");
+        return -1;
+    }
+    pPort->base.pOps = &m_shortOps;
+    pPort->hLine = pLine->hCom;
+    pPort->nBudget = inBudget;
+
+    memset(&progress, 0, sizeof(progress));
+    status = 0xAA;
+    ret = HVC_LoadAlbumEx(&pPort->base, CHECK_TIMEOUT, pAlbum, inSize, CheckProgress, &progress, &sent, &status);
+    com_close(&pPort->base);
+
+    /* Album bytes are the ones past the 8-byte command */
+    expect = (inBudget - 8 < inSize) ? inBudget - 8 : inSize;
+    if ( expect < 0 ) expect = 0;
+    /* A chunk cut short is not reported */
+    calls = (expect == inSize) ? (inSize + HVC_ALBUM_SEND_CHUNK - 1) / HVC_ALBUM_SEND_CHUNK
+                               : expect / HVC_ALBUM_SEND_CHUNK;
+    if ( sent != expect || progress.nBad != 0 || progress.nCalls != calls ) {
+        snprintf(outDetail, inDetailSize, "ret=%d sent=%d of %d, %d progress report(s), %d out of step",
+                 ret, sent, expect, progress.nCalls, progress.nBad);
+        return -1;
+    }
+
+    if ( expect < inSize ) {
+        HVCSim_Reset(pLine->pSim);
+        if ( ret != HVC_ERROR_SEND_DATA ) {
+            snprintf(outDetail, inDetailSize, "ret=%d after %d of %d album bytes", ret, sent, inSize);
+            return -1;
+        }
+        return 0;
+    }
+
+    if ( ret == 0 && status == 0 ) {
+        ret = HVC_GetUserData(pLine->hCom, CHECK_TIMEOUT, CHECK_ALBUM_USER - 1, &dataNo, &status);
+    }
+    if ( ret != 0 || status != 0 || dataNo != (1 << CHECK_ALBUM_DATA) - 1 ) {
+        snprintf(outDetail, inDetailSize, "ret=%d status=0x%02X, user %d data 0x%X", ret, status,
+                 CHECK_ALBUM_USER - 1, dataNo);
+        return -1;
+    }
+    return 0;
+}
+
+/* Album checks; the device is back at power-on state afterwards */
+static void CheckAlbum(CHECK_LINE *pLine, int *ioFailed)
+{
+    int i;
+    char title[64];
+    char detail[128];
+    UINT8 status;
+    HVC_IMAGE *pImage;
+    UINT8 *pAlbum;
+
+    pImage = (HVC_IMAGE *)malloc(sizeof(HVC_IMAGE));
+    pAlbum = (UINT8 *)malloc(HVC_ALBUM_SIZE_MAX + 8);
+    if ( pImage == NULL || pAlbum == NULL ) {
+        Report(ioFailed, 0, "album", "out of memory");
+        free(pImage);
+        free(pAlbum);
+        return;
+    }
+
+    detail[0] = '\0';
+    Report(ioFailed, CheckAlbumFull(pLine->hCom, pImage, pAlbum, detail, sizeof(detail)) == 0,
+           "save and load a full album", detail);
+    for ( i = 0; i < CHECK_COUNT(m_anLoadBudget); i++ ) {
+        detail[0] = '\0';
+        snprintf(title, sizeof(title), "album upload, %d-byte port", m_anLoadBudget[i]);
+        Report(ioFailed, CheckAlbumLoad(pLine, pAlbum, HVC_ALBUM_SIZE_MAX + 8, m_anLoadBudget[i],
+                                        detail, sizeof(detail)) == 0, title, detail);
+    }
+
+    HVC_DeleteAll(pLine->hCom, CHECK_TIMEOUT, &status);
+    HVCSim_Reset(pLine->pSim);
+    free(pImage);
+    free(pAlbum);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Batch of nNum DeleteUser; users 0 to nNum-2 are registered first, and the  */
+/* last command names a user the device rejects                              */
+/* return   : int               0...every ret, status and the album as due    */
+/*----------------------------------------------------------------------------*/
+static int CheckBatchDelete(HCOM hCom, int nNum, INT32 inWindow, HVC_BATCH_COMMAND *pCommand, HVC_IMAGE *pImage,
+                            char *outDetail, int inDetailSize)
+{
+    int i;
+    int ret;
+    INT32 dataNo;
+    UINT8 status;
+    HVC_BATCH batch;
+
+    for ( i = 0; i < nNum - 1; i++ ) {
+        if ( HVC_Registration(hCom, CHECK_TIMEOUT, i, 0, pImage, &status) != 0 || status != 0 ) {
+            snprintf(outDetail, inDetailSize, "registration of user %d", i);
+            return -1;
+        }
+    }
+
+    HVC_BatchInit(&batch, pCommand, CHECK_BATCH_MAX);
+    for ( i = 0; i < nNum - 1; i++ ) {
+        HVC_BatchDeleteUser(&batch, i);
+    }
+    HVC_BatchDeleteUser(&batch, CHECK_BAD_USER);
+    for ( i = 0; i < nNum; i++ ) {
+        pCommand[i].ret = -1;
+        pCommand[i].status = 0xAA;
+    }
+
+    ret = HVC_BatchRun(hCom, CHECK_TIMEOUT, &batch, inWindow);
+    if ( ret != 0 ) {
+        for ( i = 0; i < nNum && pCommand[i].ret == 0; i++ ) {
+        }
+        snprintf(outDetail, inDetailSize, "ret=%d, first failed command %d", ret, i);
+        return -1;
+    }
+    for ( i = 0; i < nNum; i++ ) {
+        if ( pCommand[i].ret != 0 || (pCommand[i].status != 0) != (i == nNum - 1) ) {
+            snprintf(outDetail, inDetailSize, "command %d: ret=%d status=0x%02X", i, pCommand[i].ret,
+                     pCommand[i].status);
+            return -1;
+        }
+    }
+    for ( i = 0; i < nNum - 1; i++ ) {
+        if ( HVC_GetUserData(hCom, CHECK_TIMEOUT, i, &dataNo, &status) != 0 || status != 0 || dataNo != 0 ) {
+            snprintf(outDetail, inDetailSize, "user %d still registered", i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Batch of SetVerifyThreshold / GetVerifyThreshold pairs: each Get must read */
+/* the value of the Set just before it, so a response taken for the wrong     */
+/* command shows                                                              */
+/*----------------------------------------------------------------------------*/
+static int CheckBatchOrder(HCOM hCom, int nNum, INT32 inWindow, HVC_BATCH_COMMAND *pCommand,
+                           char *outDetail, int inDetailSize)
+{
+    int i;
+    int ret;
+    INT32 threshold[CHECK_BATCH_MAX];
+    HVC_BATCH batch;
+
+    HVC_BatchInit(&batch, pCommand, CHECK_BATCH_MAX);
+    for ( i = 0; i < nNum; i++ ) {
+        threshold[i] = -1;
+        if ( i % 2 == 0 ) HVC_BatchSetVerifyThreshold(&batch, 1 + (i * 37) % 1000);
+        else HVC_BatchGetVerifyThreshold(&batch, &threshold[i]);
+    }
+
+    ret = HVC_BatchRun(hCom, CHECK_TIMEOUT, &batch, inWindow);
+    for ( i = 0; i < nNum; i++ ) {
+        if ( pCommand[i].ret != 0 || pCommand[i].status != 0 ) break;
+        if ( i % 2 == 1 && threshold[i] != 1 + ((i - 1) * 37) % 1000 ) break;
+    }
+    /* A signal error leaves its command with a nonzero ret */
+    if ( i < nNum ) {
+        snprintf(outDetail, inDetailSize, "ret=%d, command %d: ret=%d status=0x%02X", ret, i, pCommand[i].ret,
+                 pCommand[i].status);
+        return -1;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Batch of nNum GetVerifyThreshold: the device answers inside com_send(), so */
+/* the line holds the responses to every command in flight at once. It must  */
+/* reach inWindow responses (8 bytes each) and no more, with none dropped.    */
+/*----------------------------------------------------------------------------*/
+static int CheckBatchWindow(HCOM hCom, int nNum, INT32 inWindow, HVC_BATCH_COMMAND *pCommand,
+                            char *outDetail, int inDetailSize)
+{
+    int i;
+    int ret;
+    int expect;
+    INT32 threshold[CHECK_BATCH_MAX];
+    COM_STATS stats;
+    HVC_BATCH batch;
+
+    HVC_BatchInit(&batch, pCommand, CHECK_BATCH_MAX);
+    for ( i = 0; i < nNum; i++ ) {
+        HVC_BatchGetVerifyThreshold(&batch, &threshold[i]);
+    }
+
+    com_reset_stats(hCom);
+    ret = HVC_BatchRun(hCom, CHECK_TIMEOUT, &batch, inWindow);
+    com_get_stats(hCom, &stats);
+    expect = ((inWindow <= 0 || inWindow > nNum) ? nNum : inWindow) * (6 + 2);
+    if ( ret != 0 || stats.nMaxBuffered != (unsigned int)expect || stats.nResyncs != 0 ) {
+        snprintf(outDetail, inDetailSize, "ret=%d, %u bytes in flight (expected %d), %llu resync(s)", ret,
+                 stats.nMaxBuffered, expect, stats.nResyncs);
+        return -1;
+    }
+    return 0;
+}
+
+/* Batches of every size and window in the tables above */
+static void CheckBatch(HCOM hCom, int *ioFailed)
+{
+    int n, w;
+    char title[64];
+    char detail[128];
+    HVC_BATCH_COMMAND *pCommand;
+    HVC_IMAGE *pImage;
+
+    pCommand = (HVC_BATCH_COMMAND *)malloc(sizeof(HVC_BATCH_COMMAND) * CHECK_BATCH_MAX);
+    pImage = (HVC_IMAGE *)malloc(sizeof(HVC_IMAGE));
+    if ( pCommand == NULL || pImage == NULL ) {
+        Report(ioFailed, 0, "batch", "out of memory");
+        free(pCommand);
+        free(pImage);
+        return;
+    }
+
+    for ( n = 0; n < CHECK_COUNT(m_anBatchNum); n++ ) {
+        for ( w = 0; w < CHECK_COUNT(m_anBatchWindow); w++ ) {
+            detail[0] = '\0';
+            snprintf(title, sizeof(title), "batch delete n=%d window=%d", m_anBatchNum[n], (int)m_anBatchWindow[w]);
+            Report(ioFailed, CheckBatchDelete(hCom, m_anBatchNum[n], m_anBatchWindow[w], pCommand, pImage,
+                                              detail, sizeof(detail)) == 0, title, detail);
+            detail[0] = '\0';
+            snprintf(title, sizeof(title), "batch order n=%d window=%d", m_anBatchNum[n], (int)m_anBatchWindow[w]);
+            Report(ioFailed, CheckBatchOrder(hCom, m_anBatchNum[n], m_anBatchWindow[w], pCommand,
+                                             detail, sizeof(detail)) == 0, title, detail);
+        }
+    }
+    for ( w = 0; w < CHECK_COUNT(m_anBatchWindow); w++ ) {
+        detail[0] = '\0';
+        snprintf(title, sizeof(title), "batch in flight n=100 window=%d", (int)m_anBatchWindow[w]);
+        Report(ioFailed, CheckBatchWindow(hCom, 100, m_anBatchWindow[w], pCommand, detail, sizeof(detail)) == 0,
+               title, detail);
+    }
+
+    free(pCommand);
+    free(pImage);
+}
+
+/*----------------------------------------------------------------------------*/
+/* check : pass/fail checks over loopback, where the device answers before    */
+/*         com_send() returns; prints every check and fails if one did        */
+/*----------------------------------------------------------------------------*/
+int BenchCheck(int argc, char *argv[])
+{
+    int nFailed = 0;
+    HVCSIM_CONFIG config;
+    CHECK_LINE *pLine;
+
+    (void)argc;
+    (void)argv;
+
+    pLine = (CHECK_LINE *)calloc(1, sizeof(CHECK_LINE));
+    if ( pLine == NULL ) {
+        printf("Memory allocation failed.\n");
+        return -1;
+    }
+    HVCSim_DefaultConfig(&config);
+    pLine->hCom = com_open("loopback", 0);
+    pLine->pSim = HVCSim_Create(&config, CheckOutput, pLine);
+    if ( pLine->hCom == NULL || pLine->pSim == NULL ) {
+        printf("Failed to open the simulated device.\n");
+        com_close(pLine->hCom);
+        HVCSim_Destroy(pLine->pSim);
+        free(pLine);
+        return -1;
+    }
+    com_loopback_attach(pLine->hCom, CheckDevice, pLine->pSim);
+
+    CheckFraming(pLine, &nFailed);
+    CheckBatch(pLine->hCom, &nFailed);
+    CheckAlbum(pLine, &nFailed);
+
+    com_close(pLine->hCom);
+    HVCSim_Destroy(pLine->pSim);
+    free(pLine);
+
+    printf("%d check(s) failed\n", nFailed);
+    return (nFailed == 0) ? 0 : -1;
+}
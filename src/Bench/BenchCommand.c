@@ -0,0 +1,474 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Device command benchmarks
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCDef.h"
+#include "HVCConfig.h"
+#include "HVCSim.h"
+#include "HVCBench.h"
+
+#define BENCH_COMMAND_TIMEOUT   1000
+#define BENCH_COMMAND_BAUDRATE  921600
+#define BENCH_COMMAND_LINK_US   2000    /* Round trip of a USB serial adapter */
+#define BENCH_CONFIG_ROUNDS     20
+#define BENCH_BATCH_USERS       100
+#define BENCH_BATCH_BAD_USER    0xFFFF  /* Rejected by the device */
+
+/* Response on its way through the link */
+typedef struct BENCH_LINK_PACKET_ {
+    struct BENCH_LINK_PACKET_   *pNext;
+    double                      due;        /* Reaches the host (us) */
+    INT32                       size;
+    UINT8                       data[1];
+} BENCH_LINK_PACKET;
+
+/* Simulated device behind a pty, with its command time and the wire paced. */
+/* The link (USB serial adapter, driver) adds nLinkUs to every round trip;  */
+/* the device works on while responses are on their way.                   */
+typedef struct {
+    BENCH_PTY_DEVICE    dev;
+    pthread_t           hDevice;
+    pthread_t           hLink;
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    BENCH_LINK_PACKET   *pHead;
+    BENCH_LINK_PACKET   *pTail;
+    int                 bStop;
+    int                 nLinkUs;
+    HCOM                hCom;
+} BENCH_COMMAND_DEVICE;
+
+/* Device output: leaves after the processing time, reaches the host nLinkUs later */
+static void LinkOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    BENCH_COMMAND_DEVICE *pDevice = (BENCH_COMMAND_DEVICE *)pParam;
+    BENCH_LINK_PACKET *pPacket;
+
+    (void)inCmdSize;
+    if ( inProcTime > 0 ) usleep((useconds_t)inProcTime);
+    pPacket = (BENCH_LINK_PACKET *)malloc(sizeof(BENCH_LINK_PACKET) + inSize);
+    if ( pPacket == NULL ) return;
+    pPacket->pNext = NULL;
+    pPacket->due = Bench_NowUs() + pDevice->nLinkUs;
+    pPacket->size = inSize;
+    memcpy(pPacket->data, inData, inSize);
+
+    pthread_mutex_lock(&pDevice->mutex);
+    if ( pDevice->pTail != NULL ) pDevice->pTail->pNext = pPacket;
+    else pDevice->pHead = pPacket;
+    pDevice->pTail = pPacket;
+    pthread_cond_signal(&pDevice->cond);
+    pthread_mutex_unlock(&pDevice->mutex);
+}
+
+/* Hands the responses to the pty in order, each once it is due */
+static void *LinkThread(void *pParam)
+{
+    BENCH_COMMAND_DEVICE *pDevice = (BENCH_COMMAND_DEVICE *)pParam;
+    BENCH_LINK_PACKET *pPacket;
+    double wait;
+
+    pthread_mutex_lock(&pDevice->mutex);
+    for ( ;; ) {
+        while ( pDevice->pHead == NULL && !pDevice->bStop ) {
+            pthread_cond_wait(&pDevice->cond, &pDevice->mutex);
+        }
+        pPacket = pDevice->pHead;
+        if ( pPacket == NULL ) break;
+        pDevice->pHead = pPacket->pNext;
+        if ( pDevice->pHead == NULL ) pDevice->pTail = NULL;
+        pthread_mutex_unlock(&pDevice->mutex);
+
+        wait = pPacket->due - Bench_NowUs();
+        if ( wait > 0 ) usleep((useconds_t)wait);
+        Bench_PtyOutput(&pDevice->dev, pPacket->data, pPacket->size, 0, 0);
+        free(pPacket);
+
+        pthread_mutex_lock(&pDevice->mutex);
+    }
+    pthread_mutex_unlock(&pDevice->mutex);
+    return NULL;
+}
+
+static int OpenDevice(BENCH_COMMAND_DEVICE *pDevice, const HVCSIM_CONFIG *inConfig, int inLinkUs)
+{
+    char slave[64];
+
+    pDevice->dev.fd = Bench_OpenPty(slave, sizeof(slave));
+    if ( pDevice->dev.fd < 0 ) {
+        printf("Failed to open pty.\n");
+        return -1;
+    }
+    pDevice->pHead = NULL;
+    pDevice->pTail = NULL;
+    pDevice->bStop = 0;
+    pDevice->nLinkUs = inLinkUs;
+    pthread_mutex_init(&pDevice->mutex, NULL);
+    pthread_cond_init(&pDevice->cond, NULL);
+    pDevice->dev.pSim = HVCSim_Create(inConfig, LinkOutput, pDevice);
+    pDevice->dev.bProcTime = 0;
+    pDevice->dev.nWireRate = BENCH_COMMAND_BAUDRATE / 10;
+    pDevice->hCom = com_init_device(slave, BENCH_COMMAND_BAUDRATE);
+    if ( pDevice->dev.pSim == NULL || pDevice->hCom == NULL ||
+         pthread_create(&pDevice->hLink, NULL, LinkThread, pDevice) != 0 ) {
+        com_close(pDevice->hCom);
+        HVCSim_Destroy(pDevice->dev.pSim);
+        close(pDevice->dev.fd);
+        return -1;
+    }
+    if ( pthread_create(&pDevice->hDevice, NULL, Bench_PtyDeviceThread, &pDevice->dev) != 0 ) {
+        pDevice->bStop = 1;
+        pthread_cond_signal(&pDevice->cond);
+        pthread_join(pDevice->hLink, NULL);
+        com_close(pDevice->hCom);
+        HVCSim_Destroy(pDevice->dev.pSim);
+        close(pDevice->dev.fd);
+        return -1;
+    }
+    return 0;
+}
+
+static void CloseDevice(BENCH_COMMAND_DEVICE *pDevice)
+{
+    /* Hanging up the line ends the device thread */
+    com_close(pDevice->hCom);
+    pthread_join(pDevice->hDevice, NULL);
+    /* The link delivers what is left into the closed line, then ends */
+    pthread_mutex_lock(&pDevice->mutex);
+    pDevice->bStop = 1;
+    pthread_cond_signal(&pDevice->cond);
+    pthread_mutex_unlock(&pDevice->mutex);
+    pthread_join(pDevice->hLink, NULL);
+    HVCSim_Destroy(pDevice->dev.pSim);
+    close(pDevice->dev.fd);
+    pthread_mutex_destroy(&pDevice->mutex);
+    pthread_cond_destroy(&pDevice->cond);
+}
+
+/* Sample defaults, with the thresholds moved by inStep (kept within 1-1000) */
+static void MakeConfig(HVC_CONFIG *outConfig, INT32 inStep)
+{
+    outConfig->cameraAngle = 0;
+    outConfig->threshold.bdThreshold = 500 + inStep % 400;
+    outConfig->threshold.hdThreshold = 500 + inStep % 400;
+    outConfig->threshold.dtThreshold = 500 + inStep % 400;
+    outConfig->threshold.rsThreshold = 500 + inStep % 400;
+    outConfig->sizeRange.bdMinSize = 30;
+    outConfig->sizeRange.bdMaxSize = 8192;
+    outConfig->sizeRange.hdMinSize = 40;
+    outConfig->sizeRange.hdMaxSize = 8192;
+    outConfig->sizeRange.dtMinSize = 64;
+    outConfig->sizeRange.dtMaxSize = 8192;
+    outConfig->facePose = 0;
+    outConfig->faceAngle = 0;
+    outConfig->verifyThreshold = 500;
+}
+
+/* Every field, one Set and one Get each, the way the sample used to start */
+static INT32 SetGetAll(HCOM hCom, const HVC_CONFIG *inConfig, HVC_CONFIG *outConfig)
+{
+    HVC_THRESHOLD threshold = inConfig->threshold;
+    HVC_SIZERANGE sizeRange = inConfig->sizeRange;
+    UINT8 status = 0;
+    INT32 ret;
+
+    ret = HVC_SetCameraAngle(hCom, BENCH_COMMAND_TIMEOUT, inConfig->cameraAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetCameraAngle(hCom, BENCH_COMMAND_TIMEOUT, &outConfig->cameraAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_SetThreshold(hCom, BENCH_COMMAND_TIMEOUT, &threshold, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetThreshold(hCom, BENCH_COMMAND_TIMEOUT, &outConfig->threshold, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_SetSizeRange(hCom, BENCH_COMMAND_TIMEOUT, &sizeRange, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetSizeRange(hCom, BENCH_COMMAND_TIMEOUT, &outConfig->sizeRange, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_SetFaceDetectionAngle(hCom, BENCH_COMMAND_TIMEOUT, inConfig->facePose, inConfig->faceAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetFaceDetectionAngle(hCom, BENCH_COMMAND_TIMEOUT, &outConfig->facePose, &outConfig->faceAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_SetVerifyThreshold(hCom, BENCH_COMMAND_TIMEOUT, inConfig->verifyThreshold, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetVerifyThreshold(hCom, BENCH_COMMAND_TIMEOUT, &outConfig->verifyThreshold, &status);
+    return (ret == 0 && status == 0) ? 0 : -1;
+}
+
+/* Compares what the device holds, one Get at a time, with inConfig */
+static int CheckDevice(HCOM hCom, const HVC_CONFIG *inConfig)
+{
+    HVC_CONFIG config;
+    UINT8 status = 0;
+    INT32 ret;
+
+    memset(&config, 0, sizeof(config));
+    ret = HVC_GetCameraAngle(hCom, BENCH_COMMAND_TIMEOUT, &config.cameraAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetThreshold(hCom, BENCH_COMMAND_TIMEOUT, &config.threshold, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetSizeRange(hCom, BENCH_COMMAND_TIMEOUT, &config.sizeRange, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetFaceDetectionAngle(hCom, BENCH_COMMAND_TIMEOUT, &config.facePose, &config.faceAngle, &status);
+    if ( ret == 0 && status == 0 ) ret = HVC_GetVerifyThreshold(hCom, BENCH_COMMAND_TIMEOUT, &config.verifyThreshold, &status);
+    if ( ret != 0 || status != 0 ) return -1;
+    return (memcmp(&config, inConfig, sizeof(HVC_CONFIG)) == 0) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* config : startup and reconfiguration over a pty at 921600 baud, the        */
+/*          simulator taking its command time behind a link adding link_us    */
+/*          per round trip; Set+Get of every field vs. HVC_ConfigApply and    */
+/*          HVC_ConfigRead sending only the changed fields                    */
+/*----------------------------------------------------------------------------*/
+int BenchConfig(int argc, char *argv[])
+{
+    int i;
+    int nRounds = BENCH_CONFIG_ROUNDS;
+    int nLinkUs = BENCH_COMMAND_LINK_US;
+    int nDone[3] = { 0, 0, 0 };
+    int nBad = 0;
+    int ret = 0;
+    INT32 nCommand[3] = { 0, 0, 0 };
+    UINT8 status;
+    double t0;
+    double *pSamples[3];
+    BENCH_COMMAND_DEVICE device;
+    HVC_CONFIG_CACHE cache;
+    HVC_CONFIG config, readBack;
+    HVCSIM_CONFIG simConfig;
+
+    if ( argc > 1 ) nRounds = atoi(argv[1]);
+    if ( nRounds <= 0 ) nRounds = BENCH_CONFIG_ROUNDS;
+    if ( argc > 2 ) nLinkUs = atoi(argv[2]);
+
+    HVCSim_DefaultConfig(&simConfig);
+    for ( i = 0; i < 3; i++ ) {
+        pSamples[i] = (double *)malloc(sizeof(double) * nRounds);
+    }
+    if ( pSamples[0] == NULL || pSamples[1] == NULL || pSamples[2] == NULL || OpenDevice(&device, &simConfig, nLinkUs) != 0 ) {
+        for ( i = 0; i < 3; i++ ) free(pSamples[i]);
+        return -1;
+    }
+
+    for ( i = 0; i < nRounds; i++ ) {
+        /* Set and read back every field, one round trip each */
+        MakeConfig(&config, i);
+        t0 = Bench_NowUs();
+        if ( SetGetAll(device.hCom, &config, &readBack) != 0 ) break;
+        pSamples[0][nDone[0]++] = Bench_NowUs() - t0;
+        nCommand[0] += 10;
+        if ( memcmp(&config, &readBack, sizeof(HVC_CONFIG)) != 0 ) nBad++;
+
+        /* Startup: nothing known after (re)connecting, everything is sent once */
+        memset(&cache, 0, sizeof(cache));
+        HVC_ConfigInvalidate(&cache, HVC_CONFIG_ALL);
+        MakeConfig(&config, i + 1);
+        t0 = Bench_NowUs();
+        if ( HVC_ConfigApply(device.hCom, BENCH_COMMAND_TIMEOUT, &cache, &config, HVC_CONFIG_ALL, &status) != 0 || status != 0 ||
+             HVC_ConfigRead(device.hCom, BENCH_COMMAND_TIMEOUT, &cache, HVC_CONFIG_ALL, &readBack, &status) != 0 || status != 0 ) {
+            break;
+        }
+        pSamples[1][nDone[1]++] = Bench_NowUs() - t0;
+        nCommand[1] += cache.nCommand;
+        if ( memcmp(&config, &readBack, sizeof(HVC_CONFIG)) != 0 || CheckDevice(device.hCom, &config) != 0 ) nBad++;
+
+        /* Reconfiguration: the thresholds change, the rest is already there */
+        cache.nCommand = 0;
+        MakeConfig(&config, i + 2);
+        t0 = Bench_NowUs();
+        if ( HVC_ConfigApply(device.hCom, BENCH_COMMAND_TIMEOUT, &cache, &config, HVC_CONFIG_ALL, &status) != 0 || status != 0 ||
+             HVC_ConfigRead(device.hCom, BENCH_COMMAND_TIMEOUT, &cache, HVC_CONFIG_ALL, &readBack, &status) != 0 || status != 0 ) {
+            break;
+        }
+        pSamples[2][nDone[2]++] = Bench_NowUs() - t0;
+        nCommand[2] += cache.nCommand;
+        if ( memcmp(&config, &readBack, sizeof(HVC_CONFIG)) != 0 || CheckDevice(device.hCom, &config) != 0 ) nBad++;
+    }
+    CloseDevice(&device);
+
+    Bench_PrintLatency("config set+get each field", pSamples[0], nDone[0]);
+    printf("%-28s commands/round=%.1f\n", "", (double)nCommand[0] / (nDone[0] > 0 ? nDone[0] : 1));
+    Bench_PrintLatency("config apply (startup)", pSamples[1], nDone[1]);
+    printf("%-28s commands/round=%.1f\n", "", (double)nCommand[1] / (nDone[1] > 0 ? nDone[1] : 1));
+    Bench_PrintLatency("config apply (thresholds)", pSamples[2], nDone[2]);
+    printf("%-28s commands/round=%.1f\n", "", (double)nCommand[2] / (nDone[2] > 0 ? nDone[2] : 1));
+    printf("%-28s mismatches=%d\n", "", nBad);
+
+    for ( i = 0; i < 3; i++ ) free(pSamples[i]);
+    if ( nDone[0] != nRounds || nDone[1] != nRounds || nDone[2] != nRounds || nBad != 0 ) ret = -1;
+    return ret;
+}
+
+/* Registers users 0 to nUsers-1 (data 0) */
+static int RegisterUsers(HCOM hCom, int nUsers, HVC_IMAGE *pImage)
+{
+    int i;
+    UINT8 status;
+
+    for ( i = 0; i < nUsers; i++ ) {
+        if ( HVC_Registration(hCom, BENCH_COMMAND_TIMEOUT, i, 0, pImage, &status) != 0 || status != 0 ) return -1;
+    }
+    return 0;
+}
+
+/* Users among 0 to nUsers-1 that still have data */
+static int CountUsers(HCOM hCom, int nUsers)
+{
+    int i;
+    int nLeft = 0;
+    INT32 dataNo;
+    UINT8 status;
+
+    for ( i = 0; i < nUsers; i++ ) {
+        if ( HVC_GetUserData(hCom, BENCH_COMMAND_TIMEOUT, i, &dataNo, &status) != 0 || status != 0 || dataNo != 0 ) nLeft++;
+    }
+    return nLeft;
+}
+
+/* Runs a batch and prints its time; returns the commands with a nonzero response code */
+static int RunBatch(const char *inTitle, HCOM hCom, HVC_BATCH *ioBatch, INT32 inWindow, double inBaseUs)
+{
+    int i;
+    int nRejected = 0;
+    double t0, t;
+
+    t0 = Bench_NowUs();
+    if ( HVC_BatchRun(hCom, BENCH_COMMAND_TIMEOUT, ioBatch, inWindow) != 0 ) {
+        printf("%-28s signal error\n", inTitle);
+        return -1;
+    }
+    t = Bench_NowUs() - t0;
+    for ( i = 0; i < ioBatch->commandNum; i++ ) {
+        if ( ioBatch->pCommand[i].status != 0 ) nRejected++;
+    }
+    printf("%-28s n=%-6d total=%9.1fus per command=%7.1fus", inTitle, ioBatch->commandNum, t, t / ioBatch->commandNum);
+    if ( inBaseUs > 0 ) printf(" (%.2fx)", inBaseUs / t);
+    printf("\n");
+    return nRejected;
+}
+
+/*----------------------------------------------------------------------------*/
+/* batch : bulk user deletes and a config push over the same link as config,  */
+/*         one command per round trip vs. HVC_BatchRun() sending them back    */
+/*         to back; checks what the device holds afterwards and that a        */
+/*         rejected command only fails itself                                 */
+/*----------------------------------------------------------------------------*/
+int BenchBatch(int argc, char *argv[])
+{
+    int i;
+    int nUsers = BENCH_BATCH_USERS;
+    INT32 window = 4;
+    int nLinkUs = BENCH_COMMAND_LINK_US;
+    int ret = 0;
+    int nLeft, nRejected;
+    UINT8 status;
+    double t0, tSerial;
+    BENCH_COMMAND_DEVICE device;
+    HVCSIM_CONFIG simConfig;
+    HVC_IMAGE *pImage;
+    HVC_BATCH_COMMAND *pCommand;
+    HVC_BATCH batch;
+    HVC_CONFIG config, readBack;
+    char title[64];
+
+    if ( argc > 1 ) nUsers = atoi(argv[1]);
+    if ( nUsers <= 0 || nUsers > 500 ) nUsers = BENCH_BATCH_USERS;
+    if ( argc > 2 ) window = atoi(argv[2]);
+    if ( argc > 3 ) nLinkUs = atoi(argv[3]);
+
+    /* Registration is setup here, not what is measured */
+    HVCSim_DefaultConfig(&simConfig);
+    HVCSim_SetProcTime(&simConfig, "registration", 0);
+
+    pImage = (HVC_IMAGE *)malloc(sizeof(HVC_IMAGE));
+    pCommand = (HVC_BATCH_COMMAND *)malloc(sizeof(HVC_BATCH_COMMAND) * (nUsers + 1));
+    if ( pImage == NULL || pCommand == NULL || OpenDevice(&device, &simConfig, nLinkUs) != 0 ) {
+        free(pImage);
+        free(pCommand);
+        return -1;
+    }
+
+    /* One DeleteUser per round trip */
+    if ( RegisterUsers(device.hCom, nUsers, pImage) != 0 ) ret = -1;
+    t0 = Bench_NowUs();
+    for ( i = 0; ret == 0 && i < nUsers; i++ ) {
+        if ( HVC_DeleteUser(device.hCom, BENCH_COMMAND_TIMEOUT, i, &status) != 0 || status != 0 ) ret = -1;
+    }
+    tSerial = Bench_NowUs() - t0;
+    nLeft = CountUsers(device.hCom, nUsers);
+    printf("%-28s n=%-6d total=%9.1fus per command=%7.1fus\n", "delete user (serial)", nUsers, tSerial, tSerial / nUsers);
+    printf("%-28s users left=%d\n", "", nLeft);
+    if ( nLeft != 0 ) ret = -1;
+
+    /* The same deletes batched, all at once and windowed; a bad user ID at */
+    /* the end must be the only command rejected                             */
+    for ( i = 0; ret == 0 && i < 2; i++ ) {
+        if ( RegisterUsers(device.hCom, nUsers, pImage) != 0 ) {
+            ret = -1;
+            break;
+        }
+        HVC_BatchInit(&batch, pCommand, nUsers + 1);
+        for ( nLeft = 0; nLeft < nUsers; nLeft++ ) {
+            HVC_BatchDeleteUser(&batch, nLeft);
+        }
+        HVC_BatchDeleteUser(&batch, BENCH_BATCH_BAD_USER);
+        if ( i == 0 ) snprintf(title, sizeof(title), "delete user (batch)");
+        else snprintf(title, sizeof(title), "delete user (window %d)", window);
+        nRejected = RunBatch(title, device.hCom, &batch, (i == 0) ? 0 : window, tSerial);
+        nLeft = CountUsers(device.hCom, nUsers);
+        printf("%-28s users left=%d rejected=%d (last 0x%02X)\n", "", nLeft, nRejected, pCommand[nUsers].status);
+        if ( nLeft != 0 || nRejected != 1 || pCommand[nUsers].status == 0 ) ret = -1;
+    }
+
+    /* Config push: five Set commands, then read back in one batch */
+    MakeConfig(&config, 7);
+    t0 = Bench_NowUs();
+    if ( HVC_SetCameraAngle(device.hCom, BENCH_COMMAND_TIMEOUT, config.cameraAngle, &status) != 0 ||
+         HVC_SetThreshold(device.hCom, BENCH_COMMAND_TIMEOUT, &config.threshold, &status) != 0 ||
+         HVC_SetSizeRange(device.hCom, BENCH_COMMAND_TIMEOUT, &config.sizeRange, &status) != 0 ||
+         HVC_SetFaceDetectionAngle(device.hCom, BENCH_COMMAND_TIMEOUT, config.facePose, config.faceAngle, &status) != 0 ||
+         HVC_SetVerifyThreshold(device.hCom, BENCH_COMMAND_TIMEOUT, config.verifyThreshold, &status) != 0 ) {
+        ret = -1;
+    }
+    tSerial = Bench_NowUs() - t0;
+    printf("%-28s n=%-6d total=%9.1fus per command=%7.1fus\n", "config push (serial)", 5, tSerial, tSerial / 5);
+
+    MakeConfig(&config, 8);
+    HVC_BatchInit(&batch, pCommand, nUsers + 1);
+    HVC_BatchSetCameraAngle(&batch, config.cameraAngle);
+    HVC_BatchSetThreshold(&batch, &config.threshold);
+    HVC_BatchSetSizeRange(&batch, &config.sizeRange);
+    HVC_BatchSetFaceDetectionAngle(&batch, config.facePose, config.faceAngle);
+    HVC_BatchSetVerifyThreshold(&batch, config.verifyThreshold);
+    if ( RunBatch("config push (batch)", device.hCom, &batch, 0, tSerial) != 0 ) ret = -1;
+
+    memset(&readBack, 0xFF, sizeof(readBack));
+    HVC_BatchInit(&batch, pCommand, nUsers + 1);
+    HVC_BatchGetCameraAngle(&batch, &readBack.cameraAngle);
+    HVC_BatchGetThreshold(&batch, &readBack.threshold);
+    HVC_BatchGetSizeRange(&batch, &readBack.sizeRange);
+    HVC_BatchGetFaceDetectionAngle(&batch, &readBack.facePose, &readBack.faceAngle);
+    HVC_BatchGetVerifyThreshold(&batch, &readBack.verifyThreshold);
+    if ( RunBatch("config read (batch)", device.hCom, &batch, 0, 0) != 0 ) ret = -1;
+    printf("%-28s read back %s, device %s\n", "",
+           (memcmp(&config, &readBack, sizeof(HVC_CONFIG)) == 0) ? "matches" : "DIFFERS",
+           (CheckDevice(device.hCom, &config) == 0) ? "matches" : "DIFFERS");
+    if ( memcmp(&config, &readBack, sizeof(HVC_CONFIG)) != 0 || CheckDevice(device.hCom, &config) != 0 ) ret = -1;
+
+    CloseDevice(&device);
+    free(pImage);
+    free(pCommand);
+    return ret;
+}
@@ -0,0 +1,693 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Execute response benchmark
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCDef.h"
+#include "HVCPacked.h"
+#include "HVCFramePool.h"
+#include "HVCSim.h"
+#include "HVCBench.h"
+
+#define BENCH_EXECUTE_FRAMES    2000
+#define BENCH_EXECUTE_TIMEOUT   1000
+#define BENCH_EXECUTE_BAUDRATE  921600
+#define BENCH_EXECUTE_DETECT    35      /* Most detections the device reports */
+#define BENCH_ASYNC_SENSORS     4
+#define BENCH_ASYNC_FRAMES      50
+#define BENCH_ASYNC_SENSORS_MAX 16
+#define BENCH_ASYNC_FACE_TIME   20000   /* Device processing time per frame (us) */
+#define BENCH_ASYNC_POLL_US     200     /* Event loop tick between polls */
+#define BENCH_STREAM_FRAMES     100
+#define BENCH_STREAM_HOST_US    10000   /* Host work per frame (STB, output) */
+#define BENCH_STREAM_KEEP       2       /* Frames an archive keeps from the pool */
+#define BENCH_STREAM_POOL       (BENCH_STREAM_KEEP + 2)
+#define BENCH_PROGRESS_FRAMES   3
+#define BENCH_PROGRESS_ROW_US   500     /* Host work per image row (encoding) */
+#define BENCH_PACKED_FRAMES     1000    /* Frames kept in the history */
+/* Everything except recognition, which needs an album */
+#define BENCH_EXECUTE_EXEC      (HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_HAND_DETECTION | \
+                                 HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION | \
+                                 HVC_ACTIV_AGE_ESTIMATION | HVC_ACTIV_GENDER_ESTIMATION | \
+                                 HVC_ACTIV_GAZE_ESTIMATION | HVC_ACTIV_BLINK_ESTIMATION | \
+                                 HVC_ACTIV_EXPRESSION_ESTIMATION)
+
+/* Simulated device answering on a loopback port */
+static void LoopbackOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    (void)inCmdSize;
+    (void)inProcTime;
+    com_loopback_inject((HCOM)pParam, inData, inSize);
+}
+
+static void LoopbackDevice(void *pParam, HCOM hCom, const unsigned char *buf, int len)
+{
+    (void)hCom;
+    HVCSim_Input((HVCSIM *)pParam, buf, len);
+}
+
+/* Runs nFrames HVC_ExecuteEx and prints latency and receive calls per frame */
+static int RunExecute(const char *inTitle, HCOM hCom, int nFrames, INT32 inImage, HVC_RESULT *pResult)
+{
+    int i;
+    int nDone = 0;
+    UINT8 status;
+    double t0, cpu;
+    double *pSamples;
+    unsigned long long nCalls;
+    char title[64];
+
+    pSamples = (double *)malloc(sizeof(double) * nFrames);
+    if ( pSamples == NULL ) return -1;
+
+    nCalls = Bench_RecvCalls();
+    cpu = Bench_CpuUs();
+    for ( i = 0; i < nFrames; i++ ) {
+        t0 = Bench_NowUs();
+        if ( HVC_ExecuteEx(hCom, BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC, inImage, pResult, &status) != 0 || status != 0 ) {
+            break;
+        }
+        pSamples[nDone++] = Bench_NowUs() - t0;
+    }
+    cpu = Bench_CpuUs() - cpu;
+    nCalls = Bench_RecvCalls() - nCalls;
+
+    snprintf(title, sizeof(title), "execute %s", inTitle);
+    Bench_PrintLatency(title, pSamples, nDone);
+    printf("%-28s receive calls/frame=%.1f cpu=%.1fus/frame\n", "",
+           (double)nCalls / (nDone > 0 ? nDone : 1), cpu / (nDone > 0 ? nDone : 1));
+    free(pSamples);
+    return (nDone == nFrames) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* execute : HVC_ExecuteEx frame latency against the simulator with 35        */
+/*           bodies, hands and faces and no processing time, over loopback    */
+/*           (host overhead only) and over a pty (plus the receive thread)    */
+/*           image "qvga" or "half" adds the output image                     */
+/*----------------------------------------------------------------------------*/
+int BenchExecute(int argc, char *argv[])
+{
+    int i;
+    int nFrames = BENCH_EXECUTE_FRAMES;
+    INT32 image = HVC_EXECUTE_IMAGE_NONE;
+    int ret = 0;
+    char slave[64];
+    HVCSIM_CONFIG config;
+    HVCSIM *pSim;
+    HCOM hCom;
+    HVC_RESULT *pResult;
+    BENCH_PTY_DEVICE dev;
+    pthread_t hDevice;
+
+    if ( argc > 1 ) nFrames = atoi(argv[1]);
+    if ( nFrames <= 0 ) nFrames = BENCH_EXECUTE_FRAMES;
+    if ( argc > 2 ) {
+        if ( strcmp(argv[2], "qvga") == 0 ) image = HVC_EXECUTE_IMAGE_QVGA;
+        else if ( strcmp(argv[2], "half") == 0 ) image = HVC_EXECUTE_IMAGE_QVGA_HALF;
+    }
+
+    HVCSim_DefaultConfig(&config);
+    config.maxBody = config.maxHand = config.maxFace = BENCH_EXECUTE_DETECT;
+    for ( i = 0; i < HVCSIM_TIME_NUM; i++ ) {
+        config.procTime[i] = 0;
+    }
+
+    pResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    if ( pResult == NULL ) return -1;
+
+    /* Loopback: the device answers inside com_send() */
+    hCom = com_open("loopback", 0);
+    pSim = HVCSim_Create(&config, LoopbackOutput, hCom);
+    if ( hCom == NULL || pSim == NULL ) {
+        com_close(hCom);
+        HVCSim_Destroy(pSim);
+        free(pResult);
+        return -1;
+    }
+    com_loopback_attach(hCom, LoopbackDevice, pSim);
+    if ( RunExecute("(loopback)", hCom, nFrames, image, pResult) != 0 ) ret = -1;
+    com_close(hCom);
+    HVCSim_Destroy(pSim);
+
+    /* pty: the device runs on its own thread */
+    dev.fd = Bench_OpenPty(slave, sizeof(slave));
+    if ( dev.fd < 0 ) {
+        printf("Failed to open pty.\n");
+        free(pResult);
+        return -1;
+    }
+    dev.pSim = HVCSim_Create(&config, Bench_PtyOutput, &dev);
+    dev.bProcTime = 0;
+    dev.nWireRate = 0;
+    hCom = com_init_device(slave, BENCH_EXECUTE_BAUDRATE);
+    if ( dev.pSim == NULL || hCom == NULL || pthread_create(&hDevice, NULL, Bench_PtyDeviceThread, &dev) != 0 ) {
+        com_close(hCom);
+        HVCSim_Destroy(dev.pSim);
+        close(dev.fd);
+        free(pResult);
+        return -1;
+    }
+    if ( RunExecute("(pty)", hCom, nFrames, image, pResult) != 0 ) ret = -1;
+    /* Hanging up the line ends the device thread */
+    com_close(hCom);
+    pthread_join(hDevice, NULL);
+    HVCSim_Destroy(dev.pSim);
+    close(dev.fd);
+
+    free(pResult);
+    return ret;
+}
+
+/* Sensors of the async benchmark, each a simulator thread behind a pty */
+typedef struct {
+    int                 nSensors;
+    BENCH_PTY_DEVICE    dev[BENCH_ASYNC_SENSORS_MAX];
+    pthread_t           hDevice[BENCH_ASYNC_SENSORS_MAX];
+    HCOM                hCom[BENCH_ASYNC_SENSORS_MAX];
+    HVC_RESULT          *pResult[BENCH_ASYNC_SENSORS_MAX];
+} BENCH_SENSORS;
+
+static void CloseSensors(BENCH_SENSORS *pSensors)
+{
+    int i;
+
+    for ( i = 0; i < pSensors->nSensors; i++ ) {
+        com_close(pSensors->hCom[i]);
+        pthread_join(pSensors->hDevice[i], NULL);
+        HVCSim_Destroy(pSensors->dev[i].pSim);
+        close(pSensors->dev[i].fd);
+        free(pSensors->pResult[i]);
+    }
+    pSensors->nSensors = 0;
+}
+
+static int OpenSensors(BENCH_SENSORS *pSensors, int nSensors)
+{
+    int i;
+    char slave[64];
+    HVCSIM_CONFIG config;
+    BENCH_PTY_DEVICE *pDev;
+
+    HVCSim_DefaultConfig(&config);
+    config.maxBody = config.maxHand = config.maxFace = BENCH_EXECUTE_DETECT;
+    for ( i = 0; i < HVCSIM_TIME_NUM; i++ ) {
+        config.procTime[i] = 0;
+    }
+    config.procTime[HVCSIM_TIME_FACE] = BENCH_ASYNC_FACE_TIME;
+
+    pSensors->nSensors = 0;
+    for ( i = 0; i < nSensors; i++ ) {
+        pDev = &pSensors->dev[i];
+        pDev->fd = Bench_OpenPty(slave, sizeof(slave));
+        if ( pDev->fd < 0 ) break;
+        pDev->pSim = HVCSim_Create(&config, Bench_PtyOutput, pDev);
+        pDev->bProcTime = 1;
+        pDev->nWireRate = 0;
+        pSensors->hCom[i] = com_init_device(slave, BENCH_EXECUTE_BAUDRATE);
+        pSensors->pResult[i] = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+        if ( pDev->pSim == NULL || pSensors->hCom[i] == NULL || pSensors->pResult[i] == NULL ||
+             pthread_create(&pSensors->hDevice[i], NULL, Bench_PtyDeviceThread, pDev) != 0 ) {
+            com_close(pSensors->hCom[i]);
+            HVCSim_Destroy(pDev->pSim);
+            close(pDev->fd);
+            free(pSensors->pResult[i]);
+            break;
+        }
+        pSensors->nSensors++;
+    }
+    if ( pSensors->nSensors != nSensors ) {
+        CloseSensors(pSensors);
+        return -1;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* async : frames per second from several sensors that each spend             */
+/*         BENCH_ASYNC_FACE_TIME computing every frame; HVC_ExecuteEx one     */
+/*         sensor after the other vs. HVC_ExecuteExBegin/Poll on all at once  */
+/*         from a single event loop thread                                    */
+/*----------------------------------------------------------------------------*/
+int BenchExecuteAsync(int argc, char *argv[])
+{
+    int i, f;
+    int nSensors = BENCH_ASYNC_SENSORS;
+    int nFrames = BENCH_ASYNC_FRAMES;
+    int nPending;
+    int nPolls = 0;
+    int ret = 0;
+    INT32 result;
+    UINT8 status[BENCH_ASYNC_SENSORS_MAX];
+    HVC_ASYNC async[BENCH_ASYNC_SENSORS_MAX];
+    double t0, cpu, wall;
+    BENCH_SENSORS *pSensors;
+
+    if ( argc > 1 ) nSensors = atoi(argv[1]);
+    if ( argc > 2 ) nFrames = atoi(argv[2]);
+    if ( nSensors <= 0 ) nSensors = BENCH_ASYNC_SENSORS;
+    if ( nSensors > BENCH_ASYNC_SENSORS_MAX ) nSensors = BENCH_ASYNC_SENSORS_MAX;
+    if ( nFrames <= 0 ) nFrames = BENCH_ASYNC_FRAMES;
+
+    pSensors = (BENCH_SENSORS *)malloc(sizeof(BENCH_SENSORS));
+    if ( pSensors == NULL ) return -1;
+    if ( OpenSensors(pSensors, nSensors) != 0 ) {
+        printf("Failed to open %d simulated sensors.\n", nSensors);
+        free(pSensors);
+        return -1;
+    }
+
+    /* Blocking: the thread waits out every sensor's processing in turn */
+    t0 = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        for ( i = 0; i < nSensors; i++ ) {
+            if ( HVC_ExecuteEx(pSensors->hCom[i], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC, HVC_EXECUTE_IMAGE_NONE,
+                               pSensors->pResult[i], &status[i]) != 0 || status[i] != 0 ) {
+                ret = -1;
+                break;
+            }
+        }
+    }
+    wall = Bench_NowUs() - t0;
+    cpu = Bench_CpuUs() - cpu;
+    printf("%-28s sensors=%d frames/s=%7.1f cpu=%.1fus/frame\n", "execute (blocking)", nSensors,
+           (double)nFrames * nSensors * 1e6 / wall, cpu / ((double)nFrames * nSensors));
+
+    /* Async: every sensor computes at the same time */
+    t0 = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        for ( i = 0; i < nSensors; i++ ) {
+            if ( HVC_ExecuteExBegin(&async[i], pSensors->hCom[i], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC,
+                                    HVC_EXECUTE_IMAGE_NONE, pSensors->pResult[i], &status[i]) != 0 ) {
+                ret = -1;
+            }
+        }
+        do {
+            usleep(BENCH_ASYNC_POLL_US);
+            nPending = 0;
+            for ( i = 0; i < nSensors; i++ ) {
+                result = HVC_ExecuteExPoll(&async[i]);
+                if ( result == HVC_PENDING ) nPending++;
+                else if ( result != 0 || status[i] != 0 ) ret = -1;
+            }
+            nPolls++;
+        } while ( nPending > 0 );
+    }
+    wall = Bench_NowUs() - t0;
+    cpu = Bench_CpuUs() - cpu;
+    printf("%-28s sensors=%d frames/s=%7.1f cpu=%.1fus/frame polls/frame=%.1f\n", "execute (begin/poll)", nSensors,
+           (double)nFrames * nSensors * 1e6 / wall, cpu / ((double)nFrames * nSensors), (double)nPolls / nFrames);
+
+    CloseSensors(pSensors);
+    free(pSensors);
+    return ret;
+}
+
+/* Stands in for STB_Exec() and output formatting: keeps the CPU busy */
+static void HostWork(double inUs)
+{
+    double end = Bench_NowUs() + inUs;
+    while ( Bench_NowUs() < end ) {
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* stream : frames per second of one sensor (BENCH_ASYNC_FACE_TIME per frame) */
+/*          when the host spends [host_us] on each frame; HVC_ExecuteEx in a  */
+/*          loop vs. HVC_StreamGet with 2 and 3 buffers, and with a frame     */
+/*          pool while an archive keeps the last BENCH_STREAM_KEEP frames     */
+/*----------------------------------------------------------------------------*/
+int BenchExecuteStream(int argc, char *argv[])
+{
+    int f, n;
+    int nBuffers;
+    int nFrames = BENCH_STREAM_FRAMES;
+    double hostUs = BENCH_STREAM_HOST_US;
+    int ret = 0;
+    UINT8 status;
+    double t0;
+    char title[64];
+    HVC_RESULT *pFrame;
+    HVC_RESULT *pBuffer[HVC_STREAM_BUFFER_MAX];
+    HVC_STREAM stream;
+    BENCH_SENSORS *pSensors;
+    HVC_FRAME *pPoolFrames;
+    HVC_FRAME_POOL pool;
+    HVC_RESULT *pKeep[BENCH_STREAM_KEEP];
+
+    if ( argc > 1 ) nFrames = atoi(argv[1]);
+    if ( argc > 2 ) hostUs = atof(argv[2]);
+    if ( nFrames <= 0 ) nFrames = BENCH_STREAM_FRAMES;
+    if ( hostUs < 0 ) hostUs = 0;
+
+    pSensors = (BENCH_SENSORS *)malloc(sizeof(BENCH_SENSORS));
+    if ( pSensors == NULL ) return -1;
+    if ( OpenSensors(pSensors, 1) != 0 ) {
+        printf("Failed to open the simulated sensor.\n");
+        free(pSensors);
+        return -1;
+    }
+    for ( nBuffers = 0; nBuffers < HVC_STREAM_BUFFER_MAX; nBuffers++ ) {
+        pBuffer[nBuffers] = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+        if ( pBuffer[nBuffers] == NULL ) {
+            ret = -1;
+            break;
+        }
+    }
+
+    /* Device and host take turns */
+    t0 = Bench_NowUs();
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        if ( HVC_ExecuteEx(pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC, HVC_EXECUTE_IMAGE_NONE,
+                           pSensors->pResult[0], &status) != 0 || status != 0 ) {
+            ret = -1;
+            break;
+        }
+        HostWork(hostUs);
+    }
+    printf("%-28s host=%.0fus frames/s=%7.1f\n", "execute (loop)", hostUs, (double)f * 1e6 / (Bench_NowUs() - t0));
+
+    /* The next frame is computed while the host works on this one */
+    for ( n = 2; n <= HVC_STREAM_BUFFER_MAX && ret == 0; n++ ) {
+        HVC_StreamStart(&stream, pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC, HVC_EXECUTE_IMAGE_NONE,
+                        pBuffer, n);
+        t0 = Bench_NowUs();
+        for ( f = 0; f < nFrames; f++ ) {
+            if ( HVC_StreamGet(&stream, 1, &pFrame, &status) != 0 || status != 0 ) {
+                ret = -1;
+                break;
+            }
+            HostWork(hostUs);
+        }
+        snprintf(title, sizeof(title), "execute (stream, %d buffers)", n);
+        printf("%-28s host=%.0fus frames/s=%7.1f\n", title, hostUs, (double)f * 1e6 / (Bench_NowUs() - t0));
+        HVC_StreamStop(&stream);
+    }
+
+    /* Frames kept by a consumer are taken from the pool, not copied */
+    pPoolFrames = (HVC_FRAME *)malloc(sizeof(HVC_FRAME) * BENCH_STREAM_POOL);
+    if ( pPoolFrames != NULL && ret == 0 ) {
+        HVC_FramePoolInit(&pool, pPoolFrames, BENCH_STREAM_POOL);
+        memset(pKeep, 0, sizeof(pKeep));
+        HVC_StreamStartPool(&stream, pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC,
+                            HVC_EXECUTE_IMAGE_NONE, &pool, 1);
+        t0 = Bench_NowUs();
+        for ( f = 0; f < nFrames; f++ ) {
+            if ( HVC_StreamGet(&stream, 1, &pFrame, &status) != 0 || status != 0 ) {
+                HVC_FrameRelease(pFrame);
+                ret = -1;
+                break;
+            }
+            HostWork(hostUs);
+            /* The archive takes a reference and drops its oldest frame */
+            HVC_FrameRelease(pKeep[f % BENCH_STREAM_KEEP]);
+            HVC_FrameAddRef(pFrame);
+            pKeep[f % BENCH_STREAM_KEEP] = pFrame;
+            HVC_FrameRelease(pFrame);
+        }
+        printf("%-28s host=%.0fus frames/s=%7.1f", "execute (stream, pool)", hostUs, (double)f * 1e6 / (Bench_NowUs() - t0));
+        HVC_StreamStop(&stream);
+        for ( n = 0; n < BENCH_STREAM_KEEP; n++ ) HVC_FrameRelease(pKeep[n]);
+        printf(" frames back in the pool=%d/%d\n", (int)HVC_FramePoolFree(&pool), BENCH_STREAM_POOL);
+    }
+    free(pPoolFrames);
+
+    while ( nBuffers > 0 ) free(pBuffer[--nBuffers]);
+    CloseSensors(pSensors);
+    free(pSensors);
+    return ret;
+}
+
+/* Timeline of one progressive frame, relative to the Execute call (us) */
+typedef struct {
+    double  t0;
+    double  tCount;         /* Detection counts handed over */
+    double  tResult;        /* Results handed over */
+    double  tFirstRow;      /* First chunk of rows handed over */
+    double  hostUs;         /* Host work per row */
+} BENCH_PROGRESS;
+
+static void ProgressCount(void *pParam, INT32 inBodyNum, INT32 inHandNum, INT32 inFaceNum)
+{
+    BENCH_PROGRESS *pProgress = (BENCH_PROGRESS *)pParam;
+
+    (void)inBodyNum;
+    (void)inHandNum;
+    (void)inFaceNum;
+    pProgress->tCount = Bench_NowUs() - pProgress->t0;
+}
+
+static void ProgressResult(void *pParam, const HVC_RESULT *pResult)
+{
+    BENCH_PROGRESS *pProgress = (BENCH_PROGRESS *)pParam;
+
+    (void)pResult;
+    pProgress->tResult = Bench_NowUs() - pProgress->t0;
+}
+
+static void ProgressRows(void *pParam, const HVC_RESULT *pResult, INT32 inRow, INT32 inRowNum)
+{
+    BENCH_PROGRESS *pProgress = (BENCH_PROGRESS *)pParam;
+
+    (void)pResult;
+    if ( inRow == 0 ) pProgress->tFirstRow = Bench_NowUs() - pProgress->t0;
+    HostWork(pProgress->hostUs * inRowNum);
+}
+
+/*----------------------------------------------------------------------------*/
+/* progressive : one sensor with a QVGA image on a wire paced at 921600 baud; */
+/*               time until the results, the first image rows and the image   */
+/*               processed (BENCH_PROGRESS_ROW_US per row) with HVC_ExecuteEx */
+/*               vs. HVC_ExecuteExProgressive with [rows] rows per callback;  */
+/*               then, without an image, the count hook vs. the results, of   */
+/*               HVC_ExecuteExProgressive and of HVC_ExecuteExBegin/Poll      */
+/*----------------------------------------------------------------------------*/
+int BenchExecuteProgressive(int argc, char *argv[])
+{
+    int f;
+    int nFrames = BENCH_PROGRESS_FRAMES;
+    int ret = 0;
+    UINT8 status;
+    double t1;
+    double total[2] = { 0, 0 };
+    double result[2] = { 0, 0 };
+    double firstRow = 0;
+    double count = 0;
+    HVC_PROGRESS progress;
+    HVC_ASYNC async;
+    BENCH_PROGRESS timeline;
+    BENCH_SENSORS *pSensors;
+    HVC_RESULT *pResult;
+
+    memset(&progress, 0, sizeof(progress));
+    if ( argc > 1 ) nFrames = atoi(argv[1]);
+    if ( argc > 2 ) progress.rowChunk = atoi(argv[2]);
+    if ( nFrames <= 0 ) nFrames = BENCH_PROGRESS_FRAMES;
+    if ( progress.rowChunk <= 0 ) progress.rowChunk = HVC_PROGRESS_ROW_CHUNK;
+
+    pSensors = (BENCH_SENSORS *)malloc(sizeof(BENCH_SENSORS));
+    if ( pSensors == NULL ) return -1;
+    if ( OpenSensors(pSensors, 1) != 0 ) {
+        printf("Failed to open the simulated sensor.\n");
+        free(pSensors);
+        return -1;
+    }
+    pSensors->dev[0].nWireRate = BENCH_EXECUTE_BAUDRATE / 10;     /* 8N1 */
+    pResult = pSensors->pResult[0];
+    timeline.hostUs = BENCH_PROGRESS_ROW_US;
+
+    /* Results and image come together, the image is processed afterwards */
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        timeline.t0 = Bench_NowUs();
+        if ( HVC_ExecuteEx(pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT * 2, BENCH_EXECUTE_EXEC, HVC_EXECUTE_IMAGE_QVGA,
+                           pResult, &status) != 0 || status != 0 ) {
+            ret = -1;
+            break;
+        }
+        t1 = Bench_NowUs() - timeline.t0;
+        HostWork(timeline.hostUs * pResult->image.height);
+        result[0] += t1;
+        total[0] += Bench_NowUs() - timeline.t0;
+    }
+    if ( f > 0 ) {
+        printf("%-28s results=%8.1fms image processed=%8.1fms\n", "execute (blocking)",
+               result[0] / f / 1e3, total[0] / f / 1e3);
+    }
+
+    /* Results first, then the rows are processed while the rest is on the wire */
+    progress.pCountFunc = ProgressCount;
+    progress.pResultFunc = ProgressResult;
+    progress.pRowFunc = ProgressRows;
+    progress.pParam = &timeline;
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        timeline.t0 = Bench_NowUs();
+        if ( HVC_ExecuteExProgressive(pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT * 2, BENCH_EXECUTE_EXEC,
+                                      HVC_EXECUTE_IMAGE_QVGA, &progress, pResult, &status) != 0 || status != 0 ) {
+            ret = -1;
+            break;
+        }
+        count += timeline.tCount;
+        result[1] += timeline.tResult;
+        firstRow += timeline.tFirstRow;
+        total[1] += Bench_NowUs() - timeline.t0;
+    }
+    if ( f > 0 ) {
+        printf("%-28s counts=%6.1fms results=%8.1fms image processed=%8.1fms first %d rows=%.1fms\n",
+               "execute (progressive)", count / f / 1e3, result[1] / f / 1e3, total[1] / f / 1e3,
+               (int)progress.rowChunk, firstRow / f / 1e3);
+    }
+
+    /* No image: the counts still come ahead of every record */
+    count = result[1] = 0;
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        timeline.t0 = Bench_NowUs();
+        if ( HVC_ExecuteExProgressive(pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC,
+                                      HVC_EXECUTE_IMAGE_NONE, &progress, pResult, &status) != 0 || status != 0 ) {
+            ret = -1;
+            break;
+        }
+        count += timeline.tCount;
+        result[1] += timeline.tResult;
+    }
+    if ( f > 0 ) {
+        printf("%-28s counts=%6.1fms results=%8.1fms\n", "execute (no image)", count / f / 1e3, result[1] / f / 1e3);
+    }
+
+    /* The same hook on a polled command */
+    count = result[1] = 0;
+    for ( f = 0; f < nFrames && ret == 0; f++ ) {
+        timeline.t0 = Bench_NowUs();
+        timeline.tCount = -1;
+        if ( HVC_ExecuteExBegin(&async, pSensors->hCom[0], BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC,
+                                HVC_EXECUTE_IMAGE_NONE, pResult, &status) != 0 ||
+             HVC_ExecuteExSetCountHook(&async, ProgressCount, &timeline) != 0 ) {
+            ret = -1;
+            break;
+        }
+        while ( (ret = HVC_ExecuteExPoll(&async)) == HVC_PENDING ) {
+        }
+        if ( ret != 0 || status != 0 || timeline.tCount < 0 ) {
+            ret = -1;
+            break;
+        }
+        count += timeline.tCount;
+        result[1] += Bench_NowUs() - timeline.t0;
+    }
+    if ( f > 0 ) {
+        printf("%-28s counts=%6.1fms results=%8.1fms\n", "execute (polled, no image)", count / f / 1e3,
+               result[1] / f / 1e3);
+    }
+
+    CloseSensors(pSensors);
+    free(pSensors);
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* packed : a history of [frames] HVC_ExecuteEx results (35 bodies, hands     */
+/*          and faces at most, no image) kept as packed frames; memory, and   */
+/*          time to pack and to unpack one frame                              */
+/*----------------------------------------------------------------------------*/
+int BenchExecutePacked(int argc, char *argv[])
+{
+    int i, f;
+    int nFrames = BENCH_PACKED_FRAMES;
+    int ret = 0;
+    long long historySize = 0;
+    UINT8 status;
+    UINT8 *pHistory;
+    INT32 offset = 0;
+    INT32 size;
+    double packUs = 0;
+    double unpackUs = 0;
+    double t0;
+    HVCSIM_CONFIG config;
+    HVCSIM *pSim;
+    HCOM hCom;
+    HVC_RESULT *pResult;
+
+    if ( argc > 1 ) nFrames = atoi(argv[1]);
+    if ( nFrames <= 0 ) nFrames = BENCH_PACKED_FRAMES;
+
+    HVCSim_DefaultConfig(&config);
+    config.maxBody = config.maxHand = config.maxFace = BENCH_EXECUTE_DETECT;
+    for ( i = 0; i < HVCSIM_TIME_NUM; i++ ) {
+        config.procTime[i] = 0;
+    }
+
+    pResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    pHistory = (UINT8 *)malloc((size_t)nFrames * HVC_PACKED_SIZE_MAX);
+    hCom = com_open("loopback", 0);
+    pSim = HVCSim_Create(&config, LoopbackOutput, hCom);
+    if ( pResult == NULL || pHistory == NULL || hCom == NULL || pSim == NULL ) {
+        ret = -1;
+        nFrames = 0;
+    }
+    else {
+        com_loopback_attach(hCom, LoopbackDevice, pSim);
+    }
+
+    for ( f = 0; f < nFrames; f++ ) {
+        if ( HVC_ExecuteEx(hCom, BENCH_EXECUTE_TIMEOUT, BENCH_EXECUTE_EXEC, HVC_EXECUTE_IMAGE_NONE, pResult,
+                           &status) != 0 || status != 0 ) {
+            ret = -1;
+            break;
+        }
+        t0 = Bench_NowUs();
+        size = HVC_PackResult(pResult, (HVC_PACKED *)&pHistory[offset], HVC_PACKED_SIZE_MAX);
+        packUs += Bench_NowUs() - t0;
+        if ( size < 0 ) {
+            ret = -1;
+            break;
+        }
+        /* Keep the next frame 2-byte aligned */
+        offset += (size + 1) & ~1;
+    }
+    historySize = offset;
+
+    /* Walk the history back into HVC_RESULT */
+    for ( i = 0, offset = 0; i < f && ret == 0; i++ ) {
+        t0 = Bench_NowUs();
+        if ( HVC_UnpackResult((const HVC_PACKED *)&pHistory[offset], NULL, pResult) != 0 ) ret = -1;
+        unpackUs += Bench_NowUs() - t0;
+        offset += (((const HVC_PACKED *)&pHistory[offset])->size + 1) & ~1;
+    }
+
+    if ( f > 0 ) {
+        printf("%-28s frames=%d bytes/frame=%.0f (HVC_RESULT %d) history=%.1fKB (HVC_RESULT %.1fKB)\n", "packed",
+               f, (double)historySize / f, (int)sizeof(HVC_RESULT), historySize / 1024.0,
+               (double)f * sizeof(HVC_RESULT) / 1024.0);
+        printf("%-28s pack=%.2fus/frame unpack=%.2fus/frame\n", "", packUs / f, unpackUs / f);
+    }
+
+    com_close(hCom);
+    HVCSim_Destroy(pSim);
+    free(pHistory);
+    free(pResult);
+    return ret;
+}
@@ -0,0 +1,205 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Capture replay benchmark
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCDef.h"
+#include "HVCSim.h"
+#include "STBWrap.h"
+#include "HVCBench.h"
+
+#define BENCH_REPLAY_FRAMES     5000
+#define BENCH_CAPTURE_FILE      "/tmp/HVCBench_capture.cap"
+#define BENCH_EXECUTE_TIMEOUT   1000
+#define BENCH_COM_EXECUTEEX     0x04
+/* Everything except recognition, which needs an album */
+#define BENCH_REPLAY_EXEC       (HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_HAND_DETECTION | \
+                                 HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION | \
+                                 HVC_ACTIV_AGE_ESTIMATION | HVC_ACTIV_GENDER_ESTIMATION | \
+                                 HVC_ACTIV_GAZE_ESTIMATION | HVC_ACTIV_BLINK_ESTIMATION | \
+                                 HVC_ACTIV_EXPRESSION_ESTIMATION)
+
+/* Simulated device on a loopback port */
+static void SimOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    (void)inCmdSize;
+    (void)inProcTime;
+    com_loopback_inject((HCOM)pParam, inData, inSize);
+}
+
+static void SimDevice(void *pParam, HCOM hCom, const unsigned char *buf, int len)
+{
+    (void)hCom;
+    HVCSim_Input((HVCSIM *)pParam, buf, len);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Record a capture of nFrames HVC_ExecuteEx against the simulator            */
+/*----------------------------------------------------------------------------*/
+static int RecordCapture(const char *inPath, int nFrames, HVC_RESULT *pResult)
+{
+    HCOM hCom;
+    HVCSIM *pSim;
+    UINT8 status;
+    int i, ret = 0;
+
+    hCom = com_open("loopback", 0);
+    pSim = HVCSim_Create(NULL, SimOutput, hCom);
+    if ( hCom == NULL || pSim == NULL ) {
+        com_close(hCom);
+        HVCSim_Destroy(pSim);
+        return -1;
+    }
+    com_loopback_attach(hCom, SimDevice, pSim);
+    if ( com_capture_start(hCom, inPath, 0) != 0 ) {
+        printf("Failed to create %s.\n", inPath);
+        ret = -1;
+    }
+    for ( i = 0; i < nFrames && ret == 0; i++ ) {
+        ret = HVC_ExecuteEx(hCom, BENCH_EXECUTE_TIMEOUT, BENCH_REPLAY_EXEC, HVC_EXECUTE_IMAGE_NONE, pResult, &status);
+    }
+    com_close(hCom);
+    HVCSim_Destroy(pSim);
+    return ret;
+}
+
+/* Execution flags and image of the first ExecuteEx in a capture, -1 if none */
+static int FindExecute(const char *inPath, INT32 *outExec, INT32 *outImage)
+{
+    FILE *fp;
+    long nSize;
+    unsigned char *pData;
+    unsigned char *p;
+    unsigned long long delta;
+    int nLeft, nHead, type, len;
+    int ret = -1;
+
+    fp = fopen(inPath, "rb");
+    if ( fp == NULL ) return -1;
+    fseek(fp, 0, SEEK_END);
+    nSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    pData = (unsigned char *)malloc(nSize > 0 ? nSize : 1);
+    if ( pData == NULL || (long)fread(pData, 1, nSize, fp) != nSize ||
+         nSize < COM_CAPTURE_MAGIC_SIZE || memcmp(pData, COM_CAPTURE_MAGIC, COM_CAPTURE_MAGIC_SIZE) != 0 ) {
+        fclose(fp);
+        free(pData);
+        return -1;
+    }
+    fclose(fp);
+
+    p = &pData[COM_CAPTURE_MAGIC_SIZE];
+    nLeft = (int)nSize - COM_CAPTURE_MAGIC_SIZE;
+    while ( (nHead = com_capture_parse(p, nLeft, &type, &delta, &len)) > 0 ) {
+        if ( type == COM_CAPTURE_TX && len >= 7 && p[nHead] == 0xFE && p[nHead+1] == BENCH_COM_EXECUTEEX ) {
+            *outExec = p[nHead+4] + (p[nHead+5] << 8);
+            *outImage = p[nHead+6];
+            ret = 0;
+            break;
+        }
+        p += nHead + len;
+        nLeft -= nHead + len;
+    }
+    free(pData);
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* replay : HVC_ExecuteEx decoding, and decoding plus STB, fed from a capture */
+/*          as fast as possible. Without a capture file one is recorded from  */
+/*          the simulator first.                                              */
+/*----------------------------------------------------------------------------*/
+int BenchReplay(int argc, char *argv[])
+{
+    int i, pass;
+    int nFrames = BENCH_REPLAY_FRAMES;
+    int nDone;
+    const char *pPath = BENCH_CAPTURE_FILE;
+    char spec[1100];
+    INT32 exec, image;
+    UINT8 status;
+    HCOM hCom;
+    HVC_RESULT *pResult;
+    int nFace, nBody;
+    STB_FACE *pFace;
+    STB_BODY *pBody;
+    double wall, cpu;
+
+    if ( argc > 1 ) nFrames = atoi(argv[1]);
+    if ( nFrames <= 0 ) nFrames = BENCH_REPLAY_FRAMES;
+
+    pResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    if ( pResult == NULL ) return -1;
+
+    if ( argc > 2 ) {
+        pPath = argv[2];
+    }
+    else if ( RecordCapture(pPath, nFrames, pResult) != 0 ) {
+        printf("Failed to record the capture.\n");
+        free(pResult);
+        return -1;
+    }
+    if ( FindExecute(pPath, &exec, &image) != 0 ) {
+        printf("No HVC_ExecuteEx in %s.\n", pPath);
+        free(pResult);
+        return -1;
+    }
+
+    snprintf(spec, sizeof(spec), "replay:%s,loop", pPath);
+    for ( pass = 0; pass < 2; pass++ ) {
+        hCom = com_open(spec, 0);
+        if ( hCom == NULL ) {
+            free(pResult);
+            return -1;
+        }
+        if ( pass == 1 && STB_Init(STB_FUNC_BD | STB_FUNC_DT | STB_FUNC_PT | STB_FUNC_AG | STB_FUNC_GN) != 0 ) {
+            printf("STB_Init failed.\n");
+            com_close(hCom);
+            break;
+        }
+
+        nDone = 0;
+        wall = Bench_NowUs();
+        cpu = Bench_CpuUs();
+        for ( i = 0; i < nFrames; i++ ) {
+            if ( HVC_ExecuteEx(hCom, BENCH_EXECUTE_TIMEOUT, exec, image, pResult, &status) != 0 || status != 0 ) break;
+            if ( pass == 1 ) {
+                STB_Exec(pResult->executedFunc, pResult, &nFace, &pFace, &nBody, &pBody);
+            }
+            nDone++;
+        }
+        cpu = Bench_CpuUs() - cpu;
+        wall = Bench_NowUs() - wall;
+
+        printf("replay %-14s %6d frames : %9.0f frames/s, cpu=%.2fus/frame\n",
+               (pass == 0) ? "decode" : "decode+STB", nDone, nDone * 1e6 / wall, cpu / (nDone > 0 ? nDone : 1));
+        if ( pass == 1 ) STB_Final();
+        com_close(hCom);
+        if ( nDone != nFrames ) {
+            free(pResult);
+            return -1;
+        }
+    }
+    free(pResult);
+    return 0;
+}
@@ -0,0 +1,353 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Transport backend benchmarks
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCDef.h"
+#include "HVCSim.h"
+#include "HVCBench.h"
+
+#define BENCH_TRANSPORT_COUNT   10000
+#define BENCH_REPLAY_FILE       "/tmp/HVCBench_replay.bin"
+#define BENCH_GENERAL_TIMEOUT   1000
+#define BENCH_RESYNC_COUNT      1000
+#define BENCH_RESYNC_NOISE      8       /* Most stray bytes ahead of a response */
+#define BENCH_RESYNC_SEED       12345
+#define BENCH_RESYNC_EXECUTE    10      /* GetVersion commands per ExecuteEx frame */
+#define BENCH_RESYNC_BATCH      8       /* Commands per batch */
+
+/* GetVersion response: header (sync, status, 4-byte length) + HVC_VERSION */
+static const unsigned char m_acVersionResponse[6 + 19] = {
+    0xFE, 0x00, 19, 0, 0, 0,
+    'B', '5', 'T', '-', '0', '0', '7', '0', '0', '1', ' ', ' ',
+    2, 0, 0, 0x01, 0x02, 0x03, 0x04
+};
+
+/* Loopback device side: answer every command with the version response */
+static void LoopbackVersion(void *pParam, HCOM hCom, const unsigned char *buf, int len)
+{
+    (void)pParam;
+    (void)buf;
+    (void)len;
+    com_loopback_inject(hCom, m_acVersionResponse, sizeof(m_acVersionResponse));
+}
+
+/* pty device side: read each 4-byte command and answer it */
+static void *PtyVersionThread(void *pParam)
+{
+    FILE *fp = (FILE *)pParam;
+    unsigned char cmd[4];
+    int fd = fileno(fp);
+    int n, rlen;
+
+    for ( ;; ) {
+        for ( n = 0; n < 4; n += rlen ) {
+            rlen = read(fd, &cmd[n], 4 - n);
+            if ( rlen <= 0 ) return NULL;
+        }
+        if ( write(fd, m_acVersionResponse, sizeof(m_acVersionResponse)) != (int)sizeof(m_acVersionResponse) ) {
+            return NULL;
+        }
+    }
+}
+
+/* Runs nCount GetVersion commands and prints the per-call latency */
+static int RunGetVersion(const char *inTitle, HCOM hCom, int nCount)
+{
+    int i;
+    int nDone = 0;
+    UINT8 status;
+    HVC_VERSION version;
+    double t0, t1, cpu;
+    double *pSamples;
+
+    pSamples = (double *)malloc(sizeof(double) * nCount);
+    if ( pSamples == NULL ) return -1;
+
+    t0 = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    for ( i = 0; i < nCount; i++ ) {
+        t1 = Bench_NowUs();
+        if ( HVC_GetVersion(hCom, BENCH_GENERAL_TIMEOUT, &version, &status) != 0 || status != 0 ) break;
+        pSamples[nDone++] = Bench_NowUs() - t1;
+    }
+    cpu = Bench_CpuUs() - cpu;
+    t0 = Bench_NowUs() - t0;
+
+    Bench_PrintLatency(inTitle, pSamples, nDone);
+    printf("%-28s %.0f calls/s, cpu %.2fus/call\n", "", nDone * 1e6 / t0, cpu / (nDone > 0 ? nDone : 1));
+    free(pSamples);
+    return (nDone == nCount) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* transport : HVC_GetVersion round trips over the loopback, replay and pty   */
+/*             backends (no HVC-P2 required)                                  */
+/*----------------------------------------------------------------------------*/
+int BenchTransport(int argc, char *argv[])
+{
+    int i;
+    int ret = 0;
+    int nCount = BENCH_TRANSPORT_COUNT;
+    char spec[64];
+    FILE *fp;
+    HCOM hCom;
+    pthread_t hThread;
+
+    if ( argc > 1 ) nCount = atoi(argv[1]);
+    if ( nCount <= 0 ) nCount = BENCH_TRANSPORT_COUNT;
+
+    /* loopback */
+    hCom = com_open("loopback", 0);
+    if ( hCom == NULL ) return -1;
+    com_loopback_attach(hCom, LoopbackVersion, NULL);
+    ret |= RunGetVersion("GetVersion (loopback)", hCom, nCount);
+    com_close(hCom);
+
+    /* replay: a file holding nCount responses */
+    fp = fopen(BENCH_REPLAY_FILE, "wb");
+    if ( fp == NULL ) return -1;
+    for ( i = 0; i < nCount; i++ ) {
+        fwrite(m_acVersionResponse, 1, sizeof(m_acVersionResponse), fp);
+    }
+    fclose(fp);
+    sprintf(spec, "replay:%s", BENCH_REPLAY_FILE);
+    hCom = com_open(spec, 0);
+    if ( hCom == NULL ) return -1;
+    ret |= RunGetVersion("GetVersion (replay)", hCom, nCount);
+    com_close(hCom);
+    remove(BENCH_REPLAY_FILE);
+
+    /* pty: the device side answers from a thread */
+    hCom = com_open("pty", 0);
+    if ( hCom == NULL ) return -1;
+    fp = fopen(com_pty_name(hCom), "r+b");
+    if ( fp == NULL || pthread_create(&hThread, NULL, PtyVersionThread, fp) != 0 ) {
+        if ( fp != NULL ) fclose(fp);
+        com_close(hCom);
+        return -1;
+    }
+    ret |= RunGetVersion("GetVersion (pty)", hCom, nCount);
+    com_close(hCom);
+    pthread_join(hThread, NULL);
+    fclose(fp);
+
+    return ret;
+}
+
+/* Simulator on a loopback port, stray bytes put ahead of its responses */
+typedef struct {
+    HVCSIM              *pSim;
+    HCOM                hCom;
+    int                 nNoise;     /* Most stray bytes per response, 0...clean line */
+    unsigned int        seed;
+    unsigned long long  nInjected;  /* Stray bytes put on the line so far */
+} BENCH_NOISY_DEVICE;
+
+/* Stray bytes: random, half the bursts opening with a sync byte and a length */
+/* no command answers. The last byte is never a sync byte: right before a     */
+/* header it would read as the status of a response with no data.             */
+static int MakeNoise(BENCH_NOISY_DEVICE *pDev, unsigned char *outNoise)
+{
+    static const unsigned char acFalseHeader[6] = { 0xFE, 0x00, 0xFF, 0xFF, 0xFF, 0x7F };
+    int i = 0;
+    int n;
+
+    n = 1 + rand_r(&pDev->seed) % pDev->nNoise;
+    if ( n > (int)sizeof(acFalseHeader) && (rand_r(&pDev->seed) & 1) ) {
+        memcpy(outNoise, acFalseHeader, sizeof(acFalseHeader));
+        i = sizeof(acFalseHeader);
+    }
+    for ( ; i < n; i++ ) {
+        outNoise[i] = (unsigned char)rand_r(&pDev->seed);
+        if ( i == n - 1 && outNoise[i] == 0xFE ) outNoise[i] = 0x00;
+    }
+    pDev->nInjected += n;
+    return n;
+}
+
+static void NoisyOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    BENCH_NOISY_DEVICE *pDev = (BENCH_NOISY_DEVICE *)pParam;
+    unsigned char noise[256];
+
+    (void)inCmdSize;
+    (void)inProcTime;
+    if ( pDev->nNoise > 0 ) {
+        com_loopback_inject(pDev->hCom, noise, MakeNoise(pDev, noise));
+    }
+    com_loopback_inject(pDev->hCom, inData, inSize);
+}
+
+static void NoisyDevice(void *pParam, HCOM hCom, const unsigned char *buf, int len)
+{
+    (void)hCom;
+    HVCSim_Input((HVCSIM *)pParam, buf, len);
+}
+
+/* One round of each command kind; the batch sets values and reads them back */
+static int RunResyncRound(HCOM hCom, int nRound, HVC_RESULT *pResult)
+{
+    UINT8 status;
+    HVC_VERSION version;
+    HVC_BATCH_COMMAND command[BENCH_RESYNC_BATCH];
+    HVC_BATCH batch;
+    HVC_THRESHOLD threshold, thresholdBack;
+    HVC_SIZERANGE sizeRange, sizeRangeBack;
+    INT32 angle, angleBack, verify, verifyBack;
+    int i;
+
+    if ( nRound % BENCH_RESYNC_EXECUTE == 0 ) {
+        if ( HVC_ExecuteEx(hCom, BENCH_GENERAL_TIMEOUT, HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_FACE_DETECTION,
+                           HVC_EXECUTE_IMAGE_QVGA_HALF, pResult, &status) != 0 || status != 0 ) return -1;
+    }
+    if ( HVC_GetVersion(hCom, BENCH_GENERAL_TIMEOUT, &version, &status) != 0 || status != 0 ||
+         memcmp(version.string, "B5T-007001", 10) != 0 ) return -1;
+
+    threshold.bdThreshold = threshold.hdThreshold = threshold.dtThreshold = threshold.rsThreshold = 1 + nRound % 1000;
+    sizeRange.bdMinSize = sizeRange.hdMinSize = sizeRange.dtMinSize = 20 + nRound % 100;
+    sizeRange.bdMaxSize = sizeRange.hdMaxSize = sizeRange.dtMaxSize = 1000 + nRound % 100;
+    angle = nRound % 4;
+    verify = 1 + nRound % 1000;
+    HVC_BatchInit(&batch, command, BENCH_RESYNC_BATCH);
+    HVC_BatchSetThreshold(&batch, &threshold);
+    HVC_BatchGetThreshold(&batch, &thresholdBack);
+    HVC_BatchSetSizeRange(&batch, &sizeRange);
+    HVC_BatchGetSizeRange(&batch, &sizeRangeBack);
+    HVC_BatchSetCameraAngle(&batch, angle);
+    HVC_BatchGetCameraAngle(&batch, &angleBack);
+    HVC_BatchSetVerifyThreshold(&batch, verify);
+    HVC_BatchGetVerifyThreshold(&batch, &verifyBack);
+    if ( HVC_BatchRun(hCom, BENCH_GENERAL_TIMEOUT, &batch, 0) != 0 ) return -1;
+    for ( i = 0; i < batch.commandNum; i++ ) {
+        if ( command[i].ret != 0 || command[i].status != 0 ) return -1;
+    }
+    if ( memcmp(&threshold, &thresholdBack, sizeof(threshold)) != 0 ||
+         memcmp(&sizeRange, &sizeRangeBack, sizeof(sizeRange)) != 0 ||
+         angle != angleBack || verify != verifyBack ) return -1;
+    return 0;
+}
+
+/* Runs nCount rounds over the noisy device and prints the resync counters */
+static int RunResync(const char *inTitle, BENCH_NOISY_DEVICE *pDev, int nCount, HVC_RESULT *pResult)
+{
+    int i;
+    int nFailed = 0;
+    double t0;
+    COM_STATS stats;
+
+    com_reset_stats(pDev->hCom);
+    pDev->nInjected = 0;
+    t0 = Bench_NowUs();
+    for ( i = 0; i < nCount; i++ ) {
+        if ( RunResyncRound(pDev->hCom, i, pResult) != 0 ) nFailed++;
+    }
+    t0 = Bench_NowUs() - t0;
+    com_get_stats(pDev->hCom, &stats);
+
+    printf("%-28s rounds=%-6d failed=%d %.1fus/round, timeouts=%llu\n", inTitle, nCount, nFailed,
+           t0 / nCount, stats.nTimeouts);
+    printf("%-28s header resyncs=%llu skipped=%llu of %llu stray bytes\n", "",
+           stats.nHeaderResyncs, stats.nHeaderSkips, pDev->nInjected);
+    return (nFailed == 0 && stats.nHeaderSkips == pDev->nInjected) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* resync : fault injection. Stray bytes go ahead of every response from the  */
+/*          simulator over loopback (Execute with image, GetVersion, a batch  */
+/*          of Set/Get read back), and between the responses of a replay      */
+/*          file; every command must succeed and every stray byte be skipped  */
+/*----------------------------------------------------------------------------*/
+int BenchResync(int argc, char *argv[])
+{
+    int i, n;
+    int ret = 0;
+    int nCount = BENCH_RESYNC_COUNT;
+    int nNoise = BENCH_RESYNC_NOISE;
+    char spec[64];
+    unsigned char noise[256];
+    FILE *fp;
+    HVCSIM_CONFIG config;
+    BENCH_NOISY_DEVICE dev;
+    HVC_RESULT *pResult;
+    COM_STATS stats;
+    char title[64];
+
+    if ( argc > 1 ) nCount = atoi(argv[1]);
+    if ( nCount <= 0 ) nCount = BENCH_RESYNC_COUNT;
+    if ( argc > 2 ) nNoise = atoi(argv[2]);
+    if ( nNoise <= 0 || nNoise > (int)sizeof(noise) ) nNoise = BENCH_RESYNC_NOISE;
+
+    pResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    if ( pResult == NULL ) return -1;
+
+    /* loopback: the simulator, clean and then noisy */
+    HVCSim_DefaultConfig(&config);
+    for ( i = 0; i < HVCSIM_TIME_NUM; i++ ) {
+        config.procTime[i] = 0;
+    }
+    memset(&dev, 0, sizeof(dev));
+    dev.seed = BENCH_RESYNC_SEED;
+    dev.hCom = com_open("loopback", 0);
+    dev.pSim = HVCSim_Create(&config, NoisyOutput, &dev);
+    if ( dev.hCom == NULL || dev.pSim == NULL ) {
+        com_close(dev.hCom);
+        HVCSim_Destroy(dev.pSim);
+        free(pResult);
+        return -1;
+    }
+    com_loopback_attach(dev.hCom, NoisyDevice, dev.pSim);
+    ret |= RunResync("clean line (loopback)", &dev, nCount, pResult);
+    dev.nNoise = nNoise;
+    snprintf(title, sizeof(title), "1-%d stray bytes (loopback)", nNoise);
+    ret |= RunResync(title, &dev, nCount, pResult);
+    com_close(dev.hCom);
+    HVCSim_Destroy(dev.pSim);
+    free(pResult);
+
+    /* replay: stray bytes between the responses, read back to back */
+    fp = fopen(BENCH_REPLAY_FILE, "wb");
+    if ( fp == NULL ) return -1;
+    dev.nInjected = 0;
+    for ( i = 0; i < nCount; i++ ) {
+        n = MakeNoise(&dev, noise);
+        fwrite(noise, 1, n, fp);
+        fwrite(m_acVersionResponse, 1, sizeof(m_acVersionResponse), fp);
+    }
+    fclose(fp);
+    sprintf(spec, "replay:%s", BENCH_REPLAY_FILE);
+    dev.hCom = com_open(spec, 0);
+    if ( dev.hCom == NULL ) return -1;
+    snprintf(title, sizeof(title), "1-%d stray bytes (replay)", nNoise);
+    ret |= RunGetVersion(title, dev.hCom, nCount);
+    com_get_stats(dev.hCom, &stats);
+    printf("%-28s header resyncs=%llu skipped=%llu of %llu stray bytes\n", "",
+           stats.nHeaderResyncs, stats.nHeaderSkips, dev.nInjected);
+    if ( stats.nHeaderSkips != dev.nInjected ) ret = -1;
+    com_close(dev.hCom);
+    remove(BENCH_REPLAY_FILE);
+
+    return ret;
+}
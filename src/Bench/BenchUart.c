@@ -0,0 +1,462 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    UART receive path benchmarks
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "uart.h"
+#include "HVCBench.h"
+
+#define BENCH_BAUDRATE          921600
+#define BENCH_IDLE_SECONDS      3
+#define BENCH_ARRIVAL_COUNT     200
+#define BENCH_WAKEUP_COUNT      1000
+#define BENCH_WAKEUP_BYTES      6       /* Size of an HVC response header */
+#define BENCH_RT_PRIORITY       50
+#define BENCH_LOAD_MAX          64      /* Busy threads of the "load" mode */
+#define BENCH_THROUGHPUT_KB     (16*1024)
+#define BENCH_THROUGHPUT_CHUNK  4096
+#define BENCH_SCALING_PORTS     64
+#define BENCH_SCALING_SECONDS   2
+#define BENCH_SCALING_HZ        30      /* Frames per second from each sensor */
+#define BENCH_SCALING_FRAME     300     /* Bytes per frame (a few detections) */
+
+/*----------------------------------------------------------------------------*/
+/* idle : CPU used by the receive thread while nothing is on the line         */
+/*----------------------------------------------------------------------------*/
+int BenchUartIdle(int argc, char *argv[])
+{
+    int fdMaster;
+    int nSeconds = BENCH_IDLE_SECONDS;
+    char slave[64];
+    HCOM hCom;
+    double wall, cpu;
+
+    if ( argc > 1 ) nSeconds = atoi(argv[1]);
+    if ( nSeconds <= 0 ) nSeconds = BENCH_IDLE_SECONDS;
+
+    fdMaster = Bench_OpenPty(slave, sizeof(slave));
+    if ( fdMaster < 0 ) {
+        printf("Failed to open pty.\n");
+        return -1;
+    }
+    hCom = com_init_device(slave, BENCH_BAUDRATE);
+    if ( hCom == NULL ) {
+        close(fdMaster);
+        return -1;
+    }
+
+    wall = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    sleep(nSeconds);
+    cpu = Bench_CpuUs() - cpu;
+    wall = Bench_NowUs() - wall;
+
+    printf("idle %ds on %s : cpu=%.1fms (%.3f%% of one core)\n",
+           nSeconds, slave, cpu / 1e3, cpu * 100.0 / wall);
+
+    com_close(hCom);
+    close(fdMaster);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* arrival : time from write() on the device side until the byte is visible   */
+/*           in the host receive buffer                                       */
+/*----------------------------------------------------------------------------*/
+int BenchUartArrival(int argc, char *argv[])
+{
+    int i;
+    int fdMaster;
+    int nCount = BENCH_ARRIVAL_COUNT;
+    int nDone = 0;
+    char slave[64];
+    HCOM hCom;
+    unsigned char ch = 0x5A;
+    double t0, t1;
+    double *pSamples;
+
+    if ( argc > 1 ) nCount = atoi(argv[1]);
+    if ( nCount <= 0 ) nCount = BENCH_ARRIVAL_COUNT;
+
+    pSamples = (double *)malloc(sizeof(double) * nCount);
+    if ( pSamples == NULL ) return -1;
+
+    fdMaster = Bench_OpenPty(slave, sizeof(slave));
+    if ( fdMaster < 0 ) {
+        printf("Failed to open pty.\n");
+        free(pSamples);
+        return -1;
+    }
+    hCom = com_init_device(slave, BENCH_BAUDRATE);
+    if ( hCom == NULL ) {
+        close(fdMaster);
+        free(pSamples);
+        return -1;
+    }
+
+    for ( i = 0; i < nCount; i++ ) {
+        t0 = Bench_NowUs();
+        if ( write(fdMaster, &ch, 1) != 1 ) break;
+        do {
+            t1 = Bench_NowUs();
+        } while ( com_length(hCom) < 1 && t1 - t0 < 1e6 );
+        if ( com_length(hCom) < 1 ) break;
+        pSamples[nDone++] = t1 - t0;
+
+        /* Drain the byte before the next round */
+        com_recv(hCom, 1000, &ch, 1);
+        usleep(1000);
+    }
+
+    Bench_PrintLatency("arrival (pty -> buffer)", pSamples, nDone);
+
+    com_close(hCom);
+    close(fdMaster);
+    free(pSamples);
+    return (nDone == nCount) ? 0 : -1;
+}
+
+/* Busy loop standing in for analytics on the same box */
+static volatile int m_bLoad;
+
+static void *LoadThread(void *pParam)
+{
+    volatile unsigned int n = 0;
+
+    (void)pParam;
+    while ( m_bLoad ) n++;
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/* wakeup : time from write() on the device side until a reader blocked in    */
+/*          com_recv() for that many bytes returns with them                  */
+/*          mode "rt"   : receive thread SCHED_FIFO + locked ring             */
+/*               "load" : one busy thread per CPU (combine as "rt+load")      */
+/*----------------------------------------------------------------------------*/
+int BenchUartWakeup(int argc, char *argv[])
+{
+    int i;
+    int fdMaster;
+    int rtn;
+    int nCount = BENCH_WAKEUP_COUNT;
+    int nBytes = BENCH_WAKEUP_BYTES;
+    int nDone = 0;
+    char slave[64];
+    HCOM hCom;
+    unsigned char buf[256];
+    double t0;
+    double *pSamples;
+    const char *pMode = (argc > 3) ? argv[3] : "";
+    int nLoad = 0;
+    pthread_t hLoad[BENCH_LOAD_MAX];
+    COM_RX_CONFIG config;
+
+    if ( argc > 1 ) nCount = atoi(argv[1]);
+    if ( argc > 2 ) nBytes = atoi(argv[2]);
+    if ( nCount <= 0 ) nCount = BENCH_WAKEUP_COUNT;
+    if ( nBytes <= 0 || nBytes > (int)sizeof(buf) ) nBytes = BENCH_WAKEUP_BYTES;
+
+    pSamples = (double *)malloc(sizeof(double) * nCount);
+    if ( pSamples == NULL ) return -1;
+
+    fdMaster = Bench_OpenPty(slave, sizeof(slave));
+    if ( fdMaster < 0 ) {
+        printf("Failed to open pty.\n");
+        free(pSamples);
+        return -1;
+    }
+    hCom = com_init_device(slave, BENCH_BAUDRATE);
+    if ( hCom == NULL ) {
+        close(fdMaster);
+        free(pSamples);
+        return -1;
+    }
+
+    if ( strstr(pMode, "rt") != NULL ) {
+        config.nPolicy = COM_SCHED_FIFO;
+        config.nPriority = BENCH_RT_PRIORITY;
+        config.nCpuMask = 0;
+        config.bLockMemory = 1;
+        rtn = com_set_rx_config(hCom, &config);
+        printf("receive thread SCHED_FIFO/%d + mlock : %s\n", BENCH_RT_PRIORITY,
+               (rtn == 0) ? "applied" : "refused (run as root or raise RLIMIT_RTPRIO/MEMLOCK)");
+    }
+    if ( strstr(pMode, "load") != NULL ) {
+        m_bLoad = 1;
+        nLoad = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if ( nLoad < 1 ) nLoad = 1;
+        if ( nLoad > BENCH_LOAD_MAX ) nLoad = BENCH_LOAD_MAX;
+        for ( i = 0; i < nLoad; i++ ) {
+            if ( pthread_create(&hLoad[i], NULL, LoadThread, NULL) != 0 ) break;
+        }
+        nLoad = i;
+    }
+
+    for ( i = 0; i < (int)sizeof(buf); i++ ) {
+        buf[i] = (unsigned char)i;
+    }
+    for ( i = 0; i < nCount; i++ ) {
+        t0 = Bench_NowUs();
+        if ( write(fdMaster, buf, nBytes) != nBytes ) break;
+        if ( com_recv(hCom, 1000, buf, nBytes) != nBytes ) break;
+        pSamples[nDone++] = Bench_NowUs() - t0;
+    }
+
+    m_bLoad = 0;
+    for ( i = 0; i < nLoad; i++ ) {
+        pthread_join(hLoad[i], NULL);
+    }
+
+    printf("wakeup %d bytes%s%s\n", nBytes, (*pMode != '\0') ? ", " : "", pMode);
+    Bench_PrintLatency("wakeup (pty -> com_recv)", pSamples, nDone);
+
+    com_close(hCom);
+    close(fdMaster);
+    free(pSamples);
+    return (nDone == nCount) ? 0 : -1;
+}
+
+typedef struct {
+    int     fd;
+    int     nBytes;
+} BENCH_FEEDER;
+
+/* Device side: pushes nBytes into the pty as fast as it will take them */
+static void *FeedThread(void *pParam)
+{
+    BENCH_FEEDER *pFeed = (BENCH_FEEDER *)pParam;
+    unsigned char buf[BENCH_THROUGHPUT_CHUNK];
+    int nSent = 0;
+    int n, rlen;
+
+    for ( n = 0; n < (int)sizeof(buf); n++ ) {
+        buf[n] = (unsigned char)n;
+    }
+    while ( nSent < pFeed->nBytes ) {
+        n = pFeed->nBytes - nSent;
+        if ( n > (int)sizeof(buf) ) n = sizeof(buf);
+        rlen = write(pFeed->fd, buf, n);
+        if ( rlen <= 0 ) break;
+        nSent += rlen;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/* throughput : bulk transfer through the receive thread into com_recv(),    */
+/*              or parsed in place with com_peek()/com_consume() ("peek")     */
+/*              (host CPU per byte, all threads)                              */
+/*----------------------------------------------------------------------------*/
+int BenchUartThroughput(int argc, char *argv[])
+{
+    int i, n;
+    int fdMaster;
+    int nKBytes = BENCH_THROUGHPUT_KB;
+    int nRecv = 0;
+    int rlen;
+    int bPeek = 0;
+    unsigned int sum = 0;
+    COM_SPAN span[2];
+    COM_STATS stats;
+    char slave[64];
+    HCOM hCom;
+    unsigned char buf[BENCH_THROUGHPUT_CHUNK];
+    double wall, cpu;
+    pthread_t hFeed;
+    BENCH_FEEDER feed;
+
+    if ( argc > 1 ) nKBytes = atoi(argv[1]);
+    if ( argc > 2 ) bPeek = (strcmp(argv[2], "peek") == 0);
+    if ( nKBytes <= 0 ) nKBytes = BENCH_THROUGHPUT_KB;
+
+    fdMaster = Bench_OpenPty(slave, sizeof(slave));
+    if ( fdMaster < 0 ) {
+        printf("Failed to open pty.\n");
+        return -1;
+    }
+    hCom = com_init_device(slave, BENCH_BAUDRATE);
+    if ( hCom == NULL ) {
+        close(fdMaster);
+        return -1;
+    }
+
+    feed.fd = fdMaster;
+    feed.nBytes = nKBytes * 1024;
+
+    wall = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    if ( pthread_create(&hFeed, NULL, FeedThread, &feed) != 0 ) {
+        com_close(hCom);
+        close(fdMaster);
+        return -1;
+    }
+    /* Both modes read every byte once, as a decoder would */
+    while ( nRecv < feed.nBytes ) {
+        rlen = feed.nBytes - nRecv;
+        if ( bPeek ) {
+            if ( rlen > BENCH_THROUGHPUT_CHUNK ) rlen = BENCH_THROUGHPUT_CHUNK;
+            rlen = com_peek(hCom, 1000, rlen, span);
+            if ( rlen <= 0 ) break;
+            for ( n = 0; n < 2; n++ ) {
+                for ( i = 0; i < span[n].nSize; i++ ) sum += span[n].pData[i];
+            }
+            com_consume(hCom, rlen);
+        }
+        else {
+            if ( rlen > (int)sizeof(buf) ) rlen = sizeof(buf);
+            rlen = com_recv(hCom, 1000, buf, rlen);
+            if ( rlen <= 0 ) break;
+            for ( i = 0; i < rlen; i++ ) sum += buf[i];
+        }
+        nRecv += rlen;
+    }
+    cpu = Bench_CpuUs() - cpu;
+    wall = Bench_NowUs() - wall;
+    pthread_join(hFeed, NULL);
+
+    printf("throughput %d KB (%s) : %.1f MB/s, cpu=%.1fms (%.2f ns/byte, feeder included) sum=%08X\n",
+           nRecv / 1024, bPeek ? "peek" : "recv", (double)nRecv / wall, cpu / 1e3,
+           cpu * 1e3 / (nRecv > 0 ? nRecv : 1), sum);
+    com_get_stats(hCom, &stats);
+    printf("    reads=%llu (%.0f B/read) wakeups=%llu max buffered=%u/%u overrun=%llu timeouts=%llu\n",
+           stats.nReads, (double)stats.nBytesIn / (stats.nReads > 0 ? stats.nReads : 1), stats.nWakeups,
+           stats.nMaxBuffered, stats.nBufferSize, stats.nOverrunBytes, stats.nTimeouts);
+
+    com_close(hCom);
+    close(fdMaster);
+    return (nRecv == feed.nBytes) ? 0 : -1;
+}
+
+/* Voluntary + involuntary context switches of the whole process */
+static double ContextSwitches(void)
+{
+    struct rusage ru;
+
+    if ( getrusage(RUSAGE_SELF, &ru) != 0 ) return 0;
+    return (double)ru.ru_nvcsw + (double)ru.ru_nivcsw;
+}
+
+/* One step of the scaling benchmark: nPorts sensors for nSeconds */
+static int ScalingRun(int nMode, int nPorts, int nSeconds)
+{
+    int i, n;
+    int nTicks = nSeconds * BENCH_SCALING_HZ;
+    int nFrames = 0;
+    int nOpened = 0;
+    int *pMaster;
+    HCOM *pCom;
+    char slave[64];
+    unsigned char frame[BENCH_SCALING_FRAME];
+    unsigned char buf[BENCH_SCALING_FRAME];
+    double wall, cpu, ctxsw, next, now;
+
+    pMaster = (int *)malloc(sizeof(int) * nPorts);
+    pCom = (HCOM *)malloc(sizeof(HCOM) * nPorts);
+    if ( pMaster == NULL || pCom == NULL ) {
+        free(pMaster);
+        free(pCom);
+        return -1;
+    }
+
+    com_set_rx_mode(nMode);
+    for ( nOpened = 0; nOpened < nPorts; nOpened++ ) {
+        pMaster[nOpened] = Bench_OpenPty(slave, sizeof(slave));
+        if ( pMaster[nOpened] < 0 ) break;
+        pCom[nOpened] = com_init_device(slave, BENCH_BAUDRATE);
+        if ( pCom[nOpened] == NULL ) {
+            close(pMaster[nOpened]);
+            break;
+        }
+    }
+    com_set_rx_mode(COM_RX_THREAD);
+    if ( nOpened < nPorts ) {
+        printf("Failed to open %d ports (descriptor limit?).\n", nPorts);
+        nTicks = 0;
+    }
+
+    for ( i = 0; i < (int)sizeof(frame); i++ ) {
+        frame[i] = (unsigned char)i;
+    }
+
+    /* Every sensor sends one frame per tick; the host reads them all */
+    wall = Bench_NowUs();
+    cpu = Bench_CpuUs();
+    ctxsw = ContextSwitches();
+    next = wall;
+    for ( n = 0; n < nTicks; n++ ) {
+        for ( i = 0; i < nPorts; i++ ) {
+            if ( write(pMaster[i], frame, sizeof(frame)) != (int)sizeof(frame) ) break;
+        }
+        for ( i = 0; i < nPorts; i++ ) {
+            if ( com_recv(pCom[i], 1000, buf, sizeof(buf)) == (int)sizeof(buf) ) nFrames++;
+        }
+        next += 1e6 / BENCH_SCALING_HZ;
+        now = Bench_NowUs();
+        if ( next > now ) usleep((useconds_t)(next - now));
+    }
+    cpu = Bench_CpuUs() - cpu;
+    wall = Bench_NowUs() - wall;
+    ctxsw = ContextSwitches() - ctxsw;
+
+    if ( nTicks > 0 ) {
+        printf("scaling %-7s ports=%-3d : cpu=%6.2f%% (%7.1f us/s per sensor) ctxsw=%8.0f/s frames=%d/%d\n",
+               (nMode == COM_RX_REACTOR) ? "reactor" : "thread", nPorts, cpu * 100.0 / wall,
+               cpu * 1e6 / wall / nPorts, ctxsw * 1e6 / wall, nFrames, nTicks * nPorts);
+    }
+
+    for ( i = 0; i < nOpened; i++ ) {
+        com_close(pCom[i]);
+        close(pMaster[i]);
+    }
+    free(pMaster);
+    free(pCom);
+    return (nTicks > 0 && nFrames == nTicks * nPorts) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* scaling : CPU per sensor as the number of ports grows, with one receive    */
+/*           thread per port and with the shared epoll reactor                */
+/*           mode "thread" or "reactor" runs only that one                    */
+/*----------------------------------------------------------------------------*/
+int BenchUartScaling(int argc, char *argv[])
+{
+    int nMaxPorts = BENCH_SCALING_PORTS;
+    int nSeconds = BENCH_SCALING_SECONDS;
+    const char *pMode = (argc > 3) ? argv[3] : "";
+    int nPorts;
+    int ret = 0;
+
+    if ( argc > 1 ) nMaxPorts = atoi(argv[1]);
+    if ( argc > 2 ) nSeconds = atoi(argv[2]);
+    if ( nMaxPorts <= 0 ) nMaxPorts = BENCH_SCALING_PORTS;
+    if ( nSeconds <= 0 ) nSeconds = BENCH_SCALING_SECONDS;
+
+    printf("scaling: %d frames/s of %d bytes per sensor\n", BENCH_SCALING_HZ, BENCH_SCALING_FRAME);
+    for ( nPorts = 1; nPorts <= nMaxPorts; nPorts *= 2 ) {
+        if ( strcmp(pMode, "reactor") != 0 && ScalingRun(COM_RX_THREAD, nPorts, nSeconds) != 0 ) ret = -1;
+        if ( strcmp(pMode, "thread") != 0 && ScalingRun(COM_RX_REACTOR, nPorts, nSeconds) != 0 ) ret = -1;
+    }
+    return ret;
+}
@@ -0,0 +1,244 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    HVC host-side benchmarks (Linux)
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include "uart.h"
+#include "HVCApi.h"
+#include "HVCExtraUartFunc.h"
+#include "HVCBench.h"
+
+#define BENCH_PTY_WIRE_CHUNK    256     /* Bytes per write when the wire is paced */
+
+typedef struct {
+    const char  *name;
+    BENCH_FUNC  func;
+    const char  *usage;
+} BENCH_ENTRY;
+
+static const BENCH_ENTRY m_benchList[] = {
+    { "idle",       BenchUartIdle,      "idle [seconds]         receive thread CPU while the line is silent" },
+    { "arrival",    BenchUartArrival,   "arrival [count]        byte arrival to receive buffer latency" },
+    { "wakeup",     BenchUartWakeup,    "wakeup [count] [bytes] [rt|load|rt+load]\n"
+                    "                           device write to com_recv() return latency" },
+    { "throughput", BenchUartThroughput, "throughput [KB] [peek] bulk receive rate and CPU per byte" },
+    { "scaling",    BenchUartScaling,   "scaling [ports] [seconds] [thread|reactor]\n"
+                    "                           CPU per sensor, thread per port vs. epoll reactor" },
+    { "transport",  BenchTransport,     "transport [count]      HVC_GetVersion over loopback/replay/pty" },
+    { "resync",     BenchResync,        "resync [count] [noise] stray bytes ahead of responses, header resync" },
+    { "replay",     BenchReplay,        "replay [frames] [file] HVC_ExecuteEx (+STB) fed from a wire capture" },
+    { "execute",    BenchExecute,       "execute [frames] [qvga|half]\n"
+                    "                           HVC_ExecuteEx frame latency against the simulator" },
+    { "async",      BenchExecuteAsync,  "async [sensors] [frames]\n"
+                    "                           several sensors, blocking HVC_ExecuteEx vs. Begin/Poll" },
+    { "stream",     BenchExecuteStream, "stream [frames] [host_us]\n"
+                    "                           HVC_ExecuteEx loop vs. double/triple buffered stream" },
+    { "progressive", BenchExecuteProgressive, "progressive [frames] [rows]\n"
+                    "                           QVGA image at 921600 baud, whole vs. rows as they arrive" },
+    { "packed",     BenchExecutePacked, "packed [frames]        result history as packed frames vs. HVC_RESULT" },
+    { "config",     BenchConfig,        "config [rounds] [link_us]\n"
+                    "                           Set/Get each field vs. diff-based HVC_ConfigApply" },
+    { "batch",      BenchBatch,         "batch [users] [window] [link_us]\n"
+                    "                           bulk DeleteUser and config push, serial vs. HVC_BatchRun" },
+    { "check",      BenchCheck,         "check                  pass/fail checks over loopback, nonzero exit on a failure" },
+};
+
+#define BENCH_NUM   (int)(sizeof(m_benchList)/sizeof(m_benchList[0]))
+
+static unsigned long long m_nRecvCalls;     /* UART_ReceiveData() calls so far */
+
+/* HVCApi hooks: the handle given to HVC_* is the port itself */
+int UART_SendData(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData)
+{
+    return com_send((HCOM)inHandle, inData, inDataSize);
+}
+
+int UART_SendDataPipelined(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData)
+{
+    COM_SPAN vec;
+
+    vec.pData = inData;
+    vec.nSize = inDataSize;
+    return com_sendv_flags((HCOM)inHandle, &vec, 1, COM_SEND_KEEP_RX);
+}
+
+int UART_SendDataV(HVC_HANDLE inHandle, int inDataNum, UINT8 **inData, int *inDataSize)
+{
+    COM_SPAN vec[UART_SEND_VEC_MAX];
+    int i;
+
+    if ( inDataNum > UART_SEND_VEC_MAX ) return 0;
+    for ( i = 0; i < inDataNum; i++ ) {
+        vec[i].pData = inData[i];
+        vec[i].nSize = inDataSize[i];
+    }
+    return com_sendv((HCOM)inHandle, vec, inDataNum);
+}
+
+int UART_ReceiveData(HVC_HANDLE inHandle, int inTimeOutTime, int inDataSize, UINT8 *outResult)
+{
+    m_nRecvCalls++;
+    return com_recv((HCOM)inHandle, inTimeOutTime, outResult, inDataSize);
+}
+
+int UART_GetReceiveSize(HVC_HANDLE inHandle)
+{
+    return com_length((HCOM)inHandle);
+}
+
+void UART_NotifyResync(HVC_HANDLE inHandle, int inSkipSize)
+{
+    com_count_resync((HCOM)inHandle, inSkipSize);
+}
+
+/* Receive calls made by HVCApi (benchmarks run HVC_* on one thread) */
+unsigned long long Bench_RecvCalls(void)
+{
+    return m_nRecvCalls;
+}
+
+/* Monotonic wall clock (us) */
+double Bench_NowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+/* CPU time consumed by the whole process, all threads (us) */
+double Bench_CpuUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Open a pseudo-terminal standing in for the HVC-P2                          */
+/* param    : char  *outSlaveName   device path the host side should open     */
+/*          : int   inNameSize      size of outSlaveName                      */
+/* return   : int                   master descriptor, -1 on failure          */
+/*----------------------------------------------------------------------------*/
+int Bench_OpenPty(char *outSlaveName, int inNameSize)
+{
+    int fd;
+    struct termios tio;
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ( fd < 0 ) return -1;
+    if ( grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, outSlaveName, inNameSize) != 0 ) {
+        close(fd);
+        return -1;
+    }
+    /* The device side must not echo or translate anything either */
+    if ( tcgetattr(fd, &tio) == 0 ) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/* Simulated device: writes a response to the pty (HVCSIM_OUTPUT_FUNC) */
+void Bench_PtyOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    BENCH_PTY_DEVICE *pDev = (BENCH_PTY_DEVICE *)pParam;
+    int n, wlen, len;
+    double t0, wait;
+
+    (void)inCmdSize;
+    if ( pDev->bProcTime && inProcTime > 0 ) usleep((useconds_t)inProcTime);
+    t0 = Bench_NowUs();
+    for ( n = 0; n < inSize; n += wlen ) {
+        len = inSize - n;
+        if ( pDev->nWireRate > 0 ) {
+            /* Hand the bytes over no faster than the UART would clock them out */
+            if ( len > BENCH_PTY_WIRE_CHUNK ) len = BENCH_PTY_WIRE_CHUNK;
+            wait = t0 + (double)n * 1e6 / pDev->nWireRate - Bench_NowUs();
+            if ( wait > 0 ) usleep((useconds_t)wait);
+        }
+        wlen = write(pDev->fd, &inData[n], len);
+        if ( wlen <= 0 ) return;
+    }
+}
+
+/* Simulated device: feeds the commands read from the pty to the simulator */
+void *Bench_PtyDeviceThread(void *pParam)
+{
+    BENCH_PTY_DEVICE *pDev = (BENCH_PTY_DEVICE *)pParam;
+    unsigned char buf[256];
+    int rlen;
+
+    while ( (rlen = read(pDev->fd, buf, sizeof(buf))) > 0 ) {
+        HVCSim_Input(pDev->pSim, buf, rlen);
+    }
+    return NULL;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+/* Sorts the samples (us) and prints min/median/p99/max */
+void Bench_PrintLatency(const char *inTitle, double *ioSamples, int inNum)
+{
+    if ( inNum <= 0 ) {
+        printf("%-28s no samples\n", inTitle);
+        return;
+    }
+    qsort(ioSamples, inNum, sizeof(double), CompareDouble);
+    printf("%-28s n=%-6d min=%9.1fus p50=%9.1fus p99=%9.1fus max=%9.1fus\n", inTitle, inNum,
+           ioSamples[0], ioSamples[inNum/2], ioSamples[(inNum*99)/100], ioSamples[inNum-1]);
+}
+
+static void PrintUsage(void)
+{
+    int i;
+
+    printf("Usage: HVCBench <bench> [args]\n");
+    for ( i = 0; i < BENCH_NUM; i++ ) {
+        printf("    %s\n", m_benchList[i].usage);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    if ( argc < 2 ) {
+        PrintUsage();
+        return -1;
+    }
+    for ( i = 0; i < BENCH_NUM; i++ ) {
+        if ( strcmp(argv[1], m_benchList[i].name) == 0 ) {
+            return m_benchList[i].func(argc - 1, &argv[1]);
+        }
+    }
+    PrintUsage();
+    return -1;
+}
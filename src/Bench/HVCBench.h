@@ -0,0 +1,87 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    HVC host-side benchmarks (Linux)
+*/
+
+#ifndef HVCBench_H__
+#define HVCBench_H__
+
+#include "HVCSim.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* Benchmark entry                                                            */
+/* param    : int   argc        number of benchmark arguments                 */
+/*          : char  *argv[]     benchmark arguments (argv[0] = bench name)    */
+/* return   : int               0...normal, other...failure                   */
+/*----------------------------------------------------------------------------*/
+typedef int (*BENCH_FUNC)(int argc, char *argv[]);
+
+/* Simulated device on the master side of a pty */
+typedef struct {
+    int     fd;
+    HVCSIM  *pSim;
+    int     bProcTime;      /* Wait the processing time before answering */
+    int     nWireRate;      /* Bytes per second on the wire, 0...unpaced */
+} BENCH_PTY_DEVICE;
+
+/* Helpers shared by the benchmarks (HVCBench.c) */
+double Bench_NowUs(void);
+double Bench_CpuUs(void);
+int Bench_OpenPty(char *outSlaveName, int inNameSize);
+void Bench_PrintLatency(const char *inTitle, double *ioSamples, int inNum);
+unsigned long long Bench_RecvCalls(void);
+void Bench_PtyOutput(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime);
+void *Bench_PtyDeviceThread(void *pParam);
+
+/* UART receive path (BenchUart.c) */
+int BenchUartIdle(int argc, char *argv[]);
+int BenchUartArrival(int argc, char *argv[]);
+int BenchUartWakeup(int argc, char *argv[]);
+int BenchUartThroughput(int argc, char *argv[]);
+int BenchUartScaling(int argc, char *argv[]);
+
+/* Transport backends (BenchTransport.c) */
+int BenchTransport(int argc, char *argv[]);
+int BenchResync(int argc, char *argv[]);
+
+/* Wire capture replay (BenchReplay.c) */
+int BenchReplay(int argc, char *argv[]);
+
+/* Execute response receive and decode (BenchExecute.c) */
+int BenchExecute(int argc, char *argv[]);
+int BenchExecuteAsync(int argc, char *argv[]);
+int BenchExecuteStream(int argc, char *argv[]);
+int BenchExecuteProgressive(int argc, char *argv[]);
+int BenchExecutePacked(int argc, char *argv[]);
+
+/* Device commands (BenchCommand.c) */
+int BenchConfig(int argc, char *argv[]);
+int BenchBatch(int argc, char *argv[]);
+
+/* Pass/fail checks (BenchCheck.c) */
+int BenchCheck(int argc, char *argv[]);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCBench_H__ */
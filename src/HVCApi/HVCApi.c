@@ -19,7 +19,14 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 #include "HVCApi.h"
+#include "HVCFramePool.h"
 #include "HVCExtraUartFunc.h"
 
 /*----------------------------------------------------------------------------*/
@@ -74,21 +81,78 @@ typedef enum {
     RECEIVE_HEAD_NUM
 }RECEIVE_HEADER;
 
+/* Response codes the device sends: normal end and the command-specific     */
+/* errors up to HVC_STATUS_SPECIFIC_MAX, then the communication, improper    */
+/* command, internal and undefined command errors from HVC_STATUS_ERROR_MIN  */
+#define HVC_STATUS_SPECIFIC_MAX         (UINT8)0x0F
+#define HVC_STATUS_ERROR_MIN            (UINT8)0xFB
+
+/*----------------------------------------------------------------------------*/
+/* Monotonic clock (ms)                                                       */
+/* return   : UINT32                        free-running tick, wraps around;  */
+/*          :                               compare ticks only by difference  */
+/*----------------------------------------------------------------------------*/
+static UINT32 HVC_GetTickCount(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER freq, count;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (UINT32)((count.QuadPart / freq.QuadPart) * 1000 +
+                    ((count.QuadPart % freq.QuadPart) * 1000) / freq.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UINT32)ts.tv_sec * 1000 + (UINT32)(ts.tv_nsec / 1000000);
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/* Absolute deadline for a whole command                                      */
+/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* return   : UINT32                        deadline tick                     */
+/*----------------------------------------------------------------------------*/
+static UINT32 HVC_GetDeadline(INT32 inTimeOutTime)
+{
+    if ( inTimeOutTime < 0 ) inTimeOutTime = 0;
+    return HVC_GetTickCount() + (UINT32)inTimeOutTime;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Time left until the deadline                                               */
+/* param    : UINT32        inDeadline      deadline tick                     */
+/* return   : INT32                         remaining time (ms), 0 if passed  */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_GetRemainingTime(UINT32 inDeadline)
+{
+    INT32 rest = (INT32)(inDeadline - HVC_GetTickCount());
+    return (rest > 0) ? rest : 0;
+}
+
 /*----------------------------------------------------------------------------*/
 /* Send command signal                                                        */
-/* param    : UINT8         inCommandNo     command number                    */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : UINT8         inCommandNo     command number                    */
 /*          : INT32         inDataSize      sending signal data size          */
 /*          : UINT8         *inData         sending signal data               */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -10...timeout error               */
 /*----------------------------------------------------------------------------*/
-static INT32 HVC_SendCommand(UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData)
+static INT32 HVC_SendCommand(HVC_HANDLE inHandle, UINT32 inDeadline, UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData)
 {
     INT32 i;
     INT32 ret = 0;
     UINT8 sendData[32];
 
+    /* The budget may already be spent by the caller */
+    if ( (INT32)(inDeadline - HVC_GetTickCount()) < 0 ) {
+        return HVC_ERROR_SEND_DATA;
+    }
+
     /* Create header */
     sendData[SEND_HEAD_SYNCBYTE]        = (UINT8)0xFE;
     sendData[SEND_HEAD_COMMANDNO]       = (UINT8)inCommandNo;
@@ -100,7 +164,7 @@ static INT32 HVC_SendCommand(UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData)
     }
 
     /* Send command signal */
-    ret = UART_SendData(SEND_HEAD_NUM+inDataSize, sendData);
+    ret = UART_SendData(inHandle, SEND_HEAD_NUM+inDataSize, sendData);
     if(ret != SEND_HEAD_NUM+inDataSize){
         return HVC_ERROR_SEND_DATA;
     }
@@ -110,103 +174,213 @@ static INT32 HVC_SendCommand(UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData)
 
 /*----------------------------------------------------------------------------*/
 /* Send command signal of LoadAlbum                                           */
-/* param    : UINT8         inCommandNo     command number                    */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : UINT8         inCommandNo     command number                    */
 /*          : INT32         inDataSize      sending signal data size          */
 /*          : UINT8         *inData         sending signal data               */
+/*          : HVC_SEND_PROGRESS_FUNC inProgress progress hook, NULL...none    */
+/*          : void          *pParam         passed to inProgress              */
+/*          : INT32         *outSentSize    data bytes sent                   */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -10...timeout error               */
+/* The header goes out with the first HVC_ALBUM_SEND_CHUNK bytes of the data, */
+/* the rest a chunk per send, straight from the caller's buffer. The deadline */
+/* is checked before every chunk.                                             */
 /*----------------------------------------------------------------------------*/
-static INT32 HVC_SendCommandOfLoadAlbum(UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData)
+static INT32 HVC_SendCommandOfLoadAlbum(HVC_HANDLE inHandle, UINT32 inDeadline, UINT8 inCommandNo, INT32 inDataSize, UINT8 *inData,
+                                        HVC_SEND_PROGRESS_FUNC inProgress, void *pParam, INT32 *outSentSize)
 {   
-    INT32 i;
     INT32 ret = 0;
-    UINT8 *pSendData = NULL;
+    INT32 head = SEND_HEAD_NUM + 4;
+    INT32 chunk;
+    int nVec;
+    UINT8 sendData[SEND_HEAD_NUM + 4];
+    UINT8 *pSendData[UART_SEND_VEC_MAX];
+    int nSendSize[UART_SEND_VEC_MAX];
 
-    pSendData = (UINT8*)malloc(SEND_HEAD_NUM + 4 + inDataSize);
+    *outSentSize = 0;
 
     /* Create header */
-    pSendData[SEND_HEAD_SYNCBYTE]       = (UINT8)0xFE;
-    pSendData[SEND_HEAD_COMMANDNO]      = (UINT8)inCommandNo;
-    pSendData[SEND_HEAD_DATALENGTHLSB]  = (UINT8)4;
-    pSendData[SEND_HEAD_DATALENGTHMSB]  = (UINT8)0;
+    sendData[SEND_HEAD_SYNCBYTE]        = (UINT8)0xFE;
+    sendData[SEND_HEAD_COMMANDNO]       = (UINT8)inCommandNo;
+    sendData[SEND_HEAD_DATALENGTHLSB]   = (UINT8)4;
+    sendData[SEND_HEAD_DATALENGTHMSB]   = (UINT8)0;
+
+    sendData[SEND_HEAD_NUM + 0]         = (UINT8)(inDataSize & 0x000000ff);
+    sendData[SEND_HEAD_NUM + 1]         = (UINT8)((inDataSize >> 8) & 0x000000ff);
+    sendData[SEND_HEAD_NUM + 2]         = (UINT8)((inDataSize >> 16) & 0x000000ff);
+    sendData[SEND_HEAD_NUM + 3]         = (UINT8)((inDataSize >> 24) & 0x000000ff);
+
+    do {
+        /* The budget may already be spent, by the caller or the chunks before */
+        if ( (INT32)(inDeadline - HVC_GetTickCount()) < 0 ) {
+            return HVC_ERROR_SEND_DATA;
+        }
 
-    pSendData[SEND_HEAD_NUM + 0]        = (UINT8)(inDataSize & 0x000000ff);
-    pSendData[SEND_HEAD_NUM + 1]        = (UINT8)((inDataSize >> 8) & 0x000000ff);
-    pSendData[SEND_HEAD_NUM + 2]        = (UINT8)((inDataSize >> 16) & 0x000000ff);
-    pSendData[SEND_HEAD_NUM + 3]        = (UINT8)((inDataSize >> 24) & 0x000000ff);
+        nVec = 0;
+        if ( head > 0 ) {
+            pSendData[nVec] = sendData;
+            nSendSize[nVec] = head;
+            nVec++;
+        }
+        chunk = inDataSize - *outSentSize;
+        if ( chunk > HVC_ALBUM_SEND_CHUNK ) chunk = HVC_ALBUM_SEND_CHUNK;
+        if ( chunk > 0 ) {
+            pSendData[nVec] = &inData[*outSentSize];
+            nSendSize[nVec] = chunk;
+            nVec++;
+        }
 
-     for(i = 0; i < inDataSize; i++){
-        pSendData[SEND_HEAD_NUM + 4 + i] = inData[i];
-    }
+        /* Send command signal */
+        ret = UART_SendDataV(inHandle, nVec, pSendData, nSendSize) - head;
+        if ( ret > 0 ) *outSentSize += ret;
+        if ( ret != chunk ) return HVC_ERROR_SEND_DATA;
+        head = 0;
 
-    /* Send command signal */
-    ret = UART_SendData(SEND_HEAD_NUM+4+inDataSize, pSendData);
-    if(ret != SEND_HEAD_NUM + 4 + inDataSize){
-        ret = HVC_ERROR_SEND_DATA;
+        if ( NULL != inProgress ) {
+            inProgress(pParam, *outSentSize, inDataSize);
+        }
+    } while ( *outSentSize < inDataSize );
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Check a response header                                                    */
+/* param    : UINT8         *inHeader       RECEIVE_HEAD_NUM bytes            */
+/*          : INT32         inMinSize       shortest data of a normal end     */
+/*          : INT32         inMaxSize       longest data of a normal end      */
+/*          : INT32         *outDataSize    receive signal data length        */
+/* return   : INT32                         1...a header, 0...not a header    */
+/* A header has the sync byte, a response code the device sends, and data of  */
+/* inMinSize to inMaxSize bytes; a fixed-size reply passes its size as both.  */
+/* An error response may also come without data.                              */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_CheckHeader(const UINT8 *inHeader, INT32 inMinSize, INT32 inMaxSize, INT32 *outDataSize)
+{
+    UINT8 status = inHeader[RECEIVE_HEAD_STATUS];
+    INT32 size;
+
+    if ( (UINT8)0xFE != inHeader[RECEIVE_HEAD_SYNCBYTE] ) return 0;
+    if ( (status > HVC_STATUS_SPECIFIC_MAX) && (status < HVC_STATUS_ERROR_MIN) ) return 0;
+
+    /* Get data length */
+    size = inHeader[RECEIVE_HEAD_DATALENLL] +
+            (inHeader[RECEIVE_HEAD_DATALENLM]<<8) +
+            (inHeader[RECEIVE_HEAD_DATALENML]<<16) +
+            (inHeader[RECEIVE_HEAD_DATALENMM]<<24);
+    if ( ((size < inMinSize) || (size > inMaxSize)) && ((size != 0) || (status == 0)) ) return 0;
+
+    *outDataSize = size;
+    return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* One try at the response header                                             */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : INT32         inMinSize       shortest data of a normal end     */
+/*          : INT32         inMaxSize       longest data of a normal end      */
+/*          : UINT8         *ioHeader       header bytes so far               */
+/*          : INT32         *ioHeaderSize   number of header bytes so far     */
+/*          : INT32         *ioSkip         bytes skipped so far              */
+/*          : INT32         *outDataSize    receive signal data length        */
+/*          : UINT8         *outStatus      status                            */
+/* return   : INT32                         execution result error code       */
+/*          :                               1...not a header, try again       */
+/*          :                               0...normal                        */
+/*          :                               -20...timeout error               */
+/*          :                               -21...invalid header error        */
+/* Receives the rest of the header bytes. When they are no header (see        */
+/* HVC_CheckHeader()), the bytes up to the next sync byte are skipped and the */
+/* rest kept, so no byte past a header is ever consumed. -21 means bytes were */
+/* skipped and no header followed before the deadline. The skipped bytes are  */
+/* reported once the search ends.                                             */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_ReceiveHeaderStep(HVC_HANDLE inHandle, UINT32 inDeadline, INT32 inMinSize, INT32 inMaxSize,
+                                   UINT8 *ioHeader, INT32 *ioHeaderSize, INT32 *ioSkip,
+                                   INT32 *outDataSize, UINT8 *outStatus)
+{
+    INT32 ret = 0;
+    INT32 i;
+    INT32 keep = *ioHeaderSize;
+
+    /* Get header part, behind the bytes kept from the last try */
+    ret = UART_ReceiveData(inHandle, HVC_GetRemainingTime(inDeadline), RECEIVE_HEAD_NUM - keep, &ioHeader[keep]);
+    if(ret != RECEIVE_HEAD_NUM - keep){
+        ret = (*ioSkip > 0) ? HVC_ERROR_HEADER_INVALID : HVC_ERROR_HEADER_TIMEOUT;
     }
-    else{
+    else if ( HVC_CheckHeader(ioHeader, inMinSize, inMaxSize, outDataSize) ) {
+        /* Get command execution result */
+        *outStatus = ioHeader[RECEIVE_HEAD_STATUS];
         ret = 0;
     }
-    free(pSendData);
+    else {
+        /* Not a header: start again from the next sync byte */
+        for ( i = 1; (i < RECEIVE_HEAD_NUM) && ((UINT8)0xFE != ioHeader[i]); i++ );
+        *ioHeaderSize = RECEIVE_HEAD_NUM - i;
+        memmove(ioHeader, &ioHeader[i], *ioHeaderSize);
+        *ioSkip += i;
+        return HVC_PENDING;
+    }
 
+    if ( *ioSkip > 0 ) {
+        UART_NotifyResync(inHandle, *ioSkip);
+    }
     return ret;
 }
 
 /*----------------------------------------------------------------------------*/
 /* Receive header                                                             */
-/* param    : INT32         inTimeOutTime   timeout time                      */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : INT32         inMinSize       shortest data of a normal end     */
+/*          : INT32         inMaxSize       longest data of a normal end      */
 /*          : INT32         *outDataSize    receive signal data length        */
 /*          : UINT8         *outStatus      status                            */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -20...timeout error               */
 /*          :                               -21...invalid header error        */
+/* Bytes that cannot start a header are skipped, so a stray byte costs a few  */
+/* reads instead of the response (HVC_ReceiveHeaderStep()).                   */
 /*----------------------------------------------------------------------------*/
-static INT32 HVC_ReceiveHeader(INT32 inTimeOutTime, INT32 *outDataSize, UINT8 *outStatus)
+static INT32 HVC_ReceiveHeader(HVC_HANDLE inHandle, UINT32 inDeadline, INT32 inMinSize, INT32 inMaxSize,
+                               INT32 *outDataSize, UINT8 *outStatus)
 {
     INT32 ret = 0;
-    UINT8 headerData[32];
+    INT32 headerSize = 0;
+    INT32 skip = 0;
+    UINT8 headerData[RECEIVE_HEAD_NUM];
 
-    /* Get header part */
-    ret = UART_ReceiveData(inTimeOutTime, RECEIVE_HEAD_NUM, headerData);
-    if(ret != RECEIVE_HEAD_NUM){
-        return HVC_ERROR_HEADER_TIMEOUT;
-    }
-    else if((UINT8)0xFE != headerData[RECEIVE_HEAD_SYNCBYTE]){
-        /* Different value indicates an invalid result */
-        return HVC_ERROR_HEADER_INVALID;
-    }
+    do {
+        ret = HVC_ReceiveHeaderStep(inHandle, inDeadline, inMinSize, inMaxSize, headerData, &headerSize, &skip,
+                                    outDataSize, outStatus);
+    } while ( ret == HVC_PENDING );
 
-    /* Get data length */
-    *outDataSize = headerData[RECEIVE_HEAD_DATALENLL] +
-                    (headerData[RECEIVE_HEAD_DATALENLM]<<8) +
-                    (headerData[RECEIVE_HEAD_DATALENML]<<16) +
-                    (headerData[RECEIVE_HEAD_DATALENMM]<<24);
-
-    /* Get command execution result */
-    *outStatus  = headerData[RECEIVE_HEAD_STATUS];
-
-    return 0;
+    return ret;
 }
 
 /*----------------------------------------------------------------------------*/
 /* Receive data                                                               */
-/* param    : INT32         inTimeOutTime   timeout time                      */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
 /*          : INT32         inDataSize      receive signal data size          */
 /*          : UINT8         *outResult      receive signal data               */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -20...timeout error               */
 /*----------------------------------------------------------------------------*/
-static INT32 HVC_ReceiveData(INT32 inTimeOutTime, INT32 inDataSize, UINT8 *outResult)
+static INT32 HVC_ReceiveData(HVC_HANDLE inHandle, UINT32 inDeadline, INT32 inDataSize, UINT8 *outResult)
 {
     INT32 ret = 0;
 
     if ( inDataSize <= 0 ) return 0;
 
     /* Receive data */
-    ret = UART_ReceiveData(inTimeOutTime, inDataSize, outResult);
+    ret = UART_ReceiveData(inHandle, HVC_GetRemainingTime(inDeadline), inDataSize, outResult);
     if(ret != inDataSize){
         return HVC_ERROR_DATA_TIMEOUT;
     }
@@ -216,7 +390,8 @@ static INT32 HVC_ReceiveData(INT32 inTimeOutTime, INT32 inDataSize, UINT8 *outRe
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetVersion                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_VERSION   *outVersion     version data                      */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -224,8 +399,9 @@ static INT32 HVC_ReceiveData(INT32 inTimeOutTime, INT32 inDataSize, UINT8 *outRe
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetVersion(INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outStatus)
+INT32 HVC_GetVersion(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
 
@@ -234,24 +410,21 @@ INT32 HVC_GetVersion(INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outSta
     }
 
     /* Send GetVersion command signal */
-    ret = HVC_SendCommand(HVC_COM_GET_VERSION, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_VERSION, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(HVC_VERSION), sizeof(HVC_VERSION), &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(HVC_VERSION) ) {
-        size = sizeof(HVC_VERSION);
-    }
-
     /* Receive data */
-    return HVC_ReceiveData(inTimeOutTime, size, (UINT8*)outVersion);
+    return HVC_ReceiveData(inHandle, deadline, size, (UINT8*)outVersion);
 }
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetCameraAngle                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inAngleNo       camera angle number               */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -259,8 +432,9 @@ INT32 HVC_GetVersion(INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outSta
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetCameraAngle(INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus)
+INT32 HVC_SetCameraAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -271,11 +445,11 @@ INT32 HVC_SetCameraAngle(INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus)
 
     sendData[0] = (UINT8)(inAngleNo&0xff);
     /* Send SetCameraAngle command signal */
-    ret = HVC_SendCommand(HVC_COM_SET_CAMERA_ANGLE, sizeof(UINT8), sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_CAMERA_ANGLE, sizeof(UINT8), sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -283,7 +457,8 @@ INT32 HVC_SetCameraAngle(INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetCameraAngle                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outAngleNo     camera angle number               */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -291,8 +466,9 @@ INT32 HVC_SetCameraAngle(INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetCameraAngle(INT32 inTimeOutTime, INT32 *outAngleNo, UINT8 *outStatus)
+INT32 HVC_GetCameraAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outAngleNo, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -302,217 +478,496 @@ INT32 HVC_GetCameraAngle(INT32 inTimeOutTime, INT32 *outAngleNo, UINT8 *outStatu
     }
 
     /* Send GetCameraAngle command signal */
-    ret = HVC_SendCommand(HVC_COM_GET_CAMERA_ANGLE, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_CAMERA_ANGLE, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8), sizeof(UINT8), &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8) ) {
-        size = sizeof(UINT8);
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     *outAngleNo = recvData[0];
 
     return ret;
 }
 
 /*----------------------------------------------------------------------------*/
-/* HVC_Execute                                                                */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
-/*          : INT32         inExec          executable function               */
-/*          : INT32         inImage         image info                        */
-/*          : HVC_RESULT    *outHVCResult   result data                       */
-/*          : UINT8         *outStatus      response code                     */
-/* return   : INT32                         execution result error code       */
-/*          :                               0...normal                        */
-/*          :                               -1...parameter error              */
-/*          :                               other...signal error              */
+/* Execute result layout                                                      */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+#define HVC_RESULT_DETECT_MAX       35      /* Entries of bdResult/hdResult/fcResult */
+#define HVC_RESULT_COUNT_SIZE       4       /* Body, hand and face counts + reserved */
+#define HVC_RESULT_DETECT_SIZE      8       /* One body, hand or face detection */
+#define HVC_RESULT_IMAGE_HEAD_SIZE  4       /* Image width and height */
+
+/* Wire format of the results (index of the size/decoder columns below) */
+#define HVC_RESULT_FORMAT_EXECUTE   0       /* HVC_Execute: top expression only */
+#define HVC_RESULT_FORMAT_EXECUTEEX 1       /* HVC_ExecuteEx: all expression scores */
+#define HVC_RESULT_FORMAT_NUM       2
+
+/* Decoders of one per-face field */
+static void HVC_DecodeFaceDetection(const UINT8 *p, FACE_RESULT *pFace)
 {
+    pFace->dtResult.posX = (short)(p[0] + (p[1]<<8));
+    pFace->dtResult.posY = (short)(p[2] + (p[3]<<8));
+    pFace->dtResult.size = (short)(p[4] + (p[5]<<8));
+    pFace->dtResult.confidence = (short)(p[6] + (p[7]<<8));
+}
+
+static void HVC_DecodeFaceDirection(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->dirResult.yaw = (short)(p[0] + (p[1]<<8));
+    pFace->dirResult.pitch = (short)(p[2] + (p[3]<<8));
+    pFace->dirResult.roll = (short)(p[4] + (p[5]<<8));
+    pFace->dirResult.confidence = (short)(p[6] + (p[7]<<8));
+}
+
+static void HVC_DecodeAge(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->ageResult.age = (char)(p[0]);
+    pFace->ageResult.confidence = (short)(p[1] + (p[2]<<8));
+}
+
+static void HVC_DecodeGender(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->genderResult.gender = (char)(p[0]);
+    pFace->genderResult.confidence = (short)(p[1] + (p[2]<<8));
+}
+
+static void HVC_DecodeGaze(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->gazeResult.gazeLR = (char)(p[0]);
+    pFace->gazeResult.gazeUD = (char)(p[1]);
+}
+
+static void HVC_DecodeBlink(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->blinkResult.ratioL = (short)(p[0] + (p[1]<<8));
+    pFace->blinkResult.ratioR = (short)(p[2] + (p[3]<<8));
+}
+
+/* Execute: top expression, its score and the degree */
+static void HVC_DecodeExpression(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->expressionResult.topExpression = (char)(p[0]);
+    pFace->expressionResult.topScore = (char)(p[1]);
+    pFace->expressionResult.degree = (char)(p[2]);
+}
+
+/* ExecuteEx: all five scores, the top one picked here, and the degree */
+static void HVC_DecodeExpressionEx(const UINT8 *p, FACE_RESULT *pFace)
+{
+    int j;
+
+    pFace->expressionResult.topExpression = -128;
+    pFace->expressionResult.topScore = -128;
+    for(j = 0; j < 5; j++){
+        pFace->expressionResult.score[j] = (char)(p[j]);
+        if(pFace->expressionResult.topScore < pFace->expressionResult.score[j]){
+            pFace->expressionResult.topScore = pFace->expressionResult.score[j];
+            pFace->expressionResult.topExpression = j + 1;
+        }
+    }
+    pFace->expressionResult.degree = (char)(p[5]);
+}
+
+static void HVC_DecodeRecognition(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->recognitionResult.uid = (short)(p[0] + (p[1]<<8));
+    pFace->recognitionResult.confidence = (short)(p[2] + (p[3]<<8));
+}
+
+static void HVC_DecodeVerify(const UINT8 *p, FACE_RESULT *pFace)
+{
+    pFace->authResult.auth = (short)(p[0] + (p[1]<<8));
+    pFace->authResult.confidence = (short)(p[2] + (p[3]<<8));
+}
+
+/*----------------------------------------------------------------------------*/
+/* Per-face record, fields in wire order. This list is the only description   */
+/* of the record: the field table and the fast decoders are expanded from it. */
+/* X(flag, Execute size, ExecuteEx size, Execute decoder, ExecuteEx decoder)  */
+/*----------------------------------------------------------------------------*/
+#define HVC_FACE_FIELDS(X) \
+    X(HVC_ACTIV_FACE_DETECTION,         8, 8, HVC_DecodeFaceDetection, HVC_DecodeFaceDetection) \
+    X(HVC_ACTIV_FACE_DIRECTION,         8, 8, HVC_DecodeFaceDirection, HVC_DecodeFaceDirection) \
+    X(HVC_ACTIV_AGE_ESTIMATION,         3, 3, HVC_DecodeAge,           HVC_DecodeAge) \
+    X(HVC_ACTIV_GENDER_ESTIMATION,      3, 3, HVC_DecodeGender,        HVC_DecodeGender) \
+    X(HVC_ACTIV_GAZE_ESTIMATION,        2, 2, HVC_DecodeGaze,          HVC_DecodeGaze) \
+    X(HVC_ACTIV_BLINK_ESTIMATION,       4, 4, HVC_DecodeBlink,         HVC_DecodeBlink) \
+    X(HVC_ACTIV_EXPRESSION_ESTIMATION,  3, 6, HVC_DecodeExpression,    HVC_DecodeExpressionEx) \
+    X(HVC_ACTIV_FACE_RECOGNITION,       4, 4, HVC_DecodeRecognition,   HVC_DecodeRecognition) \
+    X(HVC_ACTIV_FACE_VERIFY,            4, 4, HVC_DecodeVerify,        HVC_DecodeVerify)
+
+typedef void (*HVC_FIELD_FUNC)(const UINT8 *p, FACE_RESULT *pFace);
+
+typedef struct {
+    INT32           flag;       /* HVC_ACTIV_* that makes the device send it */
+    INT32           size;       /* Bytes on the wire */
+    HVC_FIELD_FUNC  decode;
+} HVC_FACE_FIELD;
+
+#define HVC_FIELD_COUNT(flag, size, sizeEx, func, funcEx)   + 1
+#define HVC_FIELD_LARGER(flag, size, sizeEx, func, funcEx)  + (((size) > (sizeEx)) ? (size) : (sizeEx))
+#define HVC_FIELD_EXECUTE(flag, size, sizeEx, func, funcEx)     { flag, size, func },
+#define HVC_FIELD_EXECUTEEX(flag, size, sizeEx, func, funcEx)   { flag, sizeEx, funcEx },
+
+#define HVC_FACE_FIELD_NUM          (0 HVC_FACE_FIELDS(HVC_FIELD_COUNT))
+#define HVC_RESULT_FACE_SIZE_MAX    (0 HVC_FACE_FIELDS(HVC_FIELD_LARGER))
+/* Everything in an Execute response except the image pixels */
+#define HVC_RESULT_SIZE_MAX         (HVC_RESULT_COUNT_SIZE + \
+                                     HVC_RESULT_DETECT_MAX * HVC_RESULT_DETECT_SIZE * 2 + \
+                                     HVC_RESULT_DETECT_MAX * HVC_RESULT_FACE_SIZE_MAX + \
+                                     HVC_RESULT_IMAGE_HEAD_SIZE)
+/* Longest Execute response: the results and a QVGA image */
+#define HVC_RESULT_RESPONSE_MAX     (HVC_RESULT_SIZE_MAX + 320*240)
+
+static const HVC_FACE_FIELD m_faceField[HVC_RESULT_FORMAT_NUM][HVC_FACE_FIELD_NUM] = {
+    { HVC_FACE_FIELDS(HVC_FIELD_EXECUTE) },
+    { HVC_FACE_FIELDS(HVC_FIELD_EXECUTEEX) }
+};
+
+/*----------------------------------------------------------------------------*/
+/* Decoders of complete face records. HVC_DecodeFaces() takes the flags at   */
+/* run time; the others are the same loop with the flags of the function     */
+/* sets in regular use (ExecuteEx) fixed at compile time, so the compiler    */
+/* drops the flag tests and a record decodes straight through.               */
+/* param    : const UINT8   *p          complete face records                 */
+/*          : INT32         inNum       number of records                     */
+/*          : FACE_RESULT   *pFace      first face to fill                    */
+/*          : INT32         inExec      executable function                   */
+/*          : INT32         inFormat    HVC_RESULT_FORMAT_*                   */
+/*----------------------------------------------------------------------------*/
+typedef void (*HVC_FACES_FUNC)(const UINT8 *p, INT32 inNum, FACE_RESULT *pFace, INT32 inExec, INT32 inFormat);
+
+#define HVC_FIELD_DECODE(flag, size, sizeEx, func, funcEx) \
+    if ( (faceExec & (flag)) != 0 ) { \
+        if ( faceFormat == HVC_RESULT_FORMAT_EXECUTEEX ) { funcEx(p, pFace); p += (sizeEx); } \
+        else { func(p, pFace); p += (size); } \
+    }
+
+#define HVC_DEFINE_FACES_FUNC(name, exec, format) \
+static void name(const UINT8 *p, INT32 inNum, FACE_RESULT *pFace, INT32 inExec, INT32 inFormat) \
+{ \
+    const INT32 faceExec = (exec); \
+    const INT32 faceFormat = (format); \
+    INT32 i; \
+    (void)inExec; \
+    (void)inFormat; \
+    for ( i = 0; i < inNum; i++, pFace++ ) { \
+        HVC_FACE_FIELDS(HVC_FIELD_DECODE) \
+    } \
+}
+
+HVC_DEFINE_FACES_FUNC(HVC_DecodeFaces, inExec, inFormat)
+
+/* Detection/Estimation */
+#define HVC_FAST_ESTIMATION     (HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION | \
+                                 HVC_ACTIV_AGE_ESTIMATION | HVC_ACTIV_GENDER_ESTIMATION | \
+                                 HVC_ACTIV_GAZE_ESTIMATION | HVC_ACTIV_BLINK_ESTIMATION | \
+                                 HVC_ACTIV_EXPRESSION_ESTIMATION)
+/* Recognition (Identify), with and without direction for STB */
+#define HVC_FAST_IDENTIFY_DIR   (HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION | HVC_ACTIV_FACE_RECOGNITION)
+#define HVC_FAST_IDENTIFY       (HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_RECOGNITION)
+/* Recognition (Verify) */
+#define HVC_FAST_VERIFY         (HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_VERIFY)
+
+HVC_DEFINE_FACES_FUNC(HVC_DecodeFacesEstimation, HVC_FAST_ESTIMATION, HVC_RESULT_FORMAT_EXECUTEEX)
+HVC_DEFINE_FACES_FUNC(HVC_DecodeFacesIdentifyDir, HVC_FAST_IDENTIFY_DIR, HVC_RESULT_FORMAT_EXECUTEEX)
+HVC_DEFINE_FACES_FUNC(HVC_DecodeFacesIdentify, HVC_FAST_IDENTIFY, HVC_RESULT_FORMAT_EXECUTEEX)
+HVC_DEFINE_FACES_FUNC(HVC_DecodeFacesVerify, HVC_FAST_VERIFY, HVC_RESULT_FORMAT_EXECUTEEX)
+
+/* Face bits of inExec; body and hand detection do not touch the record */
+#define HVC_FIELD_FLAG(flag, size, sizeEx, func, funcEx)    | (flag)
+#define HVC_ACTIV_FACE_MASK     (0 HVC_FACE_FIELDS(HVC_FIELD_FLAG))
+
+static const struct {
+    INT32           exec;
+    HVC_FACES_FUNC  func;
+} m_fastFaces[] = {
+    { HVC_FAST_ESTIMATION,      HVC_DecodeFacesEstimation },
+    { HVC_FAST_IDENTIFY_DIR,    HVC_DecodeFacesIdentifyDir },
+    { HVC_FAST_IDENTIFY,        HVC_DecodeFacesIdentify },
+    { HVC_FAST_VERIFY,          HVC_DecodeFacesVerify },
+};
+
+/*----------------------------------------------------------------------------*/
+/* Field plan of one frame: the fields sent for inExec, in wire order         */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    INT32           num;
+    INT32           recordSize;             /* Bytes per face */
+    INT32           exec;
+    INT32           format;
+    HVC_FACES_FUNC  decode;                 /* Complete records */
+    const HVC_FACE_FIELD *field[HVC_FACE_FIELD_NUM];    /* Truncated record */
+} HVC_FACE_PLAN;
+
+static void HVC_MakeFacePlan(INT32 inExec, INT32 inFormat, HVC_FACE_PLAN *outPlan)
+{
+    const HVC_FACE_FIELD *pField = m_faceField[inFormat];
     int i;
-    INT32 ret = 0;
-    INT32 size = 0;
-    UINT8 sendData[32];
-    UINT8 recvData[32];
 
-    if((NULL == outHVCResult) || (NULL == outStatus)){
-        return HVC_ERROR_PARAMETER;
+    outPlan->num = 0;
+    outPlan->recordSize = 0;
+    outPlan->exec = inExec;
+    outPlan->format = inFormat;
+    outPlan->decode = HVC_DecodeFaces;
+    for ( i = 0; i < HVC_FACE_FIELD_NUM; i++ ) {
+        if ( inExec & pField[i].flag ) {
+            outPlan->field[outPlan->num++] = &pField[i];
+            outPlan->recordSize += pField[i].size;
+        }
     }
+    if ( inFormat == HVC_RESULT_FORMAT_EXECUTEEX ) {
+        for ( i = 0; i < (int)(sizeof(m_fastFaces)/sizeof(m_fastFaces[0])); i++ ) {
+            if ( (inExec & HVC_ACTIV_FACE_MASK) == m_fastFaces[i].exec ) {
+                outPlan->decode = m_fastFaces[i].func;
+                break;
+            }
+        }
+    }
+}
 
-    /* Send Execute command signal */
-    sendData[0] = (UINT8)(inExec&0xff);
-    sendData[1] = (UINT8)((inExec>>8)&0xff);
-    sendData[2] = (UINT8)(inImage&0xff);
-    ret = HVC_SendCommand(HVC_COM_EXECUTE, sizeof(UINT8)*3, sendData);
-    if ( ret != 0 ) return ret;
+/* Clamp a count from the device to the size of the result arrays */
+static INT32 HVC_GetDetectCount(UINT8 inCount)
+{
+    return (inCount > HVC_RESULT_DETECT_MAX) ? HVC_RESULT_DETECT_MAX : inCount;
+}
 
-    /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
-    if ( ret != 0 ) return ret;
+/* Body or hand detection */
+static void HVC_DecodeDetect(const UINT8 *p, DETECT_RESULT *pResult)
+{
+    pResult->posX = (short)(p[0] + (p[1]<<8));
+    pResult->posY = (short)(p[2] + (p[3]<<8));
+    pResult->size = (short)(p[4] + (p[5]<<8));
+    pResult->confidence = (short)(p[6] + (p[7]<<8));
+}
 
-    /* Receive result data */
-    if ( size >= (INT32)sizeof(UINT8)*4 ) {
+/*----------------------------------------------------------------------------*/
+/* Decode Execute/ExecuteEx result data from memory                           */
+/* param    : const UINT8   *inData         received result data              */
+/*          : INT32         inSize          bytes in inData                   */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_FACE_PLAN *inPlan         face fields for inExec            */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/* return   : INT32                         bytes decoded                     */
+/* A field is only decoded if all of its bytes are in inData.                 */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_DecodeResult(const UINT8 *inData, INT32 inSize, INT32 inExec, INT32 inImage,
+                              const HVC_FACE_PLAN *inPlan, HVC_RESULT *outHVCResult)
+{
+    const UINT8 *p = inData;
+    INT32 size = inSize;
+    FACE_RESULT *pFace;
+    INT32 nFull;
+    int i, k;
+
+    /* Result counts */
+    if ( size >= HVC_RESULT_COUNT_SIZE ) {
         outHVCResult->executedFunc = inExec;
-        ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-        outHVCResult->bdResult.num = recvData[0];
-        outHVCResult->hdResult.num = recvData[1];
-        outHVCResult->fdResult.num = recvData[2];
-        if ( ret != 0 ) return ret;
-        size -= sizeof(UINT8)*4;
+        outHVCResult->bdResult.num = HVC_GetDetectCount(p[0]);
+        outHVCResult->hdResult.num = HVC_GetDetectCount(p[1]);
+        outHVCResult->fdResult.num = HVC_GetDetectCount(p[2]);
+        p += HVC_RESULT_COUNT_SIZE;
+        size -= HVC_RESULT_COUNT_SIZE;
     }
 
-    /* Get Human Body Detection result */
-    for(i = 0; i < outHVCResult->bdResult.num; i++){
-        if ( size >= (INT32)sizeof(UINT8)*8 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-            outHVCResult->bdResult.bdResult[i].posX = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->bdResult.bdResult[i].posY = (short)(recvData[2] + (recvData[3]<<8));
-            outHVCResult->bdResult.bdResult[i].size = (short)(recvData[4] + (recvData[5]<<8));
-            outHVCResult->bdResult.bdResult[i].confidence = (short)(recvData[6] + (recvData[7]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*8;
-        }
+    /* Human Body Detection result */
+    for(i = 0; i < outHVCResult->bdResult.num && size >= HVC_RESULT_DETECT_SIZE; i++){
+        HVC_DecodeDetect(p, &outHVCResult->bdResult.bdResult[i]);
+        p += HVC_RESULT_DETECT_SIZE;
+        size -= HVC_RESULT_DETECT_SIZE;
     }
 
-    /* Get Hand Detection result */
-    for(i = 0; i < outHVCResult->hdResult.num; i++){
-        if ( size >= (INT32)sizeof(UINT8)*8 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-            outHVCResult->hdResult.hdResult[i].posX = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->hdResult.hdResult[i].posY = (short)(recvData[2] + (recvData[3]<<8));
-            outHVCResult->hdResult.hdResult[i].size = (short)(recvData[4] + (recvData[5]<<8));
-            outHVCResult->hdResult.hdResult[i].confidence = (short)(recvData[6] + (recvData[7]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*8;
-        }
+    /* Hand Detection result */
+    for(i = 0; i < outHVCResult->hdResult.num && size >= HVC_RESULT_DETECT_SIZE; i++){
+        HVC_DecodeDetect(p, &outHVCResult->hdResult.hdResult[i]);
+        p += HVC_RESULT_DETECT_SIZE;
+        size -= HVC_RESULT_DETECT_SIZE;
     }
 
-    /* Face-related results */
-    for(i = 0; i < outHVCResult->fdResult.num; i++){
-        /* Face Detection result */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION)){
-            if ( size >= (INT32)sizeof(UINT8)*8 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-                outHVCResult->fdResult.fcResult[i].dtResult.posX = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.posY = (short)(recvData[2] + (recvData[3]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.size = (short)(recvData[4] + (recvData[5]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.confidence = (short)(recvData[6] + (recvData[7]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*8;
+    /* Face-related results: complete records first, without size checks */
+    pFace = outHVCResult->fdResult.fcResult;
+    nFull = outHVCResult->fdResult.num;
+    if ( inPlan->recordSize == 0 ) {
+        nFull = 0;      /* No face fields requested */
+    }
+    else if ( nFull > size / inPlan->recordSize ) {
+        nFull = size / inPlan->recordSize;
+    }
+    inPlan->decode(p, nFull, pFace, inPlan->exec, inPlan->format);
+    p += nFull * inPlan->recordSize;
+    size -= nFull * inPlan->recordSize;
+    /* A truncated response: whatever fields still fit */
+    for ( i = nFull; i < outHVCResult->fdResult.num && inPlan->num > 0; i++ ) {
+        for ( k = 0; k < inPlan->num; k++ ) {
+            if ( size >= inPlan->field[k]->size ) {
+                inPlan->field[k]->decode(p, &pFace[i]);
+                p += inPlan->field[k]->size;
+                size -= inPlan->field[k]->size;
             }
         }
+    }
 
-        /* Face direction */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_DIRECTION)){
-            if ( size >= (INT32)sizeof(UINT8)*8 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-                outHVCResult->fdResult.fcResult[i].dirResult.yaw = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.pitch = (short)(recvData[2] + (recvData[3]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.roll = (short)(recvData[4] + (recvData[5]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.confidence = (short)(recvData[6] + (recvData[7]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*8;
-            }
-        }
+    /* Image size (the pixels are received separately) */
+    if ( HVC_EXECUTE_IMAGE_NONE != inImage && size >= HVC_RESULT_IMAGE_HEAD_SIZE ) {
+        outHVCResult->image.width = (short)(p[0] + (p[1]<<8));
+        outHVCResult->image.height = (short)(p[2] + (p[3]<<8));
+        p += HVC_RESULT_IMAGE_HEAD_SIZE;
+        size -= HVC_RESULT_IMAGE_HEAD_SIZE;
+    }
 
-        /* Age */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_AGE_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*3 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*3, recvData);
-                outHVCResult->fdResult.fcResult[i].ageResult.age = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].ageResult.confidence = (short)(recvData[1] + (recvData[2]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*3;
-            }
-        }
+    return inSize - size;
+}
 
-        /* Gender */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_GENDER_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*3 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*3, recvData);
-                outHVCResult->fdResult.fcResult[i].genderResult.gender = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].genderResult.confidence = (short)(recvData[1] + (recvData[2]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*3;
-            }
-        }
+/*----------------------------------------------------------------------------*/
+/* Size of the results in front of the image pixels                           */
+/* param    : const UINT8   *inCounts       result counts (4 bytes)           */
+/*          : INT32         inRecordSize    bytes per face                    */
+/*          : INT32         inSize          data length from the header       */
+/* return   : INT32                         counts, results and image size    */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_GetResultSize(const UINT8 *inCounts, INT32 inRecordSize, INT32 inSize)
+{
+    INT32 size = HVC_RESULT_COUNT_SIZE +
+                 (HVC_GetDetectCount(inCounts[0]) + HVC_GetDetectCount(inCounts[1])) * HVC_RESULT_DETECT_SIZE +
+                 HVC_GetDetectCount(inCounts[2]) * inRecordSize +
+                 HVC_RESULT_IMAGE_HEAD_SIZE;
 
-        /* Gaze */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_GAZE_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*2 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*2, recvData);
-                outHVCResult->fdResult.fcResult[i].gazeResult.gazeLR = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].gazeResult.gazeUD = (char)(recvData[1]);
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*2;
-            }
-        }
+    return (size > inSize) ? inSize : size;
+}
 
-        /* Blink */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_BLINK_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].blinkResult.ratioL = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].blinkResult.ratioR = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
-            }
-        }
+/*----------------------------------------------------------------------------*/
+/* Receive the results (up to the image size) behind the bytes already in     */
+/* ioData, and decode them                                                    */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : UINT8         *ioData         result buffer                     */
+/*          : INT32         inRecvSize      bytes already in ioData           */
+/*          : INT32         inResultSize    bytes of results                  */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_FACE_PLAN *inPlan         face fields for inExec            */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : INT32         *ioSize         response data left                */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -21...invalid image size          */
+/*          :                               -22...timeout error               */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_ReceiveResultData(HVC_HANDLE inHandle, UINT32 inDeadline, UINT8 *ioData, INT32 inRecvSize,
+                                   INT32 inResultSize, INT32 inExec, INT32 inImage, const HVC_FACE_PLAN *inPlan,
+                                   HVC_RESULT *outHVCResult, INT32 *ioSize)
+{
+    INT32 ret = 0;
 
-        /* Expression */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_EXPRESSION_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*3 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*3, recvData);
-                outHVCResult->fdResult.fcResult[i].expressionResult.topExpression = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].expressionResult.topScore = (char)(recvData[1]);
-                outHVCResult->fdResult.fcResult[i].expressionResult.degree = (char)(recvData[2]);
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*3;
-            }
-        }
+    ret = HVC_ReceiveData(inHandle, inDeadline, inResultSize - inRecvSize, &ioData[inRecvSize]);
+    if ( ret != 0 ) return ret;
+    *ioSize -= HVC_DecodeResult(ioData, inResultSize, inExec, inImage, inPlan, outHVCResult);
 
-        /* Face Recognition */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_RECOGNITION)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].recognitionResult.uid = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].recognitionResult.confidence = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
-            }
-        }
+    if ( HVC_EXECUTE_IMAGE_NONE != inImage &&
+         (INT32)sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height > (INT32)sizeof(outHVCResult->image.image) ) {
+        /* Larger than any image the device sends */
+        return HVC_ERROR_HEADER_INVALID;
+    }
+    return 0;
+}
 
-        /* Face Verify */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_VERIFY)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].authResult.auth = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].authResult.confidence = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
+/*----------------------------------------------------------------------------*/
+/* Receive and decode Execute/ExecuteEx result data                           */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the command      */
+/*          : INT32         inSize          data length from the header       */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : INT32         inFormat        HVC_RESULT_FORMAT_*               */
+/*          : HVC_PROGRESS  *inProgress     callbacks (NULL...none)           */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -21...invalid image size          */
+/*          :                               -22...timeout error               */
+/* The results are received with one call and decoded from memory; only the  */
+/* count header (when an image follows) and the image pixels, which go        */
+/* straight to outHVCResult, take a call of their own. With inProgress the    */
+/* pixels are received a chunk of rows per call instead, and a count hook     */
+/* has the counts received on their own even when no image follows.           */
+/*----------------------------------------------------------------------------*/
+/* Pass the 4 count bytes of a response to the count hook, if there is one */
+static void HVC_NotifyCounts(HVC_COUNT_FUNC inCountFunc, void *pParam, const UINT8 *inCounts)
+{
+    if ( NULL == inCountFunc ) return;
+    inCountFunc(pParam, HVC_GetDetectCount(inCounts[0]), HVC_GetDetectCount(inCounts[1]),
+                HVC_GetDetectCount(inCounts[2]));
+}
+
+static INT32 HVC_ReceiveResult(HVC_HANDLE inHandle, UINT32 inDeadline, INT32 inSize, INT32 inExec, INT32 inImage,
+                               INT32 inFormat, const HVC_PROGRESS *inProgress, HVC_RESULT *outHVCResult)
+{
+    INT32 ret = 0;
+    INT32 resultSize;
+    INT32 recvSize = 0;
+    INT32 imageSize;
+    INT32 width, height;
+    INT32 row, rowNum, rowChunk;
+    UINT8 recvData[HVC_RESULT_SIZE_MAX];
+    HVC_FACE_PLAN plan;
+
+    HVC_MakeFacePlan(inExec, inFormat, &plan);
+    recvData[0] = 0;        /* An empty response is decoded from here as well */
+
+    if((HVC_EXECUTE_IMAGE_NONE == inImage) && ((NULL == inProgress) || (NULL == inProgress->pCountFunc))){
+        /* Nothing but results: the whole payload at once */
+        resultSize = (inSize < HVC_RESULT_SIZE_MAX) ? inSize : HVC_RESULT_SIZE_MAX;
+    }
+    else{
+        /* The counts tell where the results end and the image begins, */
+        /* and are all the count hook needs                             */
+        resultSize = (inSize < HVC_RESULT_COUNT_SIZE) ? inSize : HVC_RESULT_COUNT_SIZE;
+        ret = HVC_ReceiveData(inHandle, inDeadline, resultSize, recvData);
+        if ( ret != 0 ) return ret;
+        recvSize = resultSize;
+        if ( recvSize == HVC_RESULT_COUNT_SIZE ) {
+            if ( NULL != inProgress ) {
+                HVC_NotifyCounts(inProgress->pCountFunc, inProgress->pParam, recvData);
+            }
+            if(HVC_EXECUTE_IMAGE_NONE == inImage){
+                resultSize = (inSize < HVC_RESULT_SIZE_MAX) ? inSize : HVC_RESULT_SIZE_MAX;
+            }
+            else{
+                resultSize = HVC_GetResultSize(recvData, plan.recordSize, inSize);
             }
         }
     }
 
+    ret = HVC_ReceiveResultData(inHandle, inDeadline, recvData, recvSize, resultSize, inExec, inImage, &plan,
+                                outHVCResult, &inSize);
+    if ( ret != 0 ) return ret;
+
+    if ( (NULL != inProgress) && (NULL != inProgress->pResultFunc) ) {
+        inProgress->pResultFunc(inProgress->pParam, outHVCResult);
+    }
+
     if(HVC_EXECUTE_IMAGE_NONE != inImage){
         /* Image data */
-        if ( size >= (INT32)sizeof(UINT8)*4 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-            outHVCResult->image.width = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->image.height = (short)(recvData[2] + (recvData[3]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*4;
+        width = outHVCResult->image.width;
+        height = outHVCResult->image.height;
+        imageSize = (INT32)sizeof(UINT8)*width*height;
+        if ( inSize < imageSize ) return 0;
+        if ( NULL == inProgress ) {
+            return HVC_ReceiveData(inHandle, inDeadline, imageSize, outHVCResult->image.image);
         }
-
-        if ( size >= (INT32)sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height, outHVCResult->image.image);
+        /* Whole rows only, so a callback never sees half a row */
+        rowChunk = (inProgress->rowChunk > 0) ? inProgress->rowChunk : HVC_PROGRESS_ROW_CHUNK;
+        for ( row = 0; row < height; row += rowNum ) {
+            rowNum = (height - row < rowChunk) ? height - row : rowChunk;
+            ret = HVC_ReceiveData(inHandle, inDeadline, rowNum*width, &outHVCResult->image.image[row*width]);
             if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height;
+            if ( NULL != inProgress->pRowFunc ) {
+                inProgress->pRowFunc(inProgress->pParam, outHVCResult, row, rowNum);
+            }
         }
     }
 
@@ -520,10 +975,30 @@ INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *
 }
 
 /*----------------------------------------------------------------------------*/
-/* HVC_ExecuteEx                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* HVC_Execute                                                                */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_Execute(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+{
+    return HVC_ExecuteProgressive(inHandle, inTimeOutTime, inExec, inImage, NULL, outHVCResult, outStatus);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteProgressive                                                     */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inExec          executable function               */
 /*          : INT32         inImage         image info                        */
+/*          : HVC_PROGRESS  *inProgress     callbacks (NULL...none)           */
 /*          : HVC_RESULT    *outHVCResult   result data                       */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -531,13 +1006,13 @@ INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+INT32 HVC_ExecuteProgressive(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                             const HVC_PROGRESS *inProgress, HVC_RESULT *outHVCResult, UINT8 *outStatus)
 {
-    int i, j;
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
-    UINT8 recvData[32];
 
     if((NULL == outHVCResult) || (NULL == outStatus)){
         return HVC_ERROR_PARAMETER;
@@ -547,187 +1022,538 @@ INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT
     sendData[0] = (UINT8)(inExec&0xff);
     sendData[1] = (UINT8)((inExec>>8)&0xff);
     sendData[2] = (UINT8)(inImage&0xff);
-    ret = HVC_SendCommand(HVC_COM_EXECUTEEX, sizeof(UINT8)*3, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_EXECUTE, sizeof(UINT8)*3, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, HVC_RESULT_RESPONSE_MAX, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     /* Receive result data */
-    if ( size >= (INT32)sizeof(UINT8)*4 ) {
-        outHVCResult->executedFunc = inExec;
-        ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-        outHVCResult->bdResult.num = recvData[0];
-        outHVCResult->hdResult.num = recvData[1];
-        outHVCResult->fdResult.num = recvData[2];
-        if ( ret != 0 ) return ret;
-        size -= sizeof(UINT8)*4;
-    }
+    return HVC_ReceiveResult(inHandle, deadline, size, inExec, inImage, HVC_RESULT_FORMAT_EXECUTE, inProgress,
+                             outHVCResult);
+}
 
-    /* Get Human Body Detection result */
-    for(i = 0; i < outHVCResult->bdResult.num; i++){
-        if ( size >= (INT32)sizeof(UINT8)*8 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-            outHVCResult->bdResult.bdResult[i].posX = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->bdResult.bdResult[i].posY = (short)(recvData[2] + (recvData[3]<<8));
-            outHVCResult->bdResult.bdResult[i].size = (short)(recvData[4] + (recvData[5]<<8));
-            outHVCResult->bdResult.bdResult[i].confidence = (short)(recvData[6] + (recvData[7]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*8;
-        }
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteEx                                                              */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteEx(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+{
+    return HVC_ExecuteExProgressive(inHandle, inTimeOutTime, inExec, inImage, NULL, outHVCResult, outStatus);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteExProgressive                                                   */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_PROGRESS  *inProgress     callbacks (NULL...none)           */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteExProgressive(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                               const HVC_PROGRESS *inProgress, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+{
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
+    INT32 ret = 0;
+    INT32 size = 0;
+    UINT8 sendData[32];
+
+    if((NULL == outHVCResult) || (NULL == outStatus)){
+        return HVC_ERROR_PARAMETER;
     }
 
-    /* Get Hand Detection result */
-    for(i = 0; i < outHVCResult->hdResult.num; i++){
-        if ( size >= (INT32)sizeof(UINT8)*8 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-            outHVCResult->hdResult.hdResult[i].posX = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->hdResult.hdResult[i].posY = (short)(recvData[2] + (recvData[3]<<8));
-            outHVCResult->hdResult.hdResult[i].size = (short)(recvData[4] + (recvData[5]<<8));
-            outHVCResult->hdResult.hdResult[i].confidence = (short)(recvData[6] + (recvData[7]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*8;
-        }
+    /* Send Execute command signal */
+    sendData[0] = (UINT8)(inExec&0xff);
+    sendData[1] = (UINT8)((inExec>>8)&0xff);
+    sendData[2] = (UINT8)(inImage&0xff);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_EXECUTEEX, sizeof(UINT8)*3, sendData);
+    if ( ret != 0 ) return ret;
+
+    /* Receive header */
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, HVC_RESULT_RESPONSE_MAX, &size, outStatus);
+    if ( ret != 0 ) return ret;
+
+    /* Receive result data */
+    return HVC_ReceiveResult(inHandle, deadline, size, inExec, inImage, HVC_RESULT_FORMAT_EXECUTEEX, inProgress,
+                             outHVCResult);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Asynchronous ExecuteEx                                                     */
+/* The response is taken in the same steps as HVC_ReceiveResult(), but a     */
+/* step only runs once all of its bytes are buffered, so no receive waits.    */
+/*----------------------------------------------------------------------------*/
+enum {
+    HVC_ASYNC_HEADER = 0,       /* Response header */
+    HVC_ASYNC_COUNTS,           /* Result counts (an image or a count hook follows) */
+    HVC_ASYNC_RESULTS,          /* Results and image size */
+    HVC_ASYNC_IMAGE,            /* Image pixels */
+    HVC_ASYNC_DONE
+};
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteExBegin                                                         */
+/* param    : HVC_ASYNC     *outAsync       command state                     */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...sent, poll for the response   */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteExBegin(HVC_ASYNC *outAsync, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                         HVC_RESULT *outHVCResult, UINT8 *outStatus)
+{
+    INT32 ret = 0;
+    UINT8 sendData[32];
+
+    if((NULL == outAsync) || (NULL == outHVCResult) || (NULL == outStatus)){
+        return HVC_ERROR_PARAMETER;
     }
 
-    /* Face-related results */
-    for(i = 0; i < outHVCResult->fdResult.num; i++){
-        /* Face Detection result */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION)){
-            if ( size >= (INT32)sizeof(UINT8)*8 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-                outHVCResult->fdResult.fcResult[i].dtResult.posX = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.posY = (short)(recvData[2] + (recvData[3]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.size = (short)(recvData[4] + (recvData[5]<<8));
-                outHVCResult->fdResult.fcResult[i].dtResult.confidence = (short)(recvData[6] + (recvData[7]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*8;
-            }
-        }
+    outAsync->handle = inHandle;
+    outAsync->deadline = HVC_GetDeadline(inTimeOutTime);
+    outAsync->exec = inExec;
+    outAsync->image = inImage;
+    outAsync->state = HVC_ASYNC_HEADER;
+    outAsync->ret = 0;
+    outAsync->dataSize = 0;
+    outAsync->waitSize = RECEIVE_HEAD_NUM;
+    outAsync->headerSize = 0;
+    outAsync->headerSkip = 0;
+    outAsync->countSize = 0;
+    outAsync->pResult = outHVCResult;
+    outAsync->pStatus = outStatus;
+    outAsync->pCountFunc = NULL;
+    outAsync->pCountParam = NULL;
 
-        /* Face direction */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_DIRECTION)){
-            if ( size >= (INT32)sizeof(UINT8)*8 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*8, recvData);
-                outHVCResult->fdResult.fcResult[i].dirResult.yaw = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.pitch = (short)(recvData[2] + (recvData[3]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.roll = (short)(recvData[4] + (recvData[5]<<8));
-                outHVCResult->fdResult.fcResult[i].dirResult.confidence = (short)(recvData[6] + (recvData[7]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*8;
-            }
-        }
+    /* Send Execute command signal */
+    sendData[0] = (UINT8)(inExec&0xff);
+    sendData[1] = (UINT8)((inExec>>8)&0xff);
+    sendData[2] = (UINT8)(inImage&0xff);
+    ret = HVC_SendCommand(inHandle, outAsync->deadline, HVC_COM_EXECUTEEX, sizeof(UINT8)*3, sendData);
+    if ( ret != 0 ) {
+        outAsync->state = HVC_ASYNC_DONE;
+        outAsync->ret = ret;
+    }
+    return ret;
+}
 
-        /* Age */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_AGE_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*3 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*3, recvData);
-                outHVCResult->fdResult.fcResult[i].ageResult.age = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].ageResult.confidence = (short)(recvData[1] + (recvData[2]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*3;
-            }
-        }
+/* Ends the command; later polls keep returning inRet */
+static INT32 HVC_AsyncFinish(HVC_ASYNC *ioAsync, INT32 inRet)
+{
+    ioAsync->state = HVC_ASYNC_DONE;
+    ioAsync->ret = inRet;
+    return inRet;
+}
 
-        /* Gender */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_GENDER_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*3 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*3, recvData);
-                outHVCResult->fdResult.fcResult[i].genderResult.gender = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].genderResult.confidence = (short)(recvData[1] + (recvData[2]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*3;
+/*----------------------------------------------------------------------------*/
+/* Advance an asynchronous ExecuteEx                                          */
+/* param    : HVC_ASYNC     *ioAsync        command state                     */
+/*          : INT32         inWait          0...return when data is missing   */
+/*          :                               1...wait for it (up to deadline)  */
+/* return   : INT32                         as HVC_ExecuteExPoll()            */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_AsyncStep(HVC_ASYNC *ioAsync, INT32 inWait)
+{
+    INT32 ret = 0;
+    INT32 size = 0;
+    INT32 imageSize;
+    UINT8 recvData[HVC_RESULT_SIZE_MAX];
+    HVC_FACE_PLAN plan;
+
+    while ( ioAsync->state != HVC_ASYNC_DONE ) {
+        if ( !inWait && UART_GetReceiveSize(ioAsync->handle) < ioAsync->waitSize ) {
+            if ( HVC_GetRemainingTime(ioAsync->deadline) > 0 ) {
+                return HVC_PENDING;
             }
+            /* Out of time: take what is there, the receive reports the timeout */
         }
 
-        /* Gaze */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_GAZE_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*2 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*2, recvData);
-                outHVCResult->fdResult.fcResult[i].gazeResult.gazeLR = (char)(recvData[0]);
-                outHVCResult->fdResult.fcResult[i].gazeResult.gazeUD = (char)(recvData[1]);
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*2;
+        switch ( ioAsync->state ) {
+        case HVC_ASYNC_HEADER:
+            /* One try per step; after bytes that are no header, the next step */
+            /* waits until the header bytes still missing have arrived          */
+            ret = HVC_ReceiveHeaderStep(ioAsync->handle, ioAsync->deadline, 0, HVC_RESULT_RESPONSE_MAX,
+                                        ioAsync->header, &ioAsync->headerSize, &ioAsync->headerSkip,
+                                        &size, ioAsync->pStatus);
+            if ( ret == HVC_PENDING ) {
+                ioAsync->waitSize = RECEIVE_HEAD_NUM - ioAsync->headerSize;
+                break;
             }
-        }
-
-        /* Blink */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_BLINK_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].blinkResult.ratioL = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].blinkResult.ratioR = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
+            if ( ret != 0 ) return HVC_AsyncFinish(ioAsync, ret);
+            ioAsync->dataSize = size;
+            if ( (HVC_EXECUTE_IMAGE_NONE == ioAsync->image) && (NULL == ioAsync->pCountFunc) ) {
+                ioAsync->state = HVC_ASYNC_RESULTS;
+                ioAsync->waitSize = (size < HVC_RESULT_SIZE_MAX) ? size : HVC_RESULT_SIZE_MAX;
             }
-        }
-
-        /* Expression */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_EXPRESSION_ESTIMATION)){
-            if ( size >= (INT32)sizeof(UINT8)*6 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*6, recvData);
-                outHVCResult->fdResult.fcResult[i].expressionResult.topExpression = -128;
-                outHVCResult->fdResult.fcResult[i].expressionResult.topScore = -128;
-                for(j = 0; j < 5; j++){
-                    outHVCResult->fdResult.fcResult[i].expressionResult.score[j] = (char)(recvData[j]);
-                    if(outHVCResult->fdResult.fcResult[i].expressionResult.topScore < outHVCResult->fdResult.fcResult[i].expressionResult.score[j]){
-                        outHVCResult->fdResult.fcResult[i].expressionResult.topScore = outHVCResult->fdResult.fcResult[i].expressionResult.score[j];
-                        outHVCResult->fdResult.fcResult[i].expressionResult.topExpression = j + 1;
-                    }
+            else {
+                ioAsync->state = HVC_ASYNC_COUNTS;
+                ioAsync->waitSize = (size < HVC_RESULT_COUNT_SIZE) ? size : HVC_RESULT_COUNT_SIZE;
+            }
+            break;
+
+        case HVC_ASYNC_COUNTS:
+            ret = HVC_ReceiveData(ioAsync->handle, ioAsync->deadline, ioAsync->waitSize, ioAsync->counts);
+            if ( ret != 0 ) return HVC_AsyncFinish(ioAsync, ret);
+            ioAsync->countSize = ioAsync->waitSize;
+            ioAsync->state = HVC_ASYNC_RESULTS;
+            ioAsync->waitSize = 0;
+            if ( ioAsync->countSize == HVC_RESULT_COUNT_SIZE ) {
+                HVC_NotifyCounts(ioAsync->pCountFunc, ioAsync->pCountParam, ioAsync->counts);
+                if ( HVC_EXECUTE_IMAGE_NONE == ioAsync->image ) {
+                    ioAsync->waitSize = ((ioAsync->dataSize < HVC_RESULT_SIZE_MAX) ?
+                                         ioAsync->dataSize : HVC_RESULT_SIZE_MAX) - HVC_RESULT_COUNT_SIZE;
+                }
+                else {
+                    HVC_MakeFacePlan(ioAsync->exec, HVC_RESULT_FORMAT_EXECUTEEX, &plan);
+                    ioAsync->waitSize = HVC_GetResultSize(ioAsync->counts, plan.recordSize, ioAsync->dataSize) -
+                                        HVC_RESULT_COUNT_SIZE;
                 }
-                outHVCResult->fdResult.fcResult[i].expressionResult.degree = (char)(recvData[5]);
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*6;
             }
-        }
-
-        /* Face Recognition */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_RECOGNITION)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].recognitionResult.uid = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].recognitionResult.confidence = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
+            break;
+
+        case HVC_ASYNC_RESULTS:
+            memcpy(recvData, ioAsync->counts, ioAsync->countSize);
+            HVC_MakeFacePlan(ioAsync->exec, HVC_RESULT_FORMAT_EXECUTEEX, &plan);
+            ret = HVC_ReceiveResultData(ioAsync->handle, ioAsync->deadline, recvData, ioAsync->countSize,
+                                        ioAsync->countSize + ioAsync->waitSize, ioAsync->exec, ioAsync->image, &plan,
+                                        ioAsync->pResult, &ioAsync->dataSize);
+            if ( ret != 0 || HVC_EXECUTE_IMAGE_NONE == ioAsync->image ) {
+                return HVC_AsyncFinish(ioAsync, ret);
             }
+            imageSize = (INT32)sizeof(UINT8)*ioAsync->pResult->image.width*ioAsync->pResult->image.height;
+            if ( ioAsync->dataSize < imageSize ) {
+                return HVC_AsyncFinish(ioAsync, 0);
+            }
+            ioAsync->state = HVC_ASYNC_IMAGE;
+            ioAsync->waitSize = imageSize;
+            break;
+
+        case HVC_ASYNC_IMAGE:
+            ret = HVC_ReceiveData(ioAsync->handle, ioAsync->deadline, ioAsync->waitSize, ioAsync->pResult->image.image);
+            return HVC_AsyncFinish(ioAsync, ret);
+
+        default:
+            return HVC_AsyncFinish(ioAsync, HVC_ERROR_PARAMETER);
         }
+    }
 
-        /* Face Verify */
-        if(0 != (outHVCResult->executedFunc & HVC_ACTIV_FACE_VERIFY)){
-            if ( size >= (INT32)sizeof(UINT8)*4 ) {
-                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-                outHVCResult->fdResult.fcResult[i].authResult.auth = (short)(recvData[0] + (recvData[1]<<8));
-                outHVCResult->fdResult.fcResult[i].authResult.confidence = (short)(recvData[2] + (recvData[3]<<8));
-                if ( ret != 0 ) return ret;
-                size -= sizeof(UINT8)*4;
-            }
+    return ioAsync->ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteExPoll                                                          */
+/* param    : HVC_ASYNC     *ioAsync        command state                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               1...response not complete yet     */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteExPoll(HVC_ASYNC *ioAsync)
+{
+    if(NULL == ioAsync){
+        return HVC_ERROR_PARAMETER;
+    }
+    return HVC_AsyncStep(ioAsync, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteExSetCountHook                                                  */
+/* param    : HVC_ASYNC     *ioAsync        command state                     */
+/*          : HVC_COUNT_FUNC inCountFunc    count hook (NULL...none)          */
+/*          : void          *pParam         hook parameter                    */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteExSetCountHook(HVC_ASYNC *ioAsync, HVC_COUNT_FUNC inCountFunc, void *pParam)
+{
+    if(NULL == ioAsync){
+        return HVC_ERROR_PARAMETER;
+    }
+    /* Too late once the counts are in */
+    if ( (HVC_ASYNC_HEADER != ioAsync->state) && (HVC_ASYNC_COUNTS != ioAsync->state) ) {
+        return HVC_ERROR_PARAMETER;
+    }
+    ioAsync->pCountFunc = inCountFunc;
+    ioAsync->pCountParam = pParam;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Streaming ExecuteEx                                                        */
+/* One frame is always in flight while the consumer works on the previous    */
+/* one. Every buffer is in exactly one place: in flight, queued (complete,   */
+/* not yet taken), held by the consumer, or free.                            */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_StreamFreeBuffer(const HVC_STREAM *inStream)
+{
+    INT32 i, j;
+
+    for ( i = 0; i < inStream->bufferNum; i++ ) {
+        if ( i == inStream->inFlight || i == inStream->held ) continue;
+        for ( j = 0; j < inStream->queueNum; j++ ) {
+            if ( inStream->queue[j] == i ) break;
         }
+        if ( j == inStream->queueNum ) return i;
+    }
+    return -1;
+}
+
+/* Queue a finished frame */
+static void HVC_StreamComplete(HVC_STREAM *ioStream, INT32 inBuffer, INT32 inRet)
+{
+    ioStream->ret[inBuffer] = inRet;
+    ioStream->queue[ioStream->queueNum++] = inBuffer;
+    if ( ioStream->inFlight == inBuffer ) ioStream->inFlight = -1;
+}
+
+/* Send the next Execute if the device is idle and a buffer is free */
+static void HVC_StreamIssue(HVC_STREAM *ioStream)
+{
+    INT32 ret = 0;
+    INT32 buffer;
+
+    if ( ioStream->inFlight >= 0 ) return;
+    buffer = HVC_StreamFreeBuffer(ioStream);
+    if ( buffer < 0 ) return;
+    if ( NULL != ioStream->pPool ) {
+        /* Wait for a consumer to release a frame */
+        ioStream->pBuffer[buffer] = HVC_FrameAcquire(ioStream->pPool);
+        if ( NULL == ioStream->pBuffer[buffer] ) return;
+    }
+
+    ioStream->inFlight = buffer;
+    ret = HVC_ExecuteExBegin(&ioStream->async, ioStream->handle, ioStream->timeOut, ioStream->exec, ioStream->image,
+                             ioStream->pBuffer[buffer], &ioStream->status[buffer]);
+    if ( ret != 0 ) HVC_StreamComplete(ioStream, buffer, ret);
+    else HVC_ExecuteExSetCountHook(&ioStream->async, ioStream->pCountFunc, ioStream->pCountParam);
+}
+
+/* Finish the frame in flight if its response is there (or wait for it) */
+static void HVC_StreamCollect(HVC_STREAM *ioStream, INT32 inWait)
+{
+    INT32 ret = 0;
+
+    if ( ioStream->inFlight < 0 ) return;
+    ret = HVC_AsyncStep(&ioStream->async, inWait);
+    if ( ret != HVC_PENDING ) HVC_StreamComplete(ioStream, ioStream->inFlight, ret);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_StreamStart                                                            */
+/* param    : HVC_STREAM    *outStream      stream state                      */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each frame (ms)   */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_RESULT    **inBuffers     frame buffers                     */
+/*          : INT32         inBufferNum     2...double, 3...triple buffered   */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_StreamStart(HVC_STREAM *outStream, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                      HVC_RESULT **inBuffers, INT32 inBufferNum)
+{
+    INT32 i;
+
+    if((NULL == outStream) || (NULL == inBuffers) ||
+       (inBufferNum < 2) || (inBufferNum > HVC_STREAM_BUFFER_MAX)){
+        return HVC_ERROR_PARAMETER;
+    }
+    for ( i = 0; i < inBufferNum; i++ ) {
+        if ( NULL == inBuffers[i] ) return HVC_ERROR_PARAMETER;
+        outStream->pBuffer[i] = inBuffers[i];
+    }
+
+    outStream->handle = inHandle;
+    outStream->timeOut = inTimeOutTime;
+    outStream->exec = inExec;
+    outStream->image = inImage;
+    outStream->bufferNum = inBufferNum;
+    outStream->pPool = NULL;
+    outStream->inFlight = -1;
+    outStream->held = -1;
+    outStream->queueNum = 0;
+    outStream->pCountFunc = NULL;
+    outStream->pCountParam = NULL;
+
+    HVC_StreamIssue(outStream);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_StreamStartPool                                                        */
+/* param    : HVC_STREAM    *outStream      stream state                      */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each frame (ms)   */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_FRAME_POOL *inPool        frame pool                        */
+/*          : INT32         inDepth         frames held by the stream         */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/* The buffer slots only track the frames the stream holds; a frame leaves    */
+/* its slot when HVC_StreamGet() hands it over.                               */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_StreamStartPool(HVC_STREAM *outStream, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                          HVC_FRAME_POOL *inPool, INT32 inDepth)
+{
+    if((NULL == outStream) || (NULL == inPool) ||
+       (inDepth < 1) || (inDepth > HVC_STREAM_BUFFER_MAX)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    outStream->handle = inHandle;
+    outStream->timeOut = inTimeOutTime;
+    outStream->exec = inExec;
+    outStream->image = inImage;
+    outStream->bufferNum = inDepth;
+    outStream->pPool = inPool;
+    outStream->inFlight = -1;
+    outStream->held = -1;
+    outStream->queueNum = 0;
+    outStream->pCountFunc = NULL;
+    outStream->pCountParam = NULL;
+
+    HVC_StreamIssue(outStream);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_StreamGet                                                              */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+/*          : INT32         inWait          0...return HVC_PENDING when no    */
+/*          :                               frame is complete, 1...wait       */
+/*          : HVC_RESULT    **outResult     frame, valid until the next call  */
+/*          :                               (pool: one reference, release it) */
+/*          : UINT8         *outStatus      response code of the frame        */
+/* return   : INT32                         execution result error code       */
+/*          :                               1...no frame complete yet         */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               -30...every frame of the pool is  */
+/*          :                               held, none can be received        */
+/*          :                               other...signal error of the frame */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_StreamGet(HVC_STREAM *ioStream, INT32 inWait, HVC_RESULT **outResult, UINT8 *outStatus)
+{
+    INT32 buffer;
+    INT32 ret;
+    INT32 i;
+
+    if((NULL == ioStream) || (NULL == outResult) || (NULL == outStatus)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    /* The consumer is done with the previous frame */
+    ioStream->held = -1;
+    HVC_StreamCollect(ioStream, 0);
+    HVC_StreamIssue(ioStream);
+
+    if ( ioStream->queueNum == 0 ) {
+        /* Nothing in flight either: the consumers hold the whole pool */
+        if ( ioStream->inFlight < 0 ) return HVC_ERROR_NO_FRAME;
+        if ( !inWait ) return HVC_PENDING;
+        HVC_StreamCollect(ioStream, 1);
+    }
+
+    buffer = ioStream->queue[0];
+    for ( i = 1; i < ioStream->queueNum; i++ ) {
+        ioStream->queue[i - 1] = ioStream->queue[i];
+    }
+    ioStream->queueNum--;
+    /* A pool frame is the caller's now, and its slot is free */
+    if ( NULL == ioStream->pPool ) ioStream->held = buffer;
+
+    *outResult = ioStream->pBuffer[buffer];
+    *outStatus = ioStream->status[buffer];
+    ret = ioStream->ret[buffer];
+
+    /* Keep the device busy while the consumer works on this frame */
+    HVC_StreamIssue(ioStream);
+
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_StreamStop                                                             */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/* Waits for the frame in flight, so the device is idle afterwards. Pool      */
+/* frames not handed over yet are released.                                   */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_StreamStop(HVC_STREAM *ioStream)
+{
+    if(NULL == ioStream){
+        return HVC_ERROR_PARAMETER;
     }
 
-    if(HVC_EXECUTE_IMAGE_NONE != inImage){
-        /* Image data */
-        if ( size >= (INT32)sizeof(UINT8)*4 ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
-            outHVCResult->image.width = (short)(recvData[0] + (recvData[1]<<8));
-            outHVCResult->image.height = (short)(recvData[2] + (recvData[3]<<8));
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*4;
-        }
-
-        if ( size >= (INT32)sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height, outHVCResult->image.image);
-            if ( ret != 0 ) return ret;
-            size -= sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height;
+    HVC_StreamCollect(ioStream, 1);
+    if ( NULL != ioStream->pPool ) {
+        /* Frames nobody has taken go back to the pool */
+        while ( ioStream->queueNum > 0 ) {
+            HVC_FrameRelease(ioStream->pBuffer[ioStream->queue[--ioStream->queueNum]]);
         }
     }
+    ioStream->held = -1;
+    ioStream->queueNum = 0;
+    return 0;
+}
 
+/*----------------------------------------------------------------------------*/
+/* HVC_StreamSetCountHook                                                     */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+/*          : HVC_COUNT_FUNC inCountFunc    count hook (NULL...none)          */
+/*          : void          *pParam         hook parameter                    */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_StreamSetCountHook(HVC_STREAM *ioStream, HVC_COUNT_FUNC inCountFunc, void *pParam)
+{
+    if(NULL == ioStream){
+        return HVC_ERROR_PARAMETER;
+    }
+    ioStream->pCountFunc = inCountFunc;
+    ioStream->pCountParam = pParam;
+    /* The frame in flight too, unless its counts are already in */
+    if ( ioStream->inFlight >= 0 ) {
+        HVC_ExecuteExSetCountHook(&ioStream->async, inCountFunc, pParam);
+    }
     return 0;
 }
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetThreshold                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_THRESHOLD *inThreshold    threshold values                  */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -735,8 +1561,9 @@ INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *outStatus)
+INT32 HVC_SetThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -754,11 +1581,11 @@ INT32 HVC_SetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *o
     sendData[6] = (UINT8)(inThreshold->rsThreshold&0xff);
     sendData[7] = (UINT8)((inThreshold->rsThreshold>>8)&0xff);
     /* Send SetThreshold command signal */
-    ret = HVC_SendCommand(HVC_COM_SET_THRESHOLD, sizeof(UINT8)*8, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_THRESHOLD, sizeof(UINT8)*8, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -766,7 +1593,8 @@ INT32 HVC_SetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *o
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetThreshold                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_THRESHOLD *outThreshold   threshold values                  */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -774,8 +1602,9 @@ INT32 HVC_SetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *o
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *outStatus)
+INT32 HVC_GetThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -785,19 +1614,15 @@ INT32 HVC_GetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *
     }
 
     /* Send GetThreshold command signal */
-    ret = HVC_SendCommand(HVC_COM_GET_THRESHOLD, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_THRESHOLD, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*8, sizeof(UINT8)*8, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*8 ) {
-        size = sizeof(UINT8)*8;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     outThreshold->bdThreshold = recvData[0] + (recvData[1]<<8);
     outThreshold->hdThreshold = recvData[2] + (recvData[3]<<8);
     outThreshold->dtThreshold = recvData[4] + (recvData[5]<<8);
@@ -808,7 +1633,8 @@ INT32 HVC_GetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetSizeRange                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_SIZERANGE *inSizeRange    detection sizes                   */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -816,8 +1642,9 @@ INT32 HVC_GetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *outStatus)
+INT32 HVC_SetSizeRange(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -839,11 +1666,11 @@ INT32 HVC_SetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *o
     sendData[10] = (UINT8)(inSizeRange->dtMaxSize&0xff);
     sendData[11] = (UINT8)((inSizeRange->dtMaxSize>>8)&0xff);
     /* Send SetSizeRange command signal */
-    ret = HVC_SendCommand(HVC_COM_SET_SIZE_RANGE, sizeof(UINT8)*12, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_SIZE_RANGE, sizeof(UINT8)*12, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -851,7 +1678,8 @@ INT32 HVC_SetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *o
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetSizeRange                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_SIZERANGE *outSizeRange   detection sizes                   */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -859,8 +1687,9 @@ INT32 HVC_SetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *o
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *outStatus)
+INT32 HVC_GetSizeRange(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -870,19 +1699,15 @@ INT32 HVC_GetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *
     }
 
     /* Send GetSizeRange command signal */
-    ret = HVC_SendCommand(HVC_COM_GET_SIZE_RANGE, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_SIZE_RANGE, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*12, sizeof(UINT8)*12, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*12 ) {
-        size = sizeof(UINT8)*12;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     outSizeRange->bdMinSize = recvData[0] + (recvData[1]<<8);
     outSizeRange->bdMaxSize = recvData[2] + (recvData[3]<<8);
     outSizeRange->hdMinSize = recvData[4] + (recvData[5]<<8);
@@ -895,7 +1720,8 @@ INT32 HVC_GetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetFaceDetectionAngle                                                  */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inPose          Yaw angle range                   */
 /*          : INT32         inAngle         Roll angle range                  */
 /*          : UINT8         *outStatus      response code                     */
@@ -904,8 +1730,9 @@ INT32 HVC_GetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetFaceDetectionAngle(INT32 inTimeOutTime, INT32 inPose, INT32 inAngle, UINT8 *outStatus)
+INT32 HVC_SetFaceDetectionAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inPose, INT32 inAngle, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -917,11 +1744,11 @@ INT32 HVC_SetFaceDetectionAngle(INT32 inTimeOutTime, INT32 inPose, INT32 inAngle
     sendData[0] = (UINT8)(inPose&0xff);
     sendData[1] = (UINT8)(inAngle&0xff);
     /* Send SetFaceDetectionAngle command signal */
-    ret = HVC_SendCommand(HVC_COM_SET_DETECTION_ANGLE, sizeof(UINT8)*2, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_DETECTION_ANGLE, sizeof(UINT8)*2, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -929,7 +1756,8 @@ INT32 HVC_SetFaceDetectionAngle(INT32 inTimeOutTime, INT32 inPose, INT32 inAngle
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetFaceDetectionAngle                                                  */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outPose        Yaw angle range                   */
 /*          : INT32         *outAngle       Roll angle range                  */
 /*          : UINT8         *outStatus      response code                     */
@@ -938,8 +1766,9 @@ INT32 HVC_SetFaceDetectionAngle(INT32 inTimeOutTime, INT32 inPose, INT32 inAngle
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetFaceDetectionAngle(INT32 inTimeOutTime, INT32 *outPose, INT32 *outAngle, UINT8 *outStatus)
+INT32 HVC_GetFaceDetectionAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outPose, INT32 *outAngle, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -949,19 +1778,15 @@ INT32 HVC_GetFaceDetectionAngle(INT32 inTimeOutTime, INT32 *outPose, INT32 *outA
     }
 
     /* Send GetFaceDetectionAngle signal command */
-    ret = HVC_SendCommand(HVC_COM_GET_DETECTION_ANGLE, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_DETECTION_ANGLE, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*2, sizeof(UINT8)*2, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*2 ) {
-        size = sizeof(UINT8)*2;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     *outPose = recvData[0];
     *outAngle = recvData[1];
 
@@ -970,7 +1795,8 @@ INT32 HVC_GetFaceDetectionAngle(INT32 inTimeOutTime, INT32 *outPose, INT32 *outA
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetBaudRate                                                            */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inRate          Baudrate                          */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -978,8 +1804,9 @@ INT32 HVC_GetFaceDetectionAngle(INT32 inTimeOutTime, INT32 *outPose, INT32 *outA
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetBaudRate(INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus)
+INT32 HVC_SetBaudRate(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -990,11 +1817,11 @@ INT32 HVC_SetBaudRate(INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus)
 
     sendData[0] = (UINT8)(inRate&0xff);
     /* Send SetBaudRate command signal */
-    ret = HVC_SendCommand(HVC_COM_SET_BAUDRATE, sizeof(UINT8), sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_BAUDRATE, sizeof(UINT8), sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1002,7 +1829,8 @@ INT32 HVC_SetBaudRate(INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_Registration                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         inDataID        Data ID (0-9)                     */
 /*          : HVC_IMAGE     *outImage       image info                        */
@@ -1012,8 +1840,9 @@ INT32 HVC_SetBaudRate(INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_IMAGE *outImage, UINT8 *outStatus)
+INT32 HVC_Registration(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_IMAGE *outImage, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1027,16 +1856,16 @@ INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_
     sendData[0] = (UINT8)(inUserID&0xff);
     sendData[1] = (UINT8)((inUserID>>8)&0xff);
     sendData[2] = (UINT8)(inDataID&0xff);
-    ret = HVC_SendCommand(HVC_COM_REGISTRATION, sizeof(UINT8)*3, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_REGISTRATION, sizeof(UINT8)*3, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*(4 + 64*64), sizeof(UINT8)*(4 + 64*64), &size, outStatus);
     if ( ret != 0 ) return ret;
 
     /* Receive data */
     if ( size >= (INT32)sizeof(UINT8)*4 ) {
-        ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, recvData);
+        ret = HVC_ReceiveData(inHandle, deadline, sizeof(UINT8)*4, recvData);
         outImage->width = recvData[0] + (recvData[1]<<8);
         outImage->height = recvData[2] + (recvData[3]<<8);
         if ( ret != 0 ) return ret;
@@ -1045,7 +1874,7 @@ INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_
 
     /* Image data */
     if ( size >= (INT32)sizeof(UINT8)*64*64 ) {
-        ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*64*64, outImage->image);
+        ret = HVC_ReceiveData(inHandle, deadline, sizeof(UINT8)*64*64, outImage->image);
         if ( ret != 0 ) return ret;
         size -= sizeof(UINT8)*64*64;
     }
@@ -1055,7 +1884,8 @@ INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_
 
 /*----------------------------------------------------------------------------*/
 /* HVC_DeleteData                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         inDataID        Data ID (0-9)                     */
 /*          : UINT8         *outStatus      response code                     */
@@ -1064,8 +1894,9 @@ INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_DeleteData(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8 *outStatus)
+INT32 HVC_DeleteData(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1078,11 +1909,11 @@ INT32 HVC_DeleteData(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8
     sendData[0] = (UINT8)(inUserID&0xff);
     sendData[1] = (UINT8)((inUserID>>8)&0xff);
     sendData[2] = (UINT8)(inDataID&0xff);
-    ret = HVC_SendCommand(HVC_COM_DELETE_DATA, sizeof(UINT8)*3, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_DELETE_DATA, sizeof(UINT8)*3, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1090,7 +1921,8 @@ INT32 HVC_DeleteData(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8
 
 /*----------------------------------------------------------------------------*/
 /* HVC_DeleteUser                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1098,8 +1930,9 @@ INT32 HVC_DeleteData(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_DeleteUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
+INT32 HVC_DeleteUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1111,11 +1944,11 @@ INT32 HVC_DeleteUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
     /* Send Delete User signal command */
     sendData[0] = (UINT8)(inUserID&0xff);
     sendData[1] = (UINT8)((inUserID>>8)&0xff);
-    ret = HVC_SendCommand(HVC_COM_DELETE_USER, sizeof(UINT8)*2, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_DELETE_USER, sizeof(UINT8)*2, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1123,15 +1956,17 @@ INT32 HVC_DeleteUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_DeleteAll                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_DeleteAll(INT32 inTimeOutTime, UINT8 *outStatus)
+INT32 HVC_DeleteAll(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
 
@@ -1140,11 +1975,11 @@ INT32 HVC_DeleteAll(INT32 inTimeOutTime, UINT8 *outStatus)
     }
 
     /* Send Delete All signal command */
-    ret = HVC_SendCommand(HVC_COM_DELETE_ALL, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_DELETE_ALL, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1152,7 +1987,8 @@ INT32 HVC_DeleteAll(INT32 inTimeOutTime, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetUserData                                                            */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         *outDataNo      Registration Info                 */
 /*          : UINT8         *outStatus      response code                     */
@@ -1161,8 +1997,9 @@ INT32 HVC_DeleteAll(INT32 inTimeOutTime, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetUserData(INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UINT8 *outStatus)
+INT32 HVC_GetUserData(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[8];
@@ -1175,19 +2012,15 @@ INT32 HVC_GetUserData(INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UIN
     /* Send Get Registration Info signal command */
     sendData[0] = (UINT8)(inUserID&0xff);
     sendData[1] = (UINT8)((inUserID>>8)&0xff);
-    ret = HVC_SendCommand(HVC_COM_GET_PERSON_DATA, sizeof(UINT8)*2, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_PERSON_DATA, sizeof(UINT8)*2, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*2, sizeof(UINT8)*2, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*2 ) {
-        size = sizeof(UINT8)*2;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     *outDataNo = recvData[0] + (recvData[1]<<8);
 
     return ret;
@@ -1204,8 +2037,9 @@ INT32 HVC_GetUserData(INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UIN
 /*          :                                   -1...parameter error          */
 /*          :                                   other...signal error          */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SaveAlbum(INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDataSize, UINT8 *outStatus)
+INT32 HVC_SaveAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDataSize, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
 
@@ -1216,10 +2050,11 @@ INT32 HVC_SaveAlbum(INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDat
     }
 
     /* Send Save Album signal command */
-    ret = HVC_SendCommand(HVC_COM_SAVE_ALBUM, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SAVE_ALBUM, 0, NULL);
     if ( ret != 0 ) return ret;
 
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*8 + HVC_ALBUM_SIZE_MIN,
+                            sizeof(UINT8)*8 + HVC_ALBUM_SIZE_MAX, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     if ( size >= (INT32)sizeof(UINT8)*8 + HVC_ALBUM_SIZE_MIN ) {
@@ -1227,15 +2062,15 @@ INT32 HVC_SaveAlbum(INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDat
         tmpAlbumData = outAlbumData;
 
         do{
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, tmpAlbumData);
+            ret = HVC_ReceiveData(inHandle, deadline, sizeof(UINT8)*4, tmpAlbumData);
             if ( ret != 0 ) return ret;
             tmpAlbumData += sizeof(UINT8)*4;
 
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*4, tmpAlbumData);
+            ret = HVC_ReceiveData(inHandle, deadline, sizeof(UINT8)*4, tmpAlbumData);
             if ( ret != 0 ) return ret;
             tmpAlbumData += sizeof(UINT8)*4;
 
-            ret = HVC_ReceiveData(inTimeOutTime, size - sizeof(UINT8)*8, tmpAlbumData);
+            ret = HVC_ReceiveData(inHandle, deadline, size - sizeof(UINT8)*8, tmpAlbumData);
             if ( ret != 0 ) return ret;
         }while(0);
     }
@@ -1245,30 +2080,57 @@ INT32 HVC_SaveAlbum(INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDat
 
 /*----------------------------------------------------------------------------*/
 /* HVC_LoadAlbum                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : UINT8         *inAlbumData    Album data                        */
+/*          : INT32         inAlbumDataSize Album data size                   */
+/*          : UINT8         *outStatus      response code                     */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_LoadAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize, UINT8 *outStatus)
+{
+    return HVC_LoadAlbumEx(inHandle, inTimeOutTime, inAlbumData, inAlbumDataSize, NULL, NULL, NULL, outStatus);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_LoadAlbumEx                                                            */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *inAlbumData    Album data                        */
 /*          : INT32         inAlbumDataSize Album data size                   */
+/*          : HVC_SEND_PROGRESS_FUNC inProgress progress hook, NULL...none    */
+/*          : void          *pParam         passed to inProgress              */
+/*          : INT32         *outSentSize    album bytes sent, NULL...none     */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_LoadAlbum(INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize, UINT8 *outStatus)
+INT32 HVC_LoadAlbumEx(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize,
+                      HVC_SEND_PROGRESS_FUNC inProgress, void *pParam, INT32 *outSentSize, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
+    INT32 sent = 0;
 
+    if ( NULL != outSentSize ) *outSentSize = 0;
     if((NULL == inAlbumData) || (NULL == outStatus)){
         return HVC_ERROR_PARAMETER;
     }
 
-    /* Send Save Album signal command */
-    ret = HVC_SendCommandOfLoadAlbum(HVC_COM_LOAD_ALBUM, inAlbumDataSize, inAlbumData);
+    /* Send Load Album signal command */
+    ret = HVC_SendCommandOfLoadAlbum(inHandle, deadline, HVC_COM_LOAD_ALBUM, inAlbumDataSize, inAlbumData,
+                                     inProgress, pParam, &sent);
+    if ( NULL != outSentSize ) *outSentSize = sent;
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return ret;
@@ -1276,15 +2138,17 @@ INT32 HVC_LoadAlbum(INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSi
 
 /*----------------------------------------------------------------------------*/
 /* HVC_WriteAlbum                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_WriteAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
+INT32 HVC_WriteAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
 
@@ -1293,11 +2157,11 @@ INT32 HVC_WriteAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
     }
 
     /* Send Write Album signal command */
-    ret = HVC_SendCommand(HVC_COM_WRITE_ALBUM, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_WRITE_ALBUM, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return ret;
@@ -1305,15 +2169,17 @@ INT32 HVC_WriteAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_WriteAlbum                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
 /*          :                               0...normal                        */
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_ReformatAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
+INT32 HVC_ReformatAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
 
@@ -1322,11 +2188,11 @@ INT32 HVC_ReformatAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
     }
 
     /* Send Reformat Album signal command */
-    ret = HVC_SendCommand(HVC_COM_REFORMAT_ALBUM, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_REFORMAT_ALBUM, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return ret;
@@ -1334,7 +2200,8 @@ INT32 HVC_ReformatAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetVerifyThreshold                                                     */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inThreshold     Verify threshold                  */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1342,8 +2209,9 @@ INT32 HVC_ReformatAlbum(INT32 inTimeOutTime, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetVerifyThreshold(INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outStatus)
+INT32 HVC_SetVerifyThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1355,11 +2223,11 @@ INT32 HVC_SetVerifyThreshold(INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outS
     /* Send Delete User signal command */
     sendData[0] = (UINT8)(inThreshold&0xff);
     sendData[1] = (UINT8)((inThreshold>>8)&0xff);
-    ret = HVC_SendCommand(HVC_COM_SET_VERIFY_THRESHOLD, sizeof(UINT8)*2, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_VERIFY_THRESHOLD, sizeof(UINT8)*2, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1367,7 +2235,8 @@ INT32 HVC_SetVerifyThreshold(INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outS
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetVerifyThreshold                                                     */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outThreshold   Verify threshold                  */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1375,8 +2244,9 @@ INT32 HVC_SetVerifyThreshold(INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outS
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetVerifyThreshold(INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *outStatus)
+INT32 HVC_GetVerifyThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -1386,19 +2256,15 @@ INT32 HVC_GetVerifyThreshold(INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *ou
     }
 
     /* Send GetFaceDetectionAngle signal command */
-    ret = HVC_SendCommand(HVC_COM_GET_VERIFY_THRESHOLD, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_VERIFY_THRESHOLD, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*2, sizeof(UINT8)*2, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*2 ) {
-        size = sizeof(UINT8)*2;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     *outThreshold = recvData[0] + (recvData[1]<<8);
 
     return ret;
@@ -1406,7 +2272,8 @@ INT32 HVC_GetVerifyThreshold(INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *ou
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        Verify user ID                    */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1414,8 +2281,9 @@ INT32 HVC_GetVerifyThreshold(INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *ou
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetVerifyUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
+INT32 HVC_SetVerifyUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1427,11 +2295,11 @@ INT32 HVC_SetVerifyUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
     /* Send Delete User signal command */
     sendData[0] = (UINT8)(inUserID&0xff);
     sendData[1] = (UINT8)((inUserID>>8)&0xff);
-    ret = HVC_SendCommand(HVC_COM_SET_VERIFY_USER, sizeof(UINT8)*2, sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_VERIFY_USER, sizeof(UINT8)*2, sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1439,7 +2307,8 @@ INT32 HVC_SetVerifyUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outUserID      Verify user ID                    */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1447,8 +2316,9 @@ INT32 HVC_SetVerifyUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetVerifyUser(INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus)
+INT32 HVC_GetVerifyUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -1458,19 +2328,15 @@ INT32 HVC_GetVerifyUser(INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus)
     }
 
     /* Send GetFaceDetectionAngle signal command */
-    ret = HVC_SendCommand(HVC_COM_GET_VERIFY_USER, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_VERIFY_USER, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8)*2, sizeof(UINT8)*2, &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8)*2 ) {
-        size = sizeof(UINT8)*2;
-    }
-
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
     *outUserID = recvData[0] + (recvData[1]<<8);
 
     return ret;
@@ -1478,7 +2344,8 @@ INT32 HVC_GetVerifyUser(INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_SetRegistCount                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inCnt           Regist user max count             */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1486,8 +2353,9 @@ INT32 HVC_GetVerifyUser(INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_SetRegistCount(INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus)
+INT32 HVC_SetRegistCount(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -1498,11 +2366,11 @@ INT32 HVC_SetRegistCount(INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus)
 
     /* Send Delete User signal command */
     sendData[0] = (UINT8)(inCnt&0xff);
-    ret = HVC_SendCommand(HVC_COM_SET_REGIST_COUNT, sizeof(UINT8), sendData);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_SET_REGIST_COUNT, sizeof(UINT8), sendData);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, 0, 0, &size, outStatus);
     if ( ret != 0 ) return ret;
 
     return 0;
@@ -1510,7 +2378,8 @@ INT32 HVC_SetRegistCount(INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus)
 
 /*----------------------------------------------------------------------------*/
 /* HVC_GetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outCnt         Regist user max count             */
 /*          : UINT8         *outStatus      response code                     */
 /* return   : INT32                         execution result error code       */
@@ -1518,8 +2387,9 @@ INT32 HVC_SetRegistCount(INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus)
 /*          :                               -1...parameter error              */
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
-INT32 HVC_GetRegistCount(INT32 inTimeOutTime, INT32 *outCnt, UINT8 *outStatus)
+INT32 HVC_GetRegistCount(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outCnt, UINT8 *outStatus)
 {
+    UINT32 deadline = HVC_GetDeadline(inTimeOutTime);
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 recvData[32];
@@ -1529,20 +2399,473 @@ INT32 HVC_GetRegistCount(INT32 inTimeOutTime, INT32 *outCnt, UINT8 *outStatus)
     }
 
     /* Send GetFaceDetectionAngle signal command */
-    ret = HVC_SendCommand(HVC_COM_GET_REGIST_COUNT, 0, NULL);
+    ret = HVC_SendCommand(inHandle, deadline, HVC_COM_GET_REGIST_COUNT, 0, NULL);
     if ( ret != 0 ) return ret;
 
     /* Receive header */
-    ret = HVC_ReceiveHeader(inTimeOutTime, &size, outStatus);
+    ret = HVC_ReceiveHeader(inHandle, deadline, sizeof(UINT8), sizeof(UINT8), &size, outStatus);
     if ( ret != 0 ) return ret;
 
-    if ( size > (INT32)sizeof(UINT8) ) {
+    /* Receive data */
+    ret = HVC_ReceiveData(inHandle, deadline, size, recvData);
+    *outCnt = recvData[0];
+
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Command batch                                                              */
+/*----------------------------------------------------------------------------*/
+#define HVC_BATCH_SEND_SIZE     256     /* Bytes of commands per write */
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchInit                                                              */
+/* param    : HVC_BATCH     *outBatch       batch                             */
+/*          : HVC_BATCH_COMMAND *inCommands command storage                   */
+/*          : INT32         inCommandMax    number of entries                 */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchInit(HVC_BATCH *outBatch, HVC_BATCH_COMMAND *inCommands, INT32 inCommandMax)
+{
+    if((NULL == outBatch) || (NULL == inCommands) || (inCommandMax <= 0)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    outBatch->pCommand = inCommands;
+    outBatch->commandMax = inCommandMax;
+    outBatch->commandNum = 0;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Next free entry of a batch                                                 */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : UINT8         inCommandNo     command number                    */
+/*          : INT32         inDataSize      command data size                 */
+/* return   : HVC_BATCH_COMMAND*            entry, NULL if the batch is full  */
+/*----------------------------------------------------------------------------*/
+static HVC_BATCH_COMMAND *HVC_BatchAdd(HVC_BATCH *ioBatch, UINT8 inCommandNo, INT32 inDataSize)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( (NULL == ioBatch) || (ioBatch->commandNum >= ioBatch->commandMax) ) {
+        return NULL;
+    }
+
+    pCommand = &ioBatch->pCommand[ioBatch->commandNum++];
+    pCommand->commandNo = inCommandNo;
+    pCommand->dataSize = inDataSize;
+    pCommand->pOut[0] = NULL;
+    pCommand->pOut[1] = NULL;
+    pCommand->ret = 0;
+    pCommand->status = 0;
+    return pCommand;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchSetCameraAngle                                                    */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         inAngleNo       camera angle number               */
+/* return   : INT32                         0...normal, -1...batch full       */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchSetCameraAngle(HVC_BATCH *ioBatch, INT32 inAngleNo)
+{
+    HVC_BATCH_COMMAND *pCommand = HVC_BatchAdd(ioBatch, HVC_COM_SET_CAMERA_ANGLE, sizeof(UINT8));
+
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inAngleNo&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchGetCameraAngle                                                    */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         *outAngleNo     camera angle number               */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchGetCameraAngle(HVC_BATCH *ioBatch, INT32 *outAngleNo)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == outAngleNo ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_GET_CAMERA_ANGLE, 0);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->pOut[0] = outAngleNo;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchSetThreshold                                                      */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : HVC_THRESHOLD *inThreshold    threshold values                  */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchSetThreshold(HVC_BATCH *ioBatch, const HVC_THRESHOLD *inThreshold)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == inThreshold ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_SET_THRESHOLD, sizeof(UINT8)*8);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inThreshold->bdThreshold&0xff);
+    pCommand->data[1] = (UINT8)((inThreshold->bdThreshold>>8)&0xff);
+    pCommand->data[2] = (UINT8)(inThreshold->hdThreshold&0xff);
+    pCommand->data[3] = (UINT8)((inThreshold->hdThreshold>>8)&0xff);
+    pCommand->data[4] = (UINT8)(inThreshold->dtThreshold&0xff);
+    pCommand->data[5] = (UINT8)((inThreshold->dtThreshold>>8)&0xff);
+    pCommand->data[6] = (UINT8)(inThreshold->rsThreshold&0xff);
+    pCommand->data[7] = (UINT8)((inThreshold->rsThreshold>>8)&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchGetThreshold                                                      */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : HVC_THRESHOLD *outThreshold   threshold values                  */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchGetThreshold(HVC_BATCH *ioBatch, HVC_THRESHOLD *outThreshold)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == outThreshold ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_GET_THRESHOLD, 0);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->pOut[0] = outThreshold;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchSetSizeRange                                                      */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : HVC_SIZERANGE *inSizeRange    detection sizes                   */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchSetSizeRange(HVC_BATCH *ioBatch, const HVC_SIZERANGE *inSizeRange)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == inSizeRange ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_SET_SIZE_RANGE, sizeof(UINT8)*12);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inSizeRange->bdMinSize&0xff);
+    pCommand->data[1] = (UINT8)((inSizeRange->bdMinSize>>8)&0xff);
+    pCommand->data[2] = (UINT8)(inSizeRange->bdMaxSize&0xff);
+    pCommand->data[3] = (UINT8)((inSizeRange->bdMaxSize>>8)&0xff);
+    pCommand->data[4] = (UINT8)(inSizeRange->hdMinSize&0xff);
+    pCommand->data[5] = (UINT8)((inSizeRange->hdMinSize>>8)&0xff);
+    pCommand->data[6] = (UINT8)(inSizeRange->hdMaxSize&0xff);
+    pCommand->data[7] = (UINT8)((inSizeRange->hdMaxSize>>8)&0xff);
+    pCommand->data[8] = (UINT8)(inSizeRange->dtMinSize&0xff);
+    pCommand->data[9] = (UINT8)((inSizeRange->dtMinSize>>8)&0xff);
+    pCommand->data[10] = (UINT8)(inSizeRange->dtMaxSize&0xff);
+    pCommand->data[11] = (UINT8)((inSizeRange->dtMaxSize>>8)&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchGetSizeRange                                                      */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : HVC_SIZERANGE *outSizeRange   detection sizes                   */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchGetSizeRange(HVC_BATCH *ioBatch, HVC_SIZERANGE *outSizeRange)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == outSizeRange ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_GET_SIZE_RANGE, 0);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->pOut[0] = outSizeRange;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchSetFaceDetectionAngle                                             */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         inPose          Yaw angle range                   */
+/*          : INT32         inAngle         Roll angle range                  */
+/* return   : INT32                         0...normal, -1...batch full       */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchSetFaceDetectionAngle(HVC_BATCH *ioBatch, INT32 inPose, INT32 inAngle)
+{
+    HVC_BATCH_COMMAND *pCommand = HVC_BatchAdd(ioBatch, HVC_COM_SET_DETECTION_ANGLE, sizeof(UINT8)*2);
+
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inPose&0xff);
+    pCommand->data[1] = (UINT8)(inAngle&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchGetFaceDetectionAngle                                             */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         *outPose        Yaw angle range                   */
+/*          : INT32         *outAngle       Roll angle range                  */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchGetFaceDetectionAngle(HVC_BATCH *ioBatch, INT32 *outPose, INT32 *outAngle)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if((NULL == outPose) || (NULL == outAngle)){
+        return HVC_ERROR_PARAMETER;
+    }
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_GET_DETECTION_ANGLE, 0);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->pOut[0] = outPose;
+    pCommand->pOut[1] = outAngle;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchSetVerifyThreshold                                                */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         inThreshold     Verify threshold                  */
+/* return   : INT32                         0...normal, -1...batch full       */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchSetVerifyThreshold(HVC_BATCH *ioBatch, INT32 inThreshold)
+{
+    HVC_BATCH_COMMAND *pCommand = HVC_BatchAdd(ioBatch, HVC_COM_SET_VERIFY_THRESHOLD, sizeof(UINT8)*2);
+
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inThreshold&0xff);
+    pCommand->data[1] = (UINT8)((inThreshold>>8)&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchGetVerifyThreshold                                                */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         *outThreshold   Verify threshold                  */
+/* return   : INT32                         0...normal, -1...parameter error  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchGetVerifyThreshold(HVC_BATCH *ioBatch, INT32 *outThreshold)
+{
+    HVC_BATCH_COMMAND *pCommand;
+
+    if ( NULL == outThreshold ) return HVC_ERROR_PARAMETER;
+    pCommand = HVC_BatchAdd(ioBatch, HVC_COM_GET_VERIFY_THRESHOLD, 0);
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->pOut[0] = outThreshold;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchDeleteData                                                        */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         inUserID        User ID (0-499)                   */
+/*          : INT32         inDataID        Data ID (0-9)                     */
+/* return   : INT32                         0...normal, -1...batch full       */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchDeleteData(HVC_BATCH *ioBatch, INT32 inUserID, INT32 inDataID)
+{
+    HVC_BATCH_COMMAND *pCommand = HVC_BatchAdd(ioBatch, HVC_COM_DELETE_DATA, sizeof(UINT8)*3);
+
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inUserID&0xff);
+    pCommand->data[1] = (UINT8)((inUserID>>8)&0xff);
+    pCommand->data[2] = (UINT8)(inDataID&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchDeleteUser                                                        */
+/* param    : HVC_BATCH     *ioBatch        batch                             */
+/*          : INT32         inUserID        User ID (0-499)                   */
+/* return   : INT32                         0...normal, -1...batch full       */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchDeleteUser(HVC_BATCH *ioBatch, INT32 inUserID)
+{
+    HVC_BATCH_COMMAND *pCommand = HVC_BatchAdd(ioBatch, HVC_COM_DELETE_USER, sizeof(UINT8)*2);
+
+    if ( NULL == pCommand ) return HVC_ERROR_PARAMETER;
+
+    pCommand->data[0] = (UINT8)(inUserID&0xff);
+    pCommand->data[1] = (UINT8)((inUserID>>8)&0xff);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Send batch commands back to back                                           */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : HVC_BATCH     *inBatch        batch                             */
+/*          : INT32         inFirst         first command to send             */
+/*          : INT32         inEnd           command after the last one        */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -10...send error                  */
+/* The commands go out HVC_BATCH_SEND_SIZE bytes at most per write. The first */
+/* write of the batch drops stale bytes like any command; every later one     */
+/* keeps them (UART_SendDataPipelined()), since responses are still due.      */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_BatchSend(HVC_HANDLE inHandle, const HVC_BATCH *inBatch, INT32 inFirst, INT32 inEnd)
+{
+    INT32 i = inFirst;
+    INT32 size;
+    INT32 ret;
+    UINT8 sendData[HVC_BATCH_SEND_SIZE];
+    const HVC_BATCH_COMMAND *pCommand;
+
+    while ( i < inEnd ) {
+        for ( size = 0; i < inEnd; i++ ) {
+            pCommand = &inBatch->pCommand[i];
+            if ( size + SEND_HEAD_NUM + pCommand->dataSize > HVC_BATCH_SEND_SIZE ) break;
+
+            /* Create header */
+            sendData[size + SEND_HEAD_SYNCBYTE]         = (UINT8)0xFE;
+            sendData[size + SEND_HEAD_COMMANDNO]        = pCommand->commandNo;
+            sendData[size + SEND_HEAD_DATALENGTHLSB]    = (UINT8)(pCommand->dataSize&0xff);
+            sendData[size + SEND_HEAD_DATALENGTHMSB]    = (UINT8)((pCommand->dataSize>>8)&0xff);
+            memcpy(&sendData[size + SEND_HEAD_NUM], pCommand->data, pCommand->dataSize);
+            size += SEND_HEAD_NUM + pCommand->dataSize;
+        }
+
+        if ( 0 == inFirst ) {
+            ret = UART_SendData(inHandle, size, sendData);
+        }
+        else {
+            ret = UART_SendDataPipelined(inHandle, size, sendData);
+        }
+        if ( ret != size ) return HVC_ERROR_SEND_DATA;
+        inFirst = i;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Receive the response of one batch command                                  */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : UINT32        inDeadline      deadline tick of the response     */
+/*          : HVC_BATCH_COMMAND *ioCommand  command, status and outputs set   */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -20...timeout error               */
+/*          :                               -21...invalid header error        */
+/*          :                               -22...data timeout error          */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_BatchReceive(HVC_HANDLE inHandle, UINT32 inDeadline, HVC_BATCH_COMMAND *ioCommand)
+{
+    INT32 ret = 0;
+    INT32 size = 0;
+    UINT8 recvData[HVC_BATCH_RESPONSE_MAX];
+    HVC_THRESHOLD *pThreshold;
+    HVC_SIZERANGE *pSizeRange;
+
+    /* Receive header; the data of a normal end has the size of the command's */
+    switch ( ioCommand->commandNo ) {
+    case HVC_COM_GET_CAMERA_ANGLE:
         size = sizeof(UINT8);
+        break;
+    case HVC_COM_GET_THRESHOLD:
+        size = sizeof(UINT8)*8;
+        break;
+    case HVC_COM_GET_SIZE_RANGE:
+        size = sizeof(UINT8)*12;
+        break;
+    case HVC_COM_GET_DETECTION_ANGLE:
+    case HVC_COM_GET_VERIFY_THRESHOLD:
+        size = sizeof(UINT8)*2;
+        break;
+    default:
+        size = 0;
+        break;
     }
+    ret = HVC_ReceiveHeader(inHandle, inDeadline, size, size, &size, &ioCommand->status);
+    if ( ret != 0 ) return ret;
 
     /* Receive data */
-    ret = HVC_ReceiveData(inTimeOutTime, size, recvData);
-    *outCnt = recvData[0];
+    memset(recvData, 0, sizeof(recvData));
+    ret = HVC_ReceiveData(inHandle, inDeadline, size, recvData);
+    if ( (ret != 0) || (ioCommand->status != 0) ) return ret;
+
+    switch ( ioCommand->commandNo ) {
+    case HVC_COM_GET_CAMERA_ANGLE:
+        *(INT32 *)ioCommand->pOut[0] = recvData[0];
+        break;
+    case HVC_COM_GET_THRESHOLD:
+        pThreshold = (HVC_THRESHOLD *)ioCommand->pOut[0];
+        pThreshold->bdThreshold = recvData[0] + (recvData[1]<<8);
+        pThreshold->hdThreshold = recvData[2] + (recvData[3]<<8);
+        pThreshold->dtThreshold = recvData[4] + (recvData[5]<<8);
+        pThreshold->rsThreshold = recvData[6] + (recvData[7]<<8);
+        break;
+    case HVC_COM_GET_SIZE_RANGE:
+        pSizeRange = (HVC_SIZERANGE *)ioCommand->pOut[0];
+        pSizeRange->bdMinSize = recvData[0] + (recvData[1]<<8);
+        pSizeRange->bdMaxSize = recvData[2] + (recvData[3]<<8);
+        pSizeRange->hdMinSize = recvData[4] + (recvData[5]<<8);
+        pSizeRange->hdMaxSize = recvData[6] + (recvData[7]<<8);
+        pSizeRange->dtMinSize = recvData[8] + (recvData[9]<<8);
+        pSizeRange->dtMaxSize = recvData[10] + (recvData[11]<<8);
+        break;
+    case HVC_COM_GET_DETECTION_ANGLE:
+        *(INT32 *)ioCommand->pOut[0] = recvData[0];
+        *(INT32 *)ioCommand->pOut[1] = recvData[1];
+        break;
+    case HVC_COM_GET_VERIFY_THRESHOLD:
+        *(INT32 *)ioCommand->pOut[0] = recvData[0] + (recvData[1]<<8);
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_BatchRun                                                               */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each command (ms) */
+/*          : HVC_BATCH     *ioBatch        commands, ret/status filled in    */
+/*          : INT32         inWindow        commands in flight, 0...all       */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...first signal error        */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_BatchRun(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_BATCH *ioBatch, INT32 inWindow)
+{
+    INT32 i;
+    INT32 ret = 0;
+    INT32 sent = 0;
+    INT32 end;
 
+    if ( NULL == ioBatch ) {
+        return HVC_ERROR_PARAMETER;
+    }
+    if ( (inWindow <= 0) || (inWindow > ioBatch->commandNum) ) {
+        inWindow = ioBatch->commandNum;
+    }
+
+    for ( i = 0; i < ioBatch->commandNum; i++ ) {
+        /* Keep inWindow commands in flight: each response makes room for */
+        /* the next command                                                */
+        end = (i + inWindow < ioBatch->commandNum) ? i + inWindow : ioBatch->commandNum;
+        if ( (ret == 0) && (sent < end) ) {
+            ret = HVC_BatchSend(inHandle, ioBatch, sent, end);
+            sent = end;
+        }
+
+        /* The device takes up a command once it has answered the one before, */
+        /* so each response gets the whole timeout from then on               */
+        if ( ret == 0 ) {
+            ret = HVC_BatchReceive(inHandle, HVC_GetDeadline(inTimeOutTime), &ioBatch->pCommand[i]);
+        }
+        /* After a signal error the responses can no longer be told apart */
+        ioBatch->pCommand[i].ret = ret;
+    }
     return ret;
 }
@@ -27,186 +27,479 @@ typedef     unsigned char       UINT8;      /*  8 bit Unsigned Integer  */
 #ifndef INT32
 typedef     int                 INT32;      /* 32 bit Signed   Integer  */
 #endif /* INT32 */
+#ifndef UINT32
+typedef     unsigned int        UINT32;     /* 32 bit Unsigned Integer  */
+#endif /* UINT32 */
 #ifndef     NULL
     #define     NULL                0
 #endif
 
 #include "HVCDef.h"
 
+/* Device handle. The API does not look inside it; it is handed on */
+/* unchanged to UART_SendData() / UART_ReceiveData().               */
+typedef void *HVC_HANDLE;
+
+/* Count hook: body, hand and face counts of an Execute response, called as */
+/* soon as its 4 count bytes are in (HVC_PROGRESS, HVC_ExecuteExSetCountHook */
+/* and HVC_StreamSetCountHook).                                              */
+typedef void (*HVC_COUNT_FUNC)(void *pParam, INT32 inBodyNum, INT32 inHandNum, INT32 inFaceNum);
+
+/* One ExecuteEx in flight (HVC_ExecuteExBegin() / HVC_ExecuteExPoll()). */
+/* Owned by the caller; the members are private to HVCApi.c.            */
+typedef struct {
+    HVC_HANDLE  handle;
+    UINT32      deadline;       /* Deadline tick of the command */
+    INT32       exec;
+    INT32       image;
+    INT32       state;
+    INT32       ret;            /* Result once the command has finished */
+    INT32       dataSize;       /* Response data not received yet */
+    INT32       waitSize;       /* Bytes the next step needs */
+    UINT8       header[6];      /* Response header bytes so far */
+    INT32       headerSize;
+    INT32       headerSkip;     /* Stray bytes skipped ahead of the header */
+    INT32       countSize;      /* Bytes in counts[] */
+    UINT8       counts[4];      /* Result counts, when an image follows */
+    HVC_RESULT  *pResult;
+    UINT8       *pStatus;
+    HVC_COUNT_FUNC  pCountFunc; /* Count hook, NULL...none */
+    void        *pCountParam;
+} HVC_ASYNC;
+
+/* Reference-counted frames (HVCFramePool.h) */
+typedef struct HVC_FRAME_POOL_ HVC_FRAME_POOL;
+
+/* ExecuteEx streaming (HVC_StreamStart() / HVC_StreamGet()). */
+/* Owned by the caller; the members are private to HVCApi.c. */
+#define HVC_STREAM_BUFFER_MAX   3
+
+typedef struct {
+    HVC_ASYNC   async;          /* Frame in flight */
+    HVC_HANDLE  handle;
+    INT32       timeOut;
+    INT32       exec;
+    INT32       image;
+    INT32       bufferNum;
+    HVC_FRAME_POOL  *pPool;     /* Frames come from here, NULL...fixed buffers */
+    HVC_RESULT  *pBuffer[HVC_STREAM_BUFFER_MAX];
+    UINT8       status[HVC_STREAM_BUFFER_MAX];
+    INT32       ret[HVC_STREAM_BUFFER_MAX];
+    INT32       inFlight;       /* Buffer being received, -1...none */
+    INT32       held;           /* Buffer the consumer has, -1...none */
+    INT32       queue[HVC_STREAM_BUFFER_MAX];   /* Complete frames, oldest first */
+    INT32       queueNum;
+    HVC_COUNT_FUNC  pCountFunc; /* Count hook of every frame, NULL...none */
+    void        *pCountParam;
+} HVC_STREAM;
+
+/* Progressive ExecuteEx (HVC_ExecuteExProgressive()). The callbacks run     */
+/* on the calling thread, before HVC_ExecuteExProgressive() returns.          */
+/* The count hook runs once the 4 count bytes are in, before any record:     */
+/* the earliest sign that someone is in view. Results are complete as soon   */
+/* as the results callback runs; the image rows arrive in                     */
+/* pResult->image.image, row inRow at inRow*image.width.                      */
+#define HVC_PROGRESS_ROW_CHUNK  16      /* Rows per callback when rowChunk is 0 */
+
+typedef void (*HVC_RESULT_FUNC)(void *pParam, const HVC_RESULT *pResult);
+typedef void (*HVC_IMAGE_ROW_FUNC)(void *pParam, const HVC_RESULT *pResult, INT32 inRow, INT32 inRowNum);
+
+typedef struct {
+    HVC_COUNT_FUNC      pCountFunc;     /* Detection counts parsed (NULL...none) */
+    HVC_RESULT_FUNC     pResultFunc;    /* Results decoded, image still coming (NULL...none) */
+    HVC_IMAGE_ROW_FUNC  pRowFunc;       /* inRowNum more rows received (NULL...none) */
+    INT32               rowChunk;       /* Rows per pRowFunc call, 0...HVC_PROGRESS_ROW_CHUNK */
+    void                *pParam;
+} HVC_PROGRESS;
+
+/* Album upload progress (HVC_LoadAlbumEx()): inSentSize of inTotalSize     */
+/* album bytes are out. Runs on the calling thread after every chunk.        */
+#define HVC_ALBUM_SEND_CHUNK    4096    /* Album bytes per send */
+
+typedef void (*HVC_SEND_PROGRESS_FUNC)(void *pParam, INT32 inSentSize, INT32 inTotalSize);
+
+/* Command batch (HVC_BatchRun()). The commands go out back to back and the  */
+/* responses are matched to them in order. The entries are the caller's;    */
+/* ret and status of each are filled in by HVC_BatchRun().                   */
+#define HVC_BATCH_DATA_MAX      12      /* Largest command data (SetSizeRange) */
+#define HVC_BATCH_RESPONSE_MAX  12      /* Largest response data (GetSizeRange) */
+
+typedef struct {
+    UINT8       commandNo;
+    INT32       dataSize;
+    UINT8       data[HVC_BATCH_DATA_MAX];
+    void        *pOut[2];       /* Where a Get command puts its values */
+    INT32       ret;            /* 0...normal, other...signal error */
+    UINT8       status;         /* Response code */
+} HVC_BATCH_COMMAND;
+
+typedef struct {
+    HVC_BATCH_COMMAND   *pCommand;
+    INT32               commandMax;
+    INT32               commandNum;
+} HVC_BATCH;
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
 
+/* inTimeOutTime is the budget of the whole command: sending, the response  */
+/* header and every part of the response data share one deadline.           */
+
 /* HVC_GetVersion                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_VERSION   *outVersion     version data                      */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetVersion(INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outStatus);
+INT32 HVC_GetVersion(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_VERSION *outVersion, UINT8 *outStatus);
 
 /* HVC_SetCameraAngle                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inAngleNo       camera angle number               */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetCameraAngle(INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus);
+INT32 HVC_SetCameraAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inAngleNo, UINT8 *outStatus);
 
 /* HVC_GetCameraAngle                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outAngleNo     camera angle number               */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetCameraAngle(INT32 inTimeOutTime, INT32 *outAngleNo, UINT8 *outStatus);
+INT32 HVC_GetCameraAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outAngleNo, UINT8 *outStatus);
 
 /* HVC_Execute                                                                */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+INT32 HVC_Execute(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus);
+
+/* HVC_ExecuteProgressive: HVC_Execute() with the callbacks of               */
+/* HVC_ExecuteExProgressive(); inProgress NULL behaves as HVC_Execute().      */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inExec          executable function               */
 /*          : INT32         inImage         image output number               */
+/*          : HVC_PROGRESS  *inProgress     callbacks                         */
 /*          : HVC_RESULT    *outHVCResult   result data                       */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus);
+INT32 HVC_ExecuteProgressive(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                             const HVC_PROGRESS *inProgress, HVC_RESULT *outHVCResult, UINT8 *outStatus);
 
 /* HVC_ExecuteEx                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inExec          executable function               */
 /*          : INT32         inImage         image output number               */
 /*          : HVC_RESULT    *outHVCResult   result data                       */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus);
+INT32 HVC_ExecuteEx(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus);
+
+/* HVC_ExecuteExProgressive: HVC_ExecuteEx() that hands over the counts and  */
+/* the results before the image is in, then the image a chunk of rows at a    */
+/* time, so the caller can work on the image while the rest is still on the   */
+/* wire.                                                                      */
+/* inProgress NULL behaves as HVC_ExecuteEx().                                */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_PROGRESS  *inProgress     callbacks                         */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+INT32 HVC_ExecuteExProgressive(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                               const HVC_PROGRESS *inProgress, HVC_RESULT *outHVCResult, UINT8 *outStatus);
+
+/* HVC_ExecuteExBegin: sends ExecuteEx and returns without waiting.          */
+/* Call HVC_ExecuteExPoll() until it stops returning HVC_PENDING; no other    */
+/* command may use inHandle meanwhile. outHVCResult and outStatus are filled  */
+/* by the poll that completes the command.                                    */
+/* param    : HVC_ASYNC     *outAsync       command state                     */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+INT32 HVC_ExecuteExBegin(HVC_ASYNC *outAsync, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                         HVC_RESULT *outHVCResult, UINT8 *outStatus);
+
+/* HVC_ExecuteExPoll: receives whatever part of the response has arrived,    */
+/* never waits.                                                               */
+/* param    : HVC_ASYNC     *ioAsync        command state                     */
+/* return   : HVC_PENDING, or the HVC_ExecuteEx() result once finished        */
+INT32 HVC_ExecuteExPoll(HVC_ASYNC *ioAsync);
+
+/* HVC_ExecuteExSetCountHook: count hook of the command begun with           */
+/* HVC_ExecuteExBegin(), set before the first poll. The poll that receives   */
+/* the counts calls it, ahead of the results and the image.                  */
+/* param    : HVC_ASYNC     *ioAsync        command state                     */
+/*          : HVC_COUNT_FUNC inCountFunc    count hook, NULL...none           */
+/*          : void          *pParam         hook parameter                    */
+INT32 HVC_ExecuteExSetCountHook(HVC_ASYNC *ioAsync, HVC_COUNT_FUNC inCountFunc, void *pParam);
+
+/* HVC_StreamStart: ExecuteEx frames back to back. The next Execute goes out  */
+/* as soon as the previous response is in, so the device computes a frame    */
+/* while the caller processes the one before. inBuffers (2 or 3) must stay    */
+/* allocated until HVC_StreamStop(); no other command may use inHandle.       */
+/* param    : HVC_STREAM    *outStream      stream state                      */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each frame (ms)   */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_RESULT    **inBuffers     frame buffers                     */
+/*          : INT32         inBufferNum     number of buffers                 */
+INT32 HVC_StreamStart(HVC_STREAM *outStream, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                      HVC_RESULT **inBuffers, INT32 inBufferNum);
+
+/* HVC_StreamStartPool: HVC_StreamStart() taking every frame from a pool.    */
+/* HVC_StreamGet() then hands over the frame with a reference the caller      */
+/* must release (HVC_FrameRelease()), and consumers may keep it as long as    */
+/* they hold a reference. No frame is sent for while the pool is empty.       */
+/* param    : HVC_STREAM    *outStream      stream state                      */
+/*          : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each frame (ms)   */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_FRAME_POOL *inPool        frame pool                        */
+/*          : INT32         inDepth         frames the stream holds itself,   */
+/*          :                               in flight and complete (1 to 3)   */
+INT32 HVC_StreamStartPool(HVC_STREAM *outStream, HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inExec, INT32 inImage,
+                          HVC_FRAME_POOL *inPool, INT32 inDepth);
+
+/* HVC_StreamGet: oldest complete frame. It stays valid until the next call   */
+/* (pool: until released); an error of a frame is returned with that frame.   */
+/* HVC_ERROR_NO_FRAME: no frame complete and none can be received, as every  */
+/* frame of the pool is held; release one and call again.                    */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+/*          : INT32         inWait          0...HVC_PENDING if none, 1...wait */
+/*          : HVC_RESULT    **outResult     frame                             */
+/*          : UINT8         *outStatus      response code                     */
+INT32 HVC_StreamGet(HVC_STREAM *ioStream, INT32 inWait, HVC_RESULT **outResult, UINT8 *outStatus);
+
+/* HVC_StreamStop: waits for the frame in flight and ends the stream;         */
+/* frames the caller still holds stay valid                                   */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+INT32 HVC_StreamStop(HVC_STREAM *ioStream);
+
+/* HVC_StreamSetCountHook: count hook of every frame from the one in flight  */
+/* on; it runs from HVC_StreamGet() as the counts of a frame arrive.         */
+/* param    : HVC_STREAM    *ioStream       stream state                      */
+/*          : HVC_COUNT_FUNC inCountFunc    count hook, NULL...none           */
+/*          : void          *pParam         hook parameter                    */
+INT32 HVC_StreamSetCountHook(HVC_STREAM *ioStream, HVC_COUNT_FUNC inCountFunc, void *pParam);
 
 /* HVC_SetThreshold                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_THRESHOLD *inThreshold    threshold values                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *outStatus);
+INT32 HVC_SetThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_THRESHOLD *inThreshold, UINT8 *outStatus);
 
 /* HVC_GetThreshold                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_THRESHOLD *outThreshold   threshold values                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetThreshold(INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *outStatus);
+INT32 HVC_GetThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_THRESHOLD *outThreshold, UINT8 *outStatus);
 
 /* HVC_SetSizeRange                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_SIZERANGE *inSizeRange    detection sizes                   */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *outStatus);
+INT32 HVC_SetSizeRange(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_SIZERANGE *inSizeRange, UINT8 *outStatus);
 
 /* HVC_GetSizeRange                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_SIZERANGE *outSizeRange   detection sizes                   */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetSizeRange(INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *outStatus);
+INT32 HVC_GetSizeRange(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_SIZERANGE *outSizeRange, UINT8 *outStatus);
 
 /* HVC_SetFaceDetectionAngle                                                  */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inPose          Yaw angle range                   */
 /*          : INT32         inAngle         Roll angle range                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetFaceDetectionAngle(INT32 inTimeOutTime, INT32 inPose, INT32 inAngle, UINT8 *outStatus);
+INT32 HVC_SetFaceDetectionAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inPose, INT32 inAngle, UINT8 *outStatus);
 
 /* HVC_GetFaceDetectionAngle                                                  */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outPose        Yaw angle range                   */
 /*          : INT32         *outAngle       Roll angle range                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetFaceDetectionAngle(INT32 inTimeOutTime, INT32 *outPose, INT32 *outAngle, UINT8 *outStatus);
+INT32 HVC_GetFaceDetectionAngle(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outPose, INT32 *outAngle, UINT8 *outStatus);
 
 /* HVC_SetBaudRate                                                            */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inRate          Baudrate                          */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetBaudRate(INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus);
+INT32 HVC_SetBaudRate(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inRate, UINT8 *outStatus);
 
 /* HVC_Registration                                                           */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         inDataID        Data ID (0-9)                     */
 /*          : HVC_IMAGE     *outImage       image info                        */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_Registration(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_IMAGE *outImage, UINT8 *outStatus);
+INT32 HVC_Registration(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, HVC_IMAGE *outImage, UINT8 *outStatus);
 
 /* HVC_DeleteData                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         inDataID        Data ID (0-9)                     */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_DeleteData(INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8 *outStatus);
+INT32 HVC_DeleteData(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 inDataID, UINT8 *outStatus);
 
 /* HVC_DeleteUser                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_DeleteUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus);
+INT32 HVC_DeleteUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus);
 
 /* HVC_DeleteAll                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_DeleteAll(INT32 inTimeOutTime, UINT8 *outStatus);
+INT32 HVC_DeleteAll(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus);
 
 /* HVC_GetUserData                                                            */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        User ID (0-499)                   */
 /*          : INT32         *outDataNo      Registration Info                 */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetUserData(INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UINT8 *outStatus);
+INT32 HVC_GetUserData(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, INT32 *outDataNo, UINT8 *outStatus);
 
 /* HVC_SaveAlbum                                                              */
 /* param    : INT32         inTimeOutTime       timeout time (ms)             */
 /*          : UINT8         *outAlbumData       Album data                    */
 /*          : INT32         *outAlbumDataSize   Album data size               */
 /*          : UINT8         *outStatus          response code                 */
-INT32 HVC_SaveAlbum(INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDataSize, UINT8 *outStatus);
+INT32 HVC_SaveAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outAlbumData, INT32 *outAlbumDataSize, UINT8 *outStatus);
 
 /* HVC_LoadAlbum                                                              */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : UINT8         *inAlbumData    Album data                        */
+/*          : INT32         inAlbumDataSize Album data size                   */
+/*          : UINT8         *outStatus      response code                     */
+INT32 HVC_LoadAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize, UINT8 *outStatus);
+
+/* HVC_LoadAlbumEx: HVC_LoadAlbum() that sends the album a chunk at a time   */
+/* and reports each chunk to inProgress; the timeout is checked between       */
+/* chunks. When a send fails (-10), *outSentSize tells how much of the album  */
+/* went out. The device still waits for the rest and would take the next      */
+/* command as album data: resynchronise it first, e.g. by reconnecting.       */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *inAlbumData    Album data                        */
 /*          : INT32         inAlbumDataSize Album data size                   */
+/*          : HVC_SEND_PROGRESS_FUNC inProgress progress hook, NULL...none    */
+/*          : void          *pParam         passed to inProgress              */
+/*          : INT32         *outSentSize    album bytes sent, NULL...none     */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_LoadAlbum(INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize, UINT8 *outStatus);
+INT32 HVC_LoadAlbumEx(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *inAlbumData, INT32 inAlbumDataSize,
+                      HVC_SEND_PROGRESS_FUNC inProgress, void *pParam, INT32 *outSentSize, UINT8 *outStatus);
 
 /* HVC_WriteAlbum                                                             */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_WriteAlbum(INT32 inTimeOutTime, UINT8 *outStatus);
+INT32 HVC_WriteAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus);
 
 /* HVC_ReformatAlbum                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_ReformatAlbum(INT32 inTimeOutTime, UINT8 *outStatus);
+INT32 HVC_ReformatAlbum(HVC_HANDLE inHandle, INT32 inTimeOutTime, UINT8 *outStatus);
 
 /* HVC_SetVerifyThreshold                                                     */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inThreshold     Verify threshold                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetVerifyThreshold(INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outStatus);
+INT32 HVC_SetVerifyThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inThreshold, UINT8 *outStatus);
 
 /* HVC_GetVerifyThreshold                                                     */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outThreshold   Verify threshold                  */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetVerifyThreshold(INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *outStatus);
+INT32 HVC_GetVerifyThreshold(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outThreshold, UINT8 *outStatus);
 
 /* HVC_SetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inUserID        Verify user ID                    */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetVerifyUser(INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus);
+INT32 HVC_SetVerifyUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inUserID, UINT8 *outStatus);
 
 /* HVC_GetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outUserID      Verify user ID                    */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetVerifyUser(INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus);
+INT32 HVC_GetVerifyUser(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outUserID, UINT8 *outStatus);
 
 /* HVC_SetRegistCount                                                         */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         inCnt           Regist user max count             */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_SetRegistCount(INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus);
+INT32 HVC_SetRegistCount(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 inCnt, UINT8 *outStatus);
 
 /* HVC_GetVerifyUser                                                          */
-/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : INT32         *outCnt         Regist user max count             */
 /*          : UINT8         *outStatus      response code                     */
-INT32 HVC_GetRegistCount(INT32 inTimeOutTime, INT32 *outCnt, UINT8 *outStatus);
+INT32 HVC_GetRegistCount(HVC_HANDLE inHandle, INT32 inTimeOutTime, INT32 *outCnt, UINT8 *outStatus);
+
+/* HVC_BatchInit: empty batch                                                 */
+/* param    : HVC_BATCH     *outBatch       batch                             */
+/*          : HVC_BATCH_COMMAND *inCommands command storage                   */
+/*          : INT32         inCommandMax    number of entries                 */
+INT32 HVC_BatchInit(HVC_BATCH *outBatch, HVC_BATCH_COMMAND *inCommands, INT32 inCommandMax);
+
+/* HVC_Batch*: append one command; the parameters are those of the HVC_*    */
+/* function of the same name. Get commands fill their outputs in             */
+/* HVC_BatchRun(). They return HVC_ERROR_PARAMETER when the batch is full.   */
+INT32 HVC_BatchSetCameraAngle(HVC_BATCH *ioBatch, INT32 inAngleNo);
+INT32 HVC_BatchGetCameraAngle(HVC_BATCH *ioBatch, INT32 *outAngleNo);
+INT32 HVC_BatchSetThreshold(HVC_BATCH *ioBatch, const HVC_THRESHOLD *inThreshold);
+INT32 HVC_BatchGetThreshold(HVC_BATCH *ioBatch, HVC_THRESHOLD *outThreshold);
+INT32 HVC_BatchSetSizeRange(HVC_BATCH *ioBatch, const HVC_SIZERANGE *inSizeRange);
+INT32 HVC_BatchGetSizeRange(HVC_BATCH *ioBatch, HVC_SIZERANGE *outSizeRange);
+INT32 HVC_BatchSetFaceDetectionAngle(HVC_BATCH *ioBatch, INT32 inPose, INT32 inAngle);
+INT32 HVC_BatchGetFaceDetectionAngle(HVC_BATCH *ioBatch, INT32 *outPose, INT32 *outAngle);
+INT32 HVC_BatchSetVerifyThreshold(HVC_BATCH *ioBatch, INT32 inThreshold);
+INT32 HVC_BatchGetVerifyThreshold(HVC_BATCH *ioBatch, INT32 *outThreshold);
+INT32 HVC_BatchDeleteData(HVC_BATCH *ioBatch, INT32 inUserID, INT32 inDataID);
+INT32 HVC_BatchDeleteUser(HVC_BATCH *ioBatch, INT32 inUserID);
+
+/* HVC_BatchRun: keeps inWindow commands in flight (0...all at once) without */
+/* waiting for each response, and matches the responses in order; each      */
+/* response in sends the next command (UART_SendDataPipelined()). Each       */
+/* response has inTimeOutTime from the one before it. A nonzero response     */
+/* code only concerns its own command; a signal error ends the batch, and    */
+/* the commands whose responses were not received keep that error. No other  */
+/* command may use inHandle meanwhile.                                        */
+/* param    : HVC_HANDLE    inHandle        device handle                     */
+/*          : INT32         inTimeOutTime   timeout time of each command (ms) */
+/*          : HVC_BATCH     *ioBatch        commands, ret/status filled in    */
+/*          : INT32         inWindow        commands in flight                */
+/* return   : 0, or the first signal error                                    */
+INT32 HVC_BatchRun(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_BATCH *ioBatch, INT32 inWindow);
 
 
 #ifdef  __cplusplus
@@ -0,0 +1,232 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Device configuration shadow
+*/
+
+#include <string.h>
+#include "HVCConfig.h"
+
+#define HVC_CONFIG_FIELD_NUM    5       /* Bits of HVC_CONFIG_ALL */
+
+/* Whether a field of two configurations is the same */
+static INT32 ConfigEqual(const HVC_CONFIG *inA, const HVC_CONFIG *inB, INT32 inField)
+{
+    switch ( inField ) {
+    case HVC_CONFIG_CAMERA_ANGLE:
+        return inA->cameraAngle == inB->cameraAngle;
+    case HVC_CONFIG_THRESHOLD:
+        return memcmp(&inA->threshold, &inB->threshold, sizeof(HVC_THRESHOLD)) == 0;
+    case HVC_CONFIG_SIZE_RANGE:
+        return memcmp(&inA->sizeRange, &inB->sizeRange, sizeof(HVC_SIZERANGE)) == 0;
+    case HVC_CONFIG_FACE_ANGLE:
+        return (inA->facePose == inB->facePose) && (inA->faceAngle == inB->faceAngle);
+    case HVC_CONFIG_VERIFY_THRESHOLD:
+        return inA->verifyThreshold == inB->verifyThreshold;
+    default:
+        return 0;
+    }
+}
+
+/* Copies one field */
+static void ConfigCopy(HVC_CONFIG *outDst, const HVC_CONFIG *inSrc, INT32 inField)
+{
+    switch ( inField ) {
+    case HVC_CONFIG_CAMERA_ANGLE:
+        outDst->cameraAngle = inSrc->cameraAngle;
+        break;
+    case HVC_CONFIG_THRESHOLD:
+        outDst->threshold = inSrc->threshold;
+        break;
+    case HVC_CONFIG_SIZE_RANGE:
+        outDst->sizeRange = inSrc->sizeRange;
+        break;
+    case HVC_CONFIG_FACE_ANGLE:
+        outDst->facePose = inSrc->facePose;
+        outDst->faceAngle = inSrc->faceAngle;
+        break;
+    case HVC_CONFIG_VERIFY_THRESHOLD:
+        outDst->verifyThreshold = inSrc->verifyThreshold;
+        break;
+    default:
+        break;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigInvalidate                                                       */
+/* param    : HVC_CONFIG_CACHE  *ioCache    shadow                            */
+/*          : INT32             inFields    HVC_CONFIG_* to forget            */
+/*----------------------------------------------------------------------------*/
+void HVC_ConfigInvalidate(HVC_CONFIG_CACHE *ioCache, INT32 inFields)
+{
+    if ( NULL == ioCache ) return;
+
+    ioCache->valid &= ~inFields;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigApply                                                            */
+/* param    : HVC_HANDLE        inHandle        handle                        */
+/*          : INT32             inTimeOutTime   timeout time (ms)             */
+/*          : HVC_CONFIG_CACHE  *ioCache        shadow                        */
+/*          : HVC_CONFIG        *inConfig       configuration to set          */
+/*          : INT32             inFields        HVC_CONFIG_* to set           */
+/*          : UINT8             *outStatus      response code                 */
+/* return   : INT32                             execution result error code   */
+/*          :                                   0...normal                    */
+/*          :                                   -1...parameter error          */
+/*          :                                   other...signal error          */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ConfigApply(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_CONFIG_CACHE *ioCache,
+                      const HVC_CONFIG *inConfig, INT32 inFields, UINT8 *outStatus)
+{
+    INT32 ret = 0;
+    INT32 i;
+    INT32 field;
+    INT32 fields[HVC_CONFIG_FIELD_NUM];
+    HVC_BATCH_COMMAND command[HVC_CONFIG_FIELD_NUM];
+    HVC_BATCH batch;
+
+    if((NULL == ioCache) || (NULL == inConfig) || (NULL == outStatus)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    *outStatus = 0;
+    HVC_BatchInit(&batch, command, HVC_CONFIG_FIELD_NUM);
+    for ( field = HVC_CONFIG_CAMERA_ANGLE; (field & HVC_CONFIG_ALL) != 0; field <<= 1 ) {
+        if ( (inFields & field) == 0 ) continue;
+        /* The device already holds this value */
+        if ( (ioCache->valid & field) != 0 && ConfigEqual(&ioCache->config, inConfig, field) ) continue;
+
+        /* Unknown until the device accepts it */
+        ioCache->valid &= ~field;
+        fields[batch.commandNum] = field;
+        switch ( field ) {
+        case HVC_CONFIG_CAMERA_ANGLE:
+            HVC_BatchSetCameraAngle(&batch, inConfig->cameraAngle);
+            break;
+        case HVC_CONFIG_THRESHOLD:
+            HVC_BatchSetThreshold(&batch, &inConfig->threshold);
+            break;
+        case HVC_CONFIG_SIZE_RANGE:
+            HVC_BatchSetSizeRange(&batch, &inConfig->sizeRange);
+            break;
+        case HVC_CONFIG_FACE_ANGLE:
+            HVC_BatchSetFaceDetectionAngle(&batch, inConfig->facePose, inConfig->faceAngle);
+            break;
+        default:
+            HVC_BatchSetVerifyThreshold(&batch, inConfig->verifyThreshold);
+            break;
+        }
+    }
+    if ( batch.commandNum == 0 ) return 0;
+
+    ioCache->nCommand += batch.commandNum;
+    ret = HVC_BatchRun(inHandle, inTimeOutTime, &batch, 0);
+    for ( i = 0; i < batch.commandNum; i++ ) {
+        if ( (command[i].ret == 0) && (command[i].status == 0) ) {
+            ConfigCopy(&ioCache->config, inConfig, fields[i]);
+            ioCache->valid |= fields[i];
+        }
+        else if ( *outStatus == 0 ) {
+            *outStatus = command[i].status;
+        }
+    }
+    /* The link failed: what the device holds is unknown, the accepted fields too */
+    if ( ret != 0 ) HVC_ConfigInvalidate(ioCache, HVC_CONFIG_ALL);
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigRead                                                             */
+/* param    : HVC_HANDLE        inHandle        handle                        */
+/*          : INT32             inTimeOutTime   timeout time (ms)             */
+/*          : HVC_CONFIG_CACHE  *ioCache        shadow                        */
+/*          : INT32             inFields        HVC_CONFIG_* to get           */
+/*          : HVC_CONFIG        *outConfig      configuration (inFields only) */
+/*          : UINT8             *outStatus      response code                 */
+/* return   : INT32                             execution result error code   */
+/*          :                                   0...normal                    */
+/*          :                                   -1...parameter error          */
+/*          :                                   other...signal error          */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ConfigRead(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_CONFIG_CACHE *ioCache,
+                     INT32 inFields, HVC_CONFIG *outConfig, UINT8 *outStatus)
+{
+    INT32 ret = 0;
+    INT32 i;
+    INT32 field;
+    INT32 fields[HVC_CONFIG_FIELD_NUM];
+    HVC_BATCH_COMMAND command[HVC_CONFIG_FIELD_NUM];
+    HVC_BATCH batch;
+    HVC_CONFIG *pShadow;
+
+    if((NULL == ioCache) || (NULL == outConfig) || (NULL == outStatus)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    *outStatus = 0;
+    pShadow = &ioCache->config;
+    HVC_BatchInit(&batch, command, HVC_CONFIG_FIELD_NUM);
+    for ( field = HVC_CONFIG_CAMERA_ANGLE; (field & HVC_CONFIG_ALL) != 0; field <<= 1 ) {
+        if ( (inFields & field) == 0 || (ioCache->valid & field) != 0 ) continue;
+
+        fields[batch.commandNum] = field;
+        switch ( field ) {
+        case HVC_CONFIG_CAMERA_ANGLE:
+            HVC_BatchGetCameraAngle(&batch, &pShadow->cameraAngle);
+            break;
+        case HVC_CONFIG_THRESHOLD:
+            HVC_BatchGetThreshold(&batch, &pShadow->threshold);
+            break;
+        case HVC_CONFIG_SIZE_RANGE:
+            HVC_BatchGetSizeRange(&batch, &pShadow->sizeRange);
+            break;
+        case HVC_CONFIG_FACE_ANGLE:
+            HVC_BatchGetFaceDetectionAngle(&batch, &pShadow->facePose, &pShadow->faceAngle);
+            break;
+        default:
+            HVC_BatchGetVerifyThreshold(&batch, &pShadow->verifyThreshold);
+            break;
+        }
+    }
+
+    if ( batch.commandNum > 0 ) {
+        ioCache->nCommand += batch.commandNum;
+        ret = HVC_BatchRun(inHandle, inTimeOutTime, &batch, 0);
+        for ( i = 0; i < batch.commandNum; i++ ) {
+            if ( (command[i].ret == 0) && (command[i].status == 0) ) {
+                ioCache->valid |= fields[i];
+            }
+            else if ( *outStatus == 0 ) {
+                *outStatus = command[i].status;
+            }
+        }
+        /* The link failed: what the device holds is unknown, the fields read too */
+        if ( ret != 0 ) HVC_ConfigInvalidate(ioCache, HVC_CONFIG_ALL);
+        if ( (ret != 0) || (*outStatus != 0) ) return ret;
+    }
+
+    for ( field = HVC_CONFIG_CAMERA_ANGLE; (field & HVC_CONFIG_ALL) != 0; field <<= 1 ) {
+        if ( (inFields & field) != 0 ) {
+            ConfigCopy(outConfig, pShadow, field);
+        }
+    }
+    return 0;
+}
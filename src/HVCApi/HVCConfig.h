@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Device configuration shadow
+*/
+
+#ifndef HVCConfig_H__
+#define HVCConfig_H__
+
+#include "HVCApi.h"
+
+/*----------------------------------------------------------------------------*/
+/* Configuration fields (inFields masks)                                      */
+/*----------------------------------------------------------------------------*/
+#define HVC_CONFIG_CAMERA_ANGLE         0x01    /* HVC_SetCameraAngle */
+#define HVC_CONFIG_THRESHOLD            0x02    /* HVC_SetThreshold */
+#define HVC_CONFIG_SIZE_RANGE           0x04    /* HVC_SetSizeRange */
+#define HVC_CONFIG_FACE_ANGLE           0x08    /* HVC_SetFaceDetectionAngle */
+#define HVC_CONFIG_VERIFY_THRESHOLD     0x10    /* HVC_SetVerifyThreshold */
+#define HVC_CONFIG_ALL                  0x1F
+
+/*----------------------------------------------------------------------------*/
+/* Device configuration                                                       */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    INT32           cameraAngle;        /* Camera angle number */
+    HVC_THRESHOLD   threshold;          /* Threshold values */
+    HVC_SIZERANGE   sizeRange;          /* Detection sizes */
+    INT32           facePose;           /* Face detection pose */
+    INT32           faceAngle;          /* Face detection roll angle */
+    INT32           verifyThreshold;    /* Verification threshold */
+} HVC_CONFIG;
+
+/*----------------------------------------------------------------------------*/
+/* Host-side shadow of the device configuration. A field is valid once it    */
+/* has been written to or read from the device without error; until then,    */
+/* and after HVC_ConfigInvalidate(), it is taken from the device again. Any   */
+/* failed command drops the field it was for, and a batch that fails on the   */
+/* link drops every field: the device may have been reset under it. The       */
+/* device keeps nothing over a reset, so invalidate everything whenever the   */
+/* port is (re)connected.                                                     */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    HVC_CONFIG      config;             /* What the device holds */
+    INT32           valid;              /* HVC_CONFIG_* known to be current */
+    INT32           nCommand;           /* Set/Get commands sent so far */
+} HVC_CONFIG_CACHE;
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigInvalidate: forget fields, the next access goes to the device    */
+/* param    : HVC_CONFIG_CACHE  *ioCache    shadow                            */
+/*          : INT32             inFields    HVC_CONFIG_* to forget            */
+/*----------------------------------------------------------------------------*/
+void HVC_ConfigInvalidate(HVC_CONFIG_CACHE *ioCache, INT32 inFields);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigApply: sends the fields that differ from the shadow              */
+/* param    : HVC_HANDLE        inHandle        handle                        */
+/*          : INT32             inTimeOutTime   timeout time (ms)             */
+/*          : HVC_CONFIG_CACHE  *ioCache        shadow                        */
+/*          : HVC_CONFIG        *inConfig       configuration to set          */
+/*          : INT32             inFields        HVC_CONFIG_* to set           */
+/*          : UINT8             *outStatus      response code                 */
+/* return   : INT32                             execution result error code   */
+/*          :                                   0...normal                    */
+/*          :                                   -1...parameter error          */
+/*          :                                   other...signal error          */
+/* note     : the changed fields go out as one batch (HVC_BatchRun()); a      */
+/*          : field whose command fails stays invalid, a signal error leaves  */
+/*          : every field invalid, and outStatus is the first nonzero         */
+/*          : response code                                                   */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ConfigApply(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_CONFIG_CACHE *ioCache,
+                      const HVC_CONFIG *inConfig, INT32 inFields, UINT8 *outStatus);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ConfigRead: configuration, read from the device only where not valid;  */
+/* the reads go out as one batch, and a signal error leaves every field       */
+/* invalid                                                                    */
+/* param    : HVC_HANDLE        inHandle        handle                        */
+/*          : INT32             inTimeOutTime   timeout time (ms)             */
+/*          : HVC_CONFIG_CACHE  *ioCache        shadow                        */
+/*          : INT32             inFields        HVC_CONFIG_* to get           */
+/*          : HVC_CONFIG        *outConfig      configuration (inFields only) */
+/*          : UINT8             *outStatus      response code                 */
+/* return   : INT32                             execution result error code   */
+/*          :                                   0...normal                    */
+/*          :                                   -1...parameter error          */
+/*          :                                   other...signal error          */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ConfigRead(HVC_HANDLE inHandle, INT32 inTimeOutTime, HVC_CONFIG_CACHE *ioCache,
+                     INT32 inFields, HVC_CONFIG *outConfig, UINT8 *outStatus);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCConfig_H__ */
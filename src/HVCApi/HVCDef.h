@@ -51,6 +51,11 @@
 #define HVC_ERROR_HEADER_INVALID        -21
 /* Receive data signal timeout error */
 #define HVC_ERROR_DATA_TIMEOUT          -22
+/* Every frame of the stream's pool is held by its consumers */
+#define HVC_ERROR_NO_FRAME              -30
+
+/* Asynchronous command still waiting for its response (not an error) */
+#define HVC_PENDING                     1
 
 
 /*----------------------------------------------------------------------------*/
@@ -27,20 +27,63 @@ extern "C" {
 
 /*----------------------------------------------------------------------------*/
 /* UART send signal                                                           */
-/* param    : int   inDataSize  send signal data                              */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataSize  send signal data                              */
 /*          : UINT8 *inData     data length                                   */
 /* return   : int               send signal complete data number              */
 /*----------------------------------------------------------------------------*/
-extern int UART_SendData(int inDataSize, UINT8 *inData);
+extern int UART_SendData(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData);
+
+/*----------------------------------------------------------------------------*/
+/* UART send signal while responses to earlier commands are still due         */
+/* Used by HVC_BatchRun() for every command after the first. Unlike           */
+/* UART_SendData(), received bytes that were not read yet must be kept.       */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataSize      send signal data length                   */
+/*          : UINT8 *inData         send signal data                          */
+/* return   : int                   send signal complete data number          */
+/*----------------------------------------------------------------------------*/
+extern int UART_SendDataPipelined(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData);
+
+/*----------------------------------------------------------------------------*/
+/* UART send signal gathered from several buffers                             */
+/* The buffers go out back to back as one command, without being joined.     */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataNum       number of buffers (UART_SEND_VEC_MAX max) */
+/*          : UINT8 **inData        buffers, in send order                    */
+/*          : int   *inDataSize     size of each buffer                       */
+/* return   : int                   send signal complete data number          */
+/*----------------------------------------------------------------------------*/
+#define UART_SEND_VEC_MAX   2
+
+extern int UART_SendDataV(HVC_HANDLE inHandle, int inDataNum, UINT8 **inData, int *inDataSize);
 
 /*----------------------------------------------------------------------------*/
 /* UART receive signal                                                        */
-/* param    : int   inTimeOutTime   timeout time (ms)                         */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inTimeOutTime   timeout time (ms)                         */
 /*          : int   *inDataSize     receive signal data size                  */
 /*          : UINT8 *outResult      receive signal data                       */
 /* return   : int                   receive signal complete data number       */
 /*----------------------------------------------------------------------------*/
-extern int UART_ReceiveData(int inTimeOutTime, int inDataSize, UINT8 *outResult);
+extern int UART_ReceiveData(HVC_HANDLE inHandle, int inTimeOutTime, int inDataSize, UINT8 *outResult);
+
+/*----------------------------------------------------------------------------*/
+/* UART received data size                                                    */
+/* Must not wait: HVC_ExecuteExPoll() asks this before every receive.         */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/* return   : int                   bytes received and not yet read           */
+/*----------------------------------------------------------------------------*/
+extern int UART_GetReceiveSize(HVC_HANDLE inHandle);
+
+/*----------------------------------------------------------------------------*/
+/* UART resynchronisation notice                                              */
+/* Called when a response header was looked for past bytes that could not     */
+/* start one (noise on the line, the rest of an earlier response).            */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inSkipSize      bytes skipped                             */
+/*----------------------------------------------------------------------------*/
+extern void UART_NotifyResync(HVC_HANDLE inHandle, int inSkipSize);
 
 #ifdef  __cplusplus
 }
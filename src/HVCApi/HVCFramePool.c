@@ -0,0 +1,125 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Reference-counted frame pool
+*/
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+#include "HVCFramePool.h"
+
+#ifdef WIN32
+#define HVC_ATOMIC_INC(p)           InterlockedIncrement((volatile LONG *)(p))
+#define HVC_ATOMIC_DEC(p)           InterlockedDecrement((volatile LONG *)(p))
+#define HVC_ATOMIC_LOAD(p)          InterlockedCompareExchange((volatile LONG *)(p), 0, 0)
+#define HVC_ATOMIC_CLAIM(p)         (InterlockedCompareExchange((volatile LONG *)(p), 1, 0) == 0)
+#else
+#define HVC_ATOMIC_INC(p)           __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define HVC_ATOMIC_DEC(p)           __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define HVC_ATOMIC_LOAD(p)          __atomic_load_n((p), __ATOMIC_ACQUIRE)
+/* 0 -> 1: only one caller can take a free frame */
+static int HVC_AtomicClaim(volatile INT32 *p)
+{
+    INT32 expected = 0;
+    return __atomic_compare_exchange_n(p, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+#define HVC_ATOMIC_CLAIM(p)         HVC_AtomicClaim(p)
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FramePoolInit                                                          */
+/* param    : HVC_FRAME_POOL    *outPool    pool                              */
+/*          : HVC_FRAME         *inFrames   frame storage                     */
+/*          : INT32             inFrameNum  number of frames                  */
+/* return   : INT32                         0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_FramePoolInit(HVC_FRAME_POOL *outPool, HVC_FRAME *inFrames, INT32 inFrameNum)
+{
+    INT32 i;
+
+    if((NULL == outPool) || (NULL == inFrames) || (inFrameNum <= 0)){
+        return HVC_ERROR_PARAMETER;
+    }
+
+    for ( i = 0; i < inFrameNum; i++ ) {
+        inFrames[i].refCount = 0;
+    }
+    outPool->pFrame = inFrames;
+    outPool->frameNum = inFrameNum;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameAcquire                                                           */
+/* param    : HVC_FRAME_POOL    *ioPool     pool                              */
+/* return   : HVC_RESULT*                   frame, NULL if all are in use     */
+/* A pool is a handful of frames, so a scan is all it takes.                  */
+/*----------------------------------------------------------------------------*/
+HVC_RESULT *HVC_FrameAcquire(HVC_FRAME_POOL *ioPool)
+{
+    INT32 i;
+
+    if ( NULL == ioPool ) return NULL;
+    for ( i = 0; i < ioPool->frameNum; i++ ) {
+        if ( HVC_ATOMIC_CLAIM(&ioPool->pFrame[i].refCount) ) {
+            return &ioPool->pFrame[i].result;
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameAddRef                                                            */
+/* param    : HVC_RESULT        *inFrame    frame from HVC_FrameAcquire()     */
+/*----------------------------------------------------------------------------*/
+void HVC_FrameAddRef(HVC_RESULT *inFrame)
+{
+    if ( NULL == inFrame ) return;
+    /* The caller holds a reference already, so the frame cannot be freed meanwhile */
+    HVC_ATOMIC_INC(&((HVC_FRAME *)inFrame)->refCount);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameRelease                                                           */
+/* param    : HVC_RESULT        *inFrame    frame from HVC_FrameAcquire()     */
+/*----------------------------------------------------------------------------*/
+void HVC_FrameRelease(HVC_RESULT *inFrame)
+{
+    if ( NULL == inFrame ) return;
+    /* Reaching 0 makes the frame free for HVC_FrameAcquire() */
+    HVC_ATOMIC_DEC(&((HVC_FRAME *)inFrame)->refCount);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FramePoolFree                                                          */
+/* param    : HVC_FRAME_POOL    *inPool     pool                              */
+/* return   : INT32                         number of free frames             */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_FramePoolFree(const HVC_FRAME_POOL *inPool)
+{
+    INT32 i;
+    INT32 num = 0;
+
+    if ( NULL == inPool ) return 0;
+    for ( i = 0; i < inPool->frameNum; i++ ) {
+        if ( HVC_ATOMIC_LOAD(&inPool->pFrame[i].refCount) == 0 ) num++;
+    }
+    return num;
+}
@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Reference-counted frame pool
+*/
+
+#ifndef HVCFramePool_H__
+#define HVCFramePool_H__
+
+#include "HVCApi.h"
+
+/*----------------------------------------------------------------------------*/
+/* A frame is an HVC_RESULT with a reference count. The pool hands out the    */
+/* HVC_RESULT; whoever keeps it takes a reference with HVC_FrameAddRef() and  */
+/* drops it with HVC_FrameRelease(), and the frame is free again once the     */
+/* last reference is gone. Counting is atomic, so consumers on other threads  */
+/* may release frames; the storage is the caller's, nothing is allocated.     */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    HVC_RESULT      result;         /* First: the frame is its HVC_RESULT */
+    volatile INT32  refCount;       /* 0...free */
+} HVC_FRAME;
+
+struct HVC_FRAME_POOL_ {
+    HVC_FRAME       *pFrame;
+    INT32           frameNum;
+};
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FramePoolInit: every frame free                                        */
+/* param    : HVC_FRAME_POOL    *outPool    pool                              */
+/*          : HVC_FRAME         *inFrames   frame storage                     */
+/*          : INT32             inFrameNum  number of frames                  */
+/* return   : INT32                         0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_FramePoolInit(HVC_FRAME_POOL *outPool, HVC_FRAME *inFrames, INT32 inFrameNum);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameAcquire: a free frame, holding one reference                      */
+/* param    : HVC_FRAME_POOL    *ioPool     pool                              */
+/* return   : HVC_RESULT*                   frame, NULL if all are in use     */
+/*----------------------------------------------------------------------------*/
+HVC_RESULT *HVC_FrameAcquire(HVC_FRAME_POOL *ioPool);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameAddRef: one more reference to a frame of a pool                   */
+/* param    : HVC_RESULT        *inFrame    frame from HVC_FrameAcquire()     */
+/*----------------------------------------------------------------------------*/
+void HVC_FrameAddRef(HVC_RESULT *inFrame);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FrameRelease: drops a reference; the last one frees the frame          */
+/* param    : HVC_RESULT        *inFrame    frame from HVC_FrameAcquire()     */
+/*----------------------------------------------------------------------------*/
+void HVC_FrameRelease(HVC_RESULT *inFrame);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_FramePoolFree: frames nobody holds                                     */
+/* param    : HVC_FRAME_POOL    *inPool     pool                              */
+/* return   : INT32                         number of free frames             */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_FramePoolFree(const HVC_FRAME_POOL *inPool);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCFramePool_H__ */
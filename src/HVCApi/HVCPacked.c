@@ -0,0 +1,243 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Compact result frames
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "HVCPacked.h"
+
+#define HVC_PACKED_DETECT_MAX   35      /* Entries of bdResult/hdResult/fcResult */
+
+/* Where the values of a column live in HVC_RESULT */
+enum {
+    HVC_PACKED_GROUP_BODY = 0,
+    HVC_PACKED_GROUP_HAND,
+    HVC_PACKED_GROUP_FACE,
+    HVC_PACKED_GROUP_NUM
+};
+
+#define HVC_PACKED_TYPE_BODY    DETECT_RESULT
+#define HVC_PACKED_TYPE_HAND    DETECT_RESULT
+#define HVC_PACKED_TYPE_FACE    FACE_RESULT
+
+typedef struct {
+    INT32   group;      /* HVC_PACKED_GROUP_* */
+    INT32   flag;       /* HVC_ACTIV_* the column belongs to */
+    INT32   offset;     /* INT32 member in DETECT_RESULT/FACE_RESULT */
+} HVC_PACKED_FIELD;
+
+#define HVC_PACKED_FIELD_ENTRY(column, group, flag, member) \
+    { HVC_PACKED_GROUP_##group, flag, (INT32)offsetof(HVC_PACKED_TYPE_##group, member) },
+
+static const HVC_PACKED_FIELD m_packedField[HVC_PACKED_COLUMN_NUM] = {
+    HVC_PACKED_COLUMNS(HVC_PACKED_FIELD_ENTRY)
+};
+
+/* Array of one group in HVC_RESULT */
+typedef struct {
+    UINT8   *pBase;
+    INT32   stride;
+    INT32   num;
+} HVC_PACKED_ARRAY;
+
+static INT32 HVC_PackedCount(INT32 inNum)
+{
+    return (inNum > HVC_PACKED_DETECT_MAX) ? HVC_PACKED_DETECT_MAX : inNum;
+}
+
+static void HVC_GetPackedArrays(const HVC_RESULT *inHVCResult, HVC_PACKED_ARRAY *outArray)
+{
+    outArray[HVC_PACKED_GROUP_BODY].pBase = (UINT8 *)inHVCResult->bdResult.bdResult;
+    outArray[HVC_PACKED_GROUP_BODY].stride = (INT32)sizeof(DETECT_RESULT);
+    outArray[HVC_PACKED_GROUP_BODY].num = HVC_PackedCount(inHVCResult->bdResult.num);
+    outArray[HVC_PACKED_GROUP_HAND].pBase = (UINT8 *)inHVCResult->hdResult.hdResult;
+    outArray[HVC_PACKED_GROUP_HAND].stride = (INT32)sizeof(DETECT_RESULT);
+    outArray[HVC_PACKED_GROUP_HAND].num = HVC_PackedCount(inHVCResult->hdResult.num);
+    outArray[HVC_PACKED_GROUP_FACE].pBase = (UINT8 *)inHVCResult->fdResult.fcResult;
+    outArray[HVC_PACKED_GROUP_FACE].stride = (INT32)sizeof(FACE_RESULT);
+    outArray[HVC_PACKED_GROUP_FACE].num = HVC_PackedCount(inHVCResult->fdResult.num);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Offset of a column, or with HVC_PACKED_COLUMN_NUM the frame size          */
+/* param    : INT32         inExec          execution flag                    */
+/*          : INT32         *inNum          entries per HVC_PACKED_GROUP_*    */
+/*          : INT32         inColumnEnd     columns in front of it            */
+/* return   : INT32                         header and column bytes           */
+/*----------------------------------------------------------------------------*/
+static INT32 HVC_GetColumnOffset(INT32 inExec, const INT32 *inNum, INT32 inColumnEnd)
+{
+    INT32 size = (INT32)sizeof(HVC_PACKED);
+    INT32 i;
+
+    for ( i = 0; i < inColumnEnd; i++ ) {
+        if ( m_packedField[i].flag & inExec ) {
+            size += inNum[m_packedField[i].group] * (INT32)sizeof(INT16);
+        }
+    }
+    return size;
+}
+
+static void HVC_GetPackedNum(const HVC_PACKED *inPacked, INT32 *outNum)
+{
+    outNum[HVC_PACKED_GROUP_BODY] = HVC_PackedCount(inPacked->bodyNum);
+    outNum[HVC_PACKED_GROUP_HAND] = HVC_PackedCount(inPacked->handNum);
+    outNum[HVC_PACKED_GROUP_FACE] = HVC_PackedCount(inPacked->faceNum);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_GetPackedSize                                                          */
+/* param    : HVC_RESULT    *inHVCResult    result data                       */
+/* return   : INT32                         packed frame size                 */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_GetPackedSize(const HVC_RESULT *inHVCResult)
+{
+    HVC_PACKED_ARRAY array[HVC_PACKED_GROUP_NUM];
+    INT32 num[HVC_PACKED_GROUP_NUM];
+    INT32 i;
+
+    HVC_GetPackedArrays(inHVCResult, array);
+    for ( i = 0; i < HVC_PACKED_GROUP_NUM; i++ ) {
+        num[i] = array[i].num;
+    }
+    return HVC_GetColumnOffset(inHVCResult->executedFunc, num, HVC_PACKED_COLUMN_NUM);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_PackResult                                                             */
+/* param    : HVC_RESULT    *inHVCResult    result data                       */
+/*          : HVC_PACKED    *outPacked      packed frame                      */
+/*          : INT32         inSize          bytes available at outPacked      */
+/* return   : INT32                         packed frame size                 */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_PackResult(const HVC_RESULT *inHVCResult, HVC_PACKED *outPacked, INT32 inSize)
+{
+    HVC_PACKED_ARRAY array[HVC_PACKED_GROUP_NUM];
+    const HVC_PACKED_ARRAY *pArray;
+    const UINT8 *pValue;
+    INT16 *pColumn;
+    INT32 size;
+    INT32 i, j;
+
+    if((NULL == inHVCResult) || (NULL == outPacked)){
+        return HVC_ERROR_PARAMETER;
+    }
+    size = HVC_GetPackedSize(inHVCResult);
+    if ( inSize < size ) return HVC_ERROR_PARAMETER;
+
+    HVC_GetPackedArrays(inHVCResult, array);
+    outPacked->size = (UINT16)size;
+    outPacked->executedFunc = (UINT16)inHVCResult->executedFunc;
+    outPacked->bodyNum = (UINT8)array[HVC_PACKED_GROUP_BODY].num;
+    outPacked->handNum = (UINT8)array[HVC_PACKED_GROUP_HAND].num;
+    outPacked->faceNum = (UINT8)array[HVC_PACKED_GROUP_FACE].num;
+    outPacked->reserved = 0;
+
+    /* One column after the other, each walking its array */
+    pColumn = (INT16 *)(outPacked + 1);
+    for ( i = 0; i < HVC_PACKED_COLUMN_NUM; i++ ) {
+        if ( !(m_packedField[i].flag & inHVCResult->executedFunc) ) continue;
+        pArray = &array[m_packedField[i].group];
+        pValue = pArray->pBase + m_packedField[i].offset;
+        for ( j = 0; j < pArray->num; j++ ) {
+            *pColumn++ = (INT16)*(const INT32 *)pValue;
+            pValue += pArray->stride;
+        }
+    }
+    return size;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_UnpackResult                                                           */
+/* param    : HVC_PACKED    *inPacked       packed frame                      */
+/*          : HVC_IMAGE     *inImage        image (NULL...none)               */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/* return   : INT32                         0...normal                        */
+/*          :                               -1...parameter error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_UnpackResult(const HVC_PACKED *inPacked, const HVC_IMAGE *inImage, HVC_RESULT *outHVCResult)
+{
+    HVC_PACKED_ARRAY array[HVC_PACKED_GROUP_NUM];
+    const HVC_PACKED_ARRAY *pArray;
+    const INT16 *pColumn;
+    UINT8 *pValue;
+    INT32 num[HVC_PACKED_GROUP_NUM];
+    INT32 imageSize;
+    INT32 i, j;
+
+    if((NULL == inPacked) || (NULL == outHVCResult)){
+        return HVC_ERROR_PARAMETER;
+    }
+    HVC_GetPackedNum(inPacked, num);
+    if ( inPacked->size < HVC_GetColumnOffset(inPacked->executedFunc, num, HVC_PACKED_COLUMN_NUM) ) {
+        return HVC_ERROR_PARAMETER;
+    }
+
+    memset(&outHVCResult->bdResult, 0, sizeof(outHVCResult->bdResult));
+    memset(&outHVCResult->hdResult, 0, sizeof(outHVCResult->hdResult));
+    memset(&outHVCResult->fdResult, 0, sizeof(outHVCResult->fdResult));
+    outHVCResult->executedFunc = inPacked->executedFunc;
+    outHVCResult->bdResult.num = (UINT8)num[HVC_PACKED_GROUP_BODY];
+    outHVCResult->hdResult.num = (UINT8)num[HVC_PACKED_GROUP_HAND];
+    outHVCResult->fdResult.num = (UINT8)num[HVC_PACKED_GROUP_FACE];
+
+    HVC_GetPackedArrays(outHVCResult, array);
+    pColumn = (const INT16 *)(inPacked + 1);
+    for ( i = 0; i < HVC_PACKED_COLUMN_NUM; i++ ) {
+        if ( !(m_packedField[i].flag & inPacked->executedFunc) ) continue;
+        pArray = &array[m_packedField[i].group];
+        pValue = pArray->pBase + m_packedField[i].offset;
+        for ( j = 0; j < pArray->num; j++ ) {
+            *(INT32 *)pValue = *pColumn++;
+            pValue += pArray->stride;
+        }
+    }
+
+    /* The image travels separately, if at all */
+    outHVCResult->image.width = 0;
+    outHVCResult->image.height = 0;
+    if ( NULL != inImage ) {
+        imageSize = inImage->width * inImage->height;
+        if ( imageSize < 0 || imageSize > (INT32)sizeof(inImage->image) ) return HVC_ERROR_PARAMETER;
+        outHVCResult->image.width = inImage->width;
+        outHVCResult->image.height = inImage->height;
+        memcpy(outHVCResult->image.image, inImage->image, imageSize);
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_GetPackedColumn                                                        */
+/* param    : HVC_PACKED    *inPacked       packed frame                      */
+/*          : INT32         inColumn        HVC_PACKED_COLUMN                 */
+/* return   : const INT16*                  column, NULL if not in the frame  */
+/*----------------------------------------------------------------------------*/
+const INT16 *HVC_GetPackedColumn(const HVC_PACKED *inPacked, INT32 inColumn)
+{
+    INT32 num[HVC_PACKED_GROUP_NUM];
+
+    if ( (NULL == inPacked) || (inColumn < 0) || (inColumn >= HVC_PACKED_COLUMN_NUM) ||
+         !(m_packedField[inColumn].flag & inPacked->executedFunc) ) {
+        return NULL;
+    }
+    HVC_GetPackedNum(inPacked, num);
+    return (const INT16 *)((const UINT8 *)inPacked + HVC_GetColumnOffset(inPacked->executedFunc, num, inColumn));
+}
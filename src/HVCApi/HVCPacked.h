@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+
+/*
+    Compact result frames
+*/
+
+#ifndef HVCPacked_H__
+#define HVCPacked_H__
+
+#include "HVCApi.h"
+
+#ifndef INT16
+typedef     short               INT16;      /* 16 bit Signed   Integer  */
+#endif /* INT16 */
+#ifndef UINT16
+typedef     unsigned short      UINT16;     /* 16 bit Unsigned Integer  */
+#endif /* UINT16 */
+
+/*----------------------------------------------------------------------------*/
+/* A packed frame holds the results of one HVC_RESULT without the image.     */
+/* Every value the device sends fits 16 bits, so nothing is lost.             */
+/* HVC_PACKED is followed by one INT16 column per value, in                   */
+/* HVC_PACKED_COLUMNS() order. A column is only there if the function it     */
+/* belongs to was executed, and has bodyNum, handNum or faceNum entries.      */
+/* One face with detection only takes 16 bytes.                               */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    UINT16  size;           /* Bytes of the frame, this header included */
+    UINT16  executedFunc;   /* Execution flag */
+    UINT8   bodyNum;
+    UINT8   handNum;
+    UINT8   faceNum;
+    UINT8   reserved;
+} HVC_PACKED;
+
+/* X(column, group, flag, member): member of DETECT_RESULT (BODY, HAND) */
+/* or FACE_RESULT (FACE)                                                */
+#define HVC_PACKED_COLUMNS(X) \
+    X(BODY_POSX,                BODY, HVC_ACTIV_BODY_DETECTION,         posX) \
+    X(BODY_POSY,                BODY, HVC_ACTIV_BODY_DETECTION,         posY) \
+    X(BODY_SIZE,                BODY, HVC_ACTIV_BODY_DETECTION,         size) \
+    X(BODY_CONFIDENCE,          BODY, HVC_ACTIV_BODY_DETECTION,         confidence) \
+    X(HAND_POSX,                HAND, HVC_ACTIV_HAND_DETECTION,         posX) \
+    X(HAND_POSY,                HAND, HVC_ACTIV_HAND_DETECTION,         posY) \
+    X(HAND_SIZE,                HAND, HVC_ACTIV_HAND_DETECTION,         size) \
+    X(HAND_CONFIDENCE,          HAND, HVC_ACTIV_HAND_DETECTION,         confidence) \
+    X(FACE_POSX,                FACE, HVC_ACTIV_FACE_DETECTION,         dtResult.posX) \
+    X(FACE_POSY,                FACE, HVC_ACTIV_FACE_DETECTION,         dtResult.posY) \
+    X(FACE_SIZE,                FACE, HVC_ACTIV_FACE_DETECTION,         dtResult.size) \
+    X(FACE_CONFIDENCE,          FACE, HVC_ACTIV_FACE_DETECTION,         dtResult.confidence) \
+    X(DIR_YAW,                  FACE, HVC_ACTIV_FACE_DIRECTION,         dirResult.yaw) \
+    X(DIR_PITCH,                FACE, HVC_ACTIV_FACE_DIRECTION,         dirResult.pitch) \
+    X(DIR_ROLL,                 FACE, HVC_ACTIV_FACE_DIRECTION,         dirResult.roll) \
+    X(DIR_CONFIDENCE,           FACE, HVC_ACTIV_FACE_DIRECTION,         dirResult.confidence) \
+    X(AGE,                      FACE, HVC_ACTIV_AGE_ESTIMATION,         ageResult.age) \
+    X(AGE_CONFIDENCE,           FACE, HVC_ACTIV_AGE_ESTIMATION,         ageResult.confidence) \
+    X(GENDER,                   FACE, HVC_ACTIV_GENDER_ESTIMATION,      genderResult.gender) \
+    X(GENDER_CONFIDENCE,        FACE, HVC_ACTIV_GENDER_ESTIMATION,      genderResult.confidence) \
+    X(GAZE_LR,                  FACE, HVC_ACTIV_GAZE_ESTIMATION,        gazeResult.gazeLR) \
+    X(GAZE_UD,                  FACE, HVC_ACTIV_GAZE_ESTIMATION,        gazeResult.gazeUD) \
+    X(BLINK_L,                  FACE, HVC_ACTIV_BLINK_ESTIMATION,       blinkResult.ratioL) \
+    X(BLINK_R,                  FACE, HVC_ACTIV_BLINK_ESTIMATION,       blinkResult.ratioR) \
+    X(EXPRESSION_TOP,           FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.topExpression) \
+    X(EXPRESSION_TOPSCORE,      FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.topScore) \
+    X(EXPRESSION_NEUTRAL,       FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.score[0]) \
+    X(EXPRESSION_HAPPINESS,     FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.score[1]) \
+    X(EXPRESSION_SURPRISE,      FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.score[2]) \
+    X(EXPRESSION_ANGER,         FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.score[3]) \
+    X(EXPRESSION_SADNESS,       FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.score[4]) \
+    X(EXPRESSION_DEGREE,        FACE, HVC_ACTIV_EXPRESSION_ESTIMATION,  expressionResult.degree) \
+    X(RECOGNITION_UID,          FACE, HVC_ACTIV_FACE_RECOGNITION,       recognitionResult.uid) \
+    X(RECOGNITION_CONFIDENCE,   FACE, HVC_ACTIV_FACE_RECOGNITION,       recognitionResult.confidence) \
+    X(VERIFY_AUTH,              FACE, HVC_ACTIV_FACE_VERIFY,            authResult.auth) \
+    X(VERIFY_CONFIDENCE,        FACE, HVC_ACTIV_FACE_VERIFY,            authResult.confidence)
+
+#define HVC_PACKED_COLUMN_ENUM(column, group, flag, member)   HVC_PACKED_##column,
+
+typedef enum {
+    HVC_PACKED_COLUMNS(HVC_PACKED_COLUMN_ENUM)
+    HVC_PACKED_COLUMN_NUM
+} HVC_PACKED_COLUMN;
+
+/* Largest packed frame: every column with 35 entries */
+#define HVC_PACKED_SIZE_MAX     ((INT32)sizeof(HVC_PACKED) + HVC_PACKED_COLUMN_NUM * 35 * (INT32)sizeof(INT16))
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* HVC_GetPackedSize: bytes HVC_PackResult() needs for a result               */
+/* param    : HVC_RESULT    *inHVCResult    result data                       */
+/* return   : INT32                         packed frame size                 */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_GetPackedSize(const HVC_RESULT *inHVCResult);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_PackResult: packs the results of inHVCResult; the image is left out   */
+/* param    : HVC_RESULT    *inHVCResult    result data                       */
+/*          : HVC_PACKED    *outPacked      packed frame                      */
+/*          : INT32         inSize          bytes available at outPacked      */
+/* return   : INT32                         packed frame size                 */
+/*          :                               -1...parameter error (too small)  */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_PackResult(const HVC_RESULT *inHVCResult, HVC_PACKED *outPacked, INT32 inSize);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_UnpackResult: HVC_RESULT from a packed frame                           */
+/* param    : HVC_PACKED    *inPacked       packed frame                      */
+/*          : HVC_IMAGE     *inImage        image kept with the frame         */
+/*          :                               (NULL...none, width/height 0)     */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/* return   : INT32                         0...normal                        */
+/*          :                               -1...parameter error              */
+/* Values of functions that were not executed are 0.                          */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_UnpackResult(const HVC_PACKED *inPacked, const HVC_IMAGE *inImage, HVC_RESULT *outHVCResult);
+
+/*----------------------------------------------------------------------------*/
+/* HVC_GetPackedColumn: one value of every body, hand or face                 */
+/* param    : HVC_PACKED    *inPacked       packed frame                      */
+/*          : INT32         inColumn        HVC_PACKED_COLUMN                 */
+/* return   : const INT16*                  column, NULL if not in the frame  */
+/*----------------------------------------------------------------------------*/
+const INT16 *HVC_GetPackedColumn(const HVC_PACKED *inPacked, INT32 inColumn);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCPacked_H__ */
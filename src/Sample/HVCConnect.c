@@ -0,0 +1,232 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Connection at the fastest stable baud rate
+*/
+
+#include <string.h>
+#include "HVCApi.h"
+#include "HVCConnect.h"
+
+#define HVC_CONNECT_DETECT_TRIES    2       /* GetVersion attempts per rate while detecting */
+#define HVC_CONNECT_PROBE_COUNT     3       /* GetVersion round trips that must all match */
+#define HVC_CONNECT_PROBE_TIMEOUT   500     /* ms per round trip (25 bytes take 26ms at 9600) */
+#define HVC_CONNECT_SET_TIMEOUT     1000    /* ms for HVC_SetBaudRate */
+
+const int g_HVCBaudRate[HVC_BAUDRATE_NUM] = {
+    9600, 38400, 115200, 230400, 460800, 921600
+};
+
+/* Only a real serial port has a rate the host can change */
+static int IsSerial(HCOM hCom)
+{
+    return hCom->pOps == &com_tty_ops;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Short integrity probe: every GetVersion answer must match the reference    */
+/* param    : HCOM          hCom        port                                  */
+/*          : HVC_VERSION   *inRef      answer taken at the detected rate     */
+/* return   : int                       1...line is clean, 0...errors         */
+/*----------------------------------------------------------------------------*/
+static int Probe(HCOM hCom, const HVC_VERSION *inRef)
+{
+    HVC_VERSION version;
+    UINT8 status;
+    int i;
+
+    for ( i = 0; i < HVC_CONNECT_PROBE_COUNT; i++ ) {
+        memset(&version, 0, sizeof(version));
+        if ( HVC_GetVersion(hCom, HVC_CONNECT_PROBE_TIMEOUT, &version, &status) != 0 || status != 0 ) {
+            return 0;
+        }
+        if ( memcmp(&version, inRef, sizeof(version)) != 0 ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Find the rate the device is listening at                                   */
+/* param    : HVC_CONNECT_OPEN_FUNC inOpen  opens the host port               */
+/*          : void      *pParam         passed to inOpen                      */
+/*          : INT32     *ioRate         in: rate to try first,                */
+/*                                      out: detected rate                    */
+/*          : HVC_VERSION *outRef       GetVersion answer                     */
+/* return   : HCOM                      port at the detected rate, NULL...    */
+/*                                      the device answers at no rate         */
+/*----------------------------------------------------------------------------*/
+static HCOM Detect(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, INT32 *ioRate, HVC_VERSION *outRef)
+{
+    INT32 order[HVC_BAUDRATE_NUM];
+    INT32 nOrder = 0;
+    INT32 i, k;
+    int bSerial;
+    UINT8 status;
+    HCOM hCom;
+
+    /* The last known rate, the power-on default, then fastest first */
+    if ( *ioRate > 0 && *ioRate < HVC_BAUDRATE_NUM ) order[nOrder++] = *ioRate;
+    order[nOrder++] = 0;
+    for ( i = HVC_BAUDRATE_NUM - 1; i > 0; i-- ) {
+        if ( i != *ioRate ) order[nOrder++] = i;
+    }
+
+    for ( i = 0; i < nOrder; i++ ) {
+        hCom = inOpen(pParam, (unsigned long)g_HVCBaudRate[order[i]]);
+        if ( hCom == NULL ) return NULL;
+        /* The first try may only flush garbage the device kept from a */
+        /* mismatched rate                                              */
+        for ( k = 0; k < HVC_CONNECT_DETECT_TRIES; k++ ) {
+            if ( HVC_GetVersion(hCom, HVC_CONNECT_PROBE_TIMEOUT, outRef, &status) == 0 && status == 0 ) {
+                *ioRate = order[i];
+                return hCom;
+            }
+        }
+        bSerial = IsSerial(hCom);
+        com_close(hCom);
+        /* Other backends do not depend on the rate */
+        if ( !bSerial ) break;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Move the device and the host port to another rate and verify the line     */
+/* param    : HCOM      *ioCom          port; replaced by the reopened port,  */
+/*                                      NULL if the device was lost           */
+/*          : INT32     *ioRate         rate of *ioCom                        */
+/*          : INT32     inTo            new rate                              */
+/*          : HVC_VERSION *inRef        expected GetVersion answer            */
+/* return   : int                       1...now at inTo, 0...still at (or     */
+/*                                      back to) *ioRate                      */
+/*----------------------------------------------------------------------------*/
+static int Switch(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, HCOM *ioCom, INT32 *ioRate, INT32 inTo, const HVC_VERSION *inRef)
+{
+    INT32 from = *ioRate;
+    UINT8 status;
+    int bBack;
+
+    if ( HVC_SetBaudRate(*ioCom, HVC_CONNECT_SET_TIMEOUT, inTo, &status) != 0 || status != 0 ) {
+        /* Refused: the device is still at the old rate */
+        return 0;
+    }
+    com_close(*ioCom);
+
+    *ioCom = inOpen(pParam, (unsigned long)g_HVCBaudRate[inTo]);
+    if ( *ioCom == NULL ) return 0;
+    if ( Probe(*ioCom, inRef) ) {
+        *ioRate = inTo;
+        return 1;
+    }
+
+    /* Talk the device back down over the failing line, then check again */
+    bBack = (HVC_SetBaudRate(*ioCom, HVC_CONNECT_SET_TIMEOUT, from, &status) == 0 && status == 0);
+    com_close(*ioCom);
+    *ioCom = NULL;
+    if ( bBack ) {
+        *ioCom = inOpen(pParam, (unsigned long)g_HVCBaudRate[from]);
+        if ( *ioCom != NULL && !Probe(*ioCom, inRef) ) {
+            com_close(*ioCom);
+            *ioCom = NULL;
+        }
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Connect at the fastest rate the line carries cleanly                       */
+/* param    : HVC_CONNECT_OPEN_FUNC inOpen  opens the host port at a rate     */
+/*          : void      *pParam         passed to inOpen                      */
+/*          : INT32     inMaxRate       highest rate to try (HVC_SetBaudRate  */
+/*                                      index, 5...921600bps)                 */
+/*          : INT32     *ioRate         in: rate the device was last at       */
+/*                                      (-1...unknown), out: rate in use      */
+/* return   : HCOM                      port, NULL...no device                */
+/*                                                                            */
+/* The device's current rate is detected first; the rate then steps up the    */
+/* ladder one rung at a time, each rung verified by a short GetVersion probe, */
+/* and the connection stays at the last rung that passed.                     */
+/*----------------------------------------------------------------------------*/
+HCOM HVC_ConnectFastest(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, INT32 inMaxRate, INT32 *ioRate)
+{
+    HVC_VERSION ref;
+    HCOM hCom;
+    INT32 rate = *ioRate;
+    UINT8 status;
+
+    if ( inMaxRate < 0 ) inMaxRate = 0;
+    if ( inMaxRate >= HVC_BAUDRATE_NUM ) inMaxRate = HVC_BAUDRATE_NUM - 1;
+
+    hCom = Detect(inOpen, pParam, &rate, &ref);
+    if ( hCom == NULL ) return NULL;
+
+    if ( !IsSerial(hCom) ) {
+        /* Nothing to tune on the host, but the device still follows */
+        if ( rate != inMaxRate &&
+             HVC_SetBaudRate(hCom, HVC_CONNECT_SET_TIMEOUT, inMaxRate, &status) == 0 && status == 0 ) {
+            rate = inMaxRate;
+        }
+        *ioRate = rate;
+        return hCom;
+    }
+
+    /* Above the limit: come down to it first */
+    if ( rate > inMaxRate ) {
+        Switch(inOpen, pParam, &hCom, &rate, inMaxRate, &ref);
+    }
+    while ( hCom != NULL && rate < inMaxRate ) {
+        if ( !Switch(inOpen, pParam, &hCom, &rate, rate + 1, &ref) ) break;
+    }
+
+    if ( hCom == NULL ) {
+        /* Lost track of the device during a switch: find it again */
+        hCom = Detect(inOpen, pParam, &rate, &ref);
+    }
+    *ioRate = rate;
+    return hCom;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Fall back one rung after communication errors                              */
+/* param    : HVC_CONNECT_OPEN_FUNC inOpen  opens the host port at a rate     */
+/*          : void      *pParam         passed to inOpen                      */
+/*          : HCOM      inCom           port in use (closed by this call)     */
+/*          : INT32     *ioRate         in: rate in use, out: new rate        */
+/* return   : HCOM                      port, NULL...device lost              */
+/*----------------------------------------------------------------------------*/
+HCOM HVC_ConnectStepDown(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, HCOM inCom, INT32 *ioRate)
+{
+    HVC_VERSION ref;
+    HCOM hCom;
+    INT32 rate = *ioRate;
+
+    com_close(inCom);
+    hCom = Detect(inOpen, pParam, &rate, &ref);
+    if ( hCom == NULL ) return NULL;
+
+    /* Only if the device is still at the rate that gave trouble */
+    if ( IsSerial(hCom) && rate > 0 && rate >= *ioRate ) {
+        Switch(inOpen, pParam, &hCom, &rate, rate - 1, &ref);
+        if ( hCom == NULL ) {
+            hCom = Detect(inOpen, pParam, &rate, &ref);
+        }
+    }
+    *ioRate = rate;
+    return hCom;
+}
@@ -0,0 +1,50 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Connection at the fastest stable baud rate
+*/
+
+#ifndef HVCConnect_H__
+#define HVCConnect_H__
+
+#include "HVCApi.h"
+#include "uart.h"
+
+/* Baud rates, indexed like HVC_SetBaudRate() inRate */
+#define HVC_BAUDRATE_NUM    6
+extern const int g_HVCBaudRate[HVC_BAUDRATE_NUM];   /* 9600 ... 921600 */
+
+/*----------------------------------------------------------------------------*/
+/* Opens the host port at a given baud rate                                   */
+/* param    : void          *pParam     caller's context                      */
+/*          : unsigned long inBaudRate  rate for the host side of the line    */
+/* return   : HCOM                      port, NULL on failure                 */
+/*----------------------------------------------------------------------------*/
+typedef HCOM (*HVC_CONNECT_OPEN_FUNC)(void *pParam, unsigned long inBaudRate);
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+HCOM HVC_ConnectFastest(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, INT32 inMaxRate, INT32 *ioRate);
+HCOM HVC_ConnectStepDown(HVC_CONNECT_OPEN_FUNC inOpen, void *pParam, HCOM inCom, INT32 *ioRate);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCConnect_H__ */
@@ -29,8 +29,11 @@
 #include <malloc.h>
 #include "uart.h"
 #include "HVCApi.h"
+#include "HVCFramePool.h"
+#include "HVCConfig.h"
 #include "HVCDef.h"
 #include "HVCExtraUartFunc.h"
+#include "HVCConnect.h"
 #include "STBWrap.h"
 
 #define LOGBUFFERSIZE   16384
@@ -38,11 +41,16 @@
 #define UART_GENERAL_TIMEOUT              1000
 #define UART_EXECUTE_TIMEOUT              ((10+10+6+3+15+15+1+1+15+10)*1000)
                                                           /* HVC execute command signal timeout period */
+#define UART_ALBUM_TIMEOUT               15000            /* HVC save/load album command signal timeout period */
+                                                          /* (a full album takes ~9s on the line at 921600bps) */
 #define UART_WRITE_ALBUM_TIMEOUT          5000            /* HVC write album command signal timeout period */
 #define UART_REFORMAT_ALBUM_TIMEOUT      10000            /* HVC reformat album command signal timeout period */
 #define UART_REGIST_COUNT_TIMEOUT        (UART_REFORMAT_ALBUM_TIMEOUT + 1000)            
                                                           /* HVC set regist count command signal timeout period */
 
+#define SAMPLE_FRAME_NUM                     3            /* Pooled frames: in flight, being printed, spare */
+#define SAMPLE_STREAM_DEPTH                  1            /* Frames computed ahead of the one being printed */
+
 #define SENSOR_ROLL_ANGLE_DEFAULT            0            /* Camera angle setting (0) */
 
 #define BODY_THRESHOLD_DEFAULT             500            /* Threshold for Human Body Detection */
@@ -94,54 +102,159 @@ void SaveBitmapFile(int nWidth, int nHeight, unsigned char *unImageBuffer, const
 int kbhit(void);
 #endif
 
-void SampleFuncExecution(char *pStr, int stb_use);              /* Detection/Estimation         */
-void SampleFuncRecognitionIdentify(char *pStr, int stb_use);    /* Recognition(Identify)        */
-void SampleFuncRecognitionVerify(char *pStr);                   /* Recognition(Verify)          */
-void SampleFuncRegisterData(char *pStr);                        /* Register data                */
-void SampleFuncDeleteData(char *pStr);                          /* Delete specified data        */
-void SampleFuncDeleteUser(char *pStr);                          /* Delete specified User        */
-void SampleFuncDeleteAll(char *pStr);                           /* Delete all data              */
-void SampleFuncSaveAlbum(char *pStr);                           /* Save Album                   */
-void SampleFuncLoadAlbum(char *pStr);                           /* Load Album                   */
-void SampleFuncWriteAlbum(char *pStr);                          /* Save Album on Flash ROM      */
-void SampleFuncReformatAlbum(char *pStr);                       /* Reformat Flash ROM           */
-void SampleFuncSetRegistCount(char *pStr);                      /* Set regist user count max    */
-void SampleFuncGetRegistCount(char *pStr);                      /* Get regist user count max    */
+void SampleFuncExecution(HCOM hCom, char *pStr, int stb_use, HVC_FRAME_POOL *pPool);            /* Detection/Estimation         */
+void SampleFuncRecognitionIdentify(HCOM hCom, char *pStr, int stb_use, HVC_FRAME_POOL *pPool);  /* Recognition(Identify)        */
+void SampleFuncRecognitionVerify(HCOM hCom, char *pStr, HVC_FRAME_POOL *pPool);                 /* Recognition(Verify)          */
+void SampleFuncRegisterData(HCOM hCom, char *pStr);                     /* Register data                */
+void SampleFuncDeleteData(HCOM hCom, char *pStr);                       /* Delete specified data        */
+void SampleFuncDeleteUser(HCOM hCom, char *pStr);                       /* Delete specified User        */
+void SampleFuncDeleteAll(HCOM hCom, char *pStr);                        /* Delete all data              */
+void SampleFuncSaveAlbum(HCOM hCom, char *pStr);                        /* Save Album                   */
+void SampleFuncLoadAlbum(HCOM hCom, char *pStr);                        /* Load Album                   */
+void SampleFuncWriteAlbum(HCOM hCom, char *pStr);                       /* Save Album on Flash ROM      */
+void SampleFuncReformatAlbum(HCOM hCom, char *pStr);                    /* Reformat Flash ROM           */
+void SampleFuncSetRegistCount(HCOM hCom, char *pStr);                   /* Set regist user count max    */
+void SampleFuncGetRegistCount(HCOM hCom, char *pStr);                   /* Get regist user count max    */
+void SampleFuncTransportStats(HCOM hCom, char *pStr);                   /* Transport statistics         */
 
 
 /*----------------------------------------------------------------------------*/
 /* UART send signal                                                           */
-/* param    : int   inDataSize  send signal data                              */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataSize  send signal data                              */
 /*          : UINT8 *inData     data length                                   */
 /* return   : int               send signal complete data number              */
 /*----------------------------------------------------------------------------*/
-int UART_SendData(int inDataSize, UINT8 *inData)
+int UART_SendData(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData)
 {
     /* Send Data */
-    int ret = com_send(inData, inDataSize);
+    int ret = com_send((HCOM)inHandle, inData, inDataSize);
     return ret;
 }
 
+/*----------------------------------------------------------------------------*/
+/* UART send signal while responses to earlier commands are still due         */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataSize      send signal data length                   */
+/*          : UINT8 *inData         send signal data                          */
+/* return   : int                   send signal complete data number          */
+/*----------------------------------------------------------------------------*/
+int UART_SendDataPipelined(HVC_HANDLE inHandle, int inDataSize, UINT8 *inData)
+{
+    COM_SPAN vec;
+
+    vec.pData = inData;
+    vec.nSize = inDataSize;
+    /* Send Data, keeping the responses not read yet */
+    return com_sendv_flags((HCOM)inHandle, &vec, 1, COM_SEND_KEEP_RX);
+}
+
+/*----------------------------------------------------------------------------*/
+/* UART send signal gathered from several buffers                             */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inDataNum       number of buffers                         */
+/*          : UINT8 **inData        buffers, in send order                    */
+/*          : int   *inDataSize     size of each buffer                       */
+/* return   : int                   send signal complete data number          */
+/*----------------------------------------------------------------------------*/
+int UART_SendDataV(HVC_HANDLE inHandle, int inDataNum, UINT8 **inData, int *inDataSize)
+{
+    COM_SPAN vec[UART_SEND_VEC_MAX];
+    int i;
+
+    if ( inDataNum > UART_SEND_VEC_MAX ) return 0;
+    for ( i = 0; i < inDataNum; i++ ) {
+        vec[i].pData = inData[i];
+        vec[i].nSize = inDataSize[i];
+    }
+    /* Send Data */
+    return com_sendv((HCOM)inHandle, vec, inDataNum);
+}
+
 /*----------------------------------------------------------------------------*/
 /* UART receive signal                                                        */
-/* param    : int   inTimeOutTime   timeout time (ms)                         */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inTimeOutTime   timeout time (ms)                         */
 /*          : int   *inDataSize     receive signal data size                  */
 /*          : UINT8 *outResult      receive signal data                       */
 /* return   : int                   receive signal complete data number       */
 /*----------------------------------------------------------------------------*/
-int UART_ReceiveData(int inTimeOutTime, int inDataSize, UINT8 *outResult)
+int UART_ReceiveData(HVC_HANDLE inHandle, int inTimeOutTime, int inDataSize, UINT8 *outResult)
 {
     /* Receive Data */
-    int ret = com_recv(inTimeOutTime, outResult, inDataSize);
+    int ret = com_recv((HCOM)inHandle, inTimeOutTime, outResult, inDataSize);
     return ret;
 }
 
+/*----------------------------------------------------------------------------*/
+/* UART received data size                                                    */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/* return   : int                   bytes received and not yet read           */
+/*----------------------------------------------------------------------------*/
+int UART_GetReceiveSize(HVC_HANDLE inHandle)
+{
+    return com_length((HCOM)inHandle);
+}
+
+/*----------------------------------------------------------------------------*/
+/* UART resynchronisation notice                                              */
+/* param    : HVC_HANDLE inHandle   device handle given to the HVC_* call     */
+/*          : int   inSkipSize      bytes skipped                             */
+/* return   : void                                                            */
+/*----------------------------------------------------------------------------*/
+void UART_NotifyResync(HVC_HANDLE inHandle, int inSkipSize)
+{
+    com_count_resync((HCOM)inHandle, inSkipSize);
+}
+
 /* Print Log Message */
 static void PrintLog(char *pStr)
 {
     puts(pStr);
 }
 
+/* Open the port named on the command line:                          */
+/* a COM number, or a transport spec such as "replay:capture.bin".   */
+static HCOM OpenPort(const char *pPort, S_STAT *pStat)
+{
+    const char *p;
+
+    for ( p = pPort; isdigit((unsigned char)*p); p++ ) ;
+    if ( *pPort != '\0' && *p == '\0' ) {
+        pStat->com_num = atoi(pPort);
+        return com_init(pStat);
+    }
+    return com_open(pPort, pStat->BaudRate);
+}
+
+/* Port named on the command line, reopened at each rate tried */
+typedef struct {
+    const char  *pPort;
+    S_STAT      *pStat;
+    const char  *pCapture;      /* NULL...no capture */
+    int         nOpened;
+} SAMPLE_PORT;
+
+static HCOM OpenAt(void *pParam, unsigned long inBaudRate)
+{
+    SAMPLE_PORT *pPort = (SAMPLE_PORT *)pParam;
+    HCOM hCom;
+
+    pPort->pStat->BaudRate = inBaudRate;
+    hCom = OpenPort(pPort->pPort, pPort->pStat);
+    if ( hCom == NULL ) return NULL;
+
+    /* Record the raw traffic, baud rate changes included */
+    if ( pPort->pCapture != NULL &&
+         com_capture_start(hCom, pPort->pCapture, pPort->nOpened > 0) != 0 ) {
+        PrintLog("Failed to create the capture file.\n");
+        com_close(hCom);
+        return NULL;
+    }
+    pPort->nOpened++;
+    return hCom;
+}
+
 
 /* HVC Execute Processing  */
 int main(int argc, char *argv[])
@@ -161,12 +274,8 @@ int main(int argc, char *argv[])
     UINT8 status;
     HVC_VERSION version;
 
-    INT32 angleNo;
-    HVC_THRESHOLD threshold;
-    HVC_SIZERANGE sizeRange;
-    INT32 pose;
-    INT32 angle;
-    INT32 verifyTh;
+    HVC_CONFIG config;
+    HVC_CONFIG_CACHE configCache;   /* What the device holds */
 
     int i;
     int revision;
@@ -178,8 +287,15 @@ int main(int argc, char *argv[])
 #endif
 
     char *pStr;         /* String Buffer for logging output */
+    HVC_FRAME *pFrames; /* Result frames, shared by all functions */
+    HVC_FRAME_POOL framePool;
 
     S_STAT serialStat;  /* Serial port set value*/
+    SAMPLE_PORT port;   /* Port and capture to (re)open */
+    HCOM hCom;          /* Opened serial port */
+    INT32 rate;         /* Baud rate in use (index) */
+    COM_STATS stats;
+    unsigned long long nTimeouts;
 
 
     /******************************/
@@ -188,20 +304,14 @@ int main(int argc, char *argv[])
     serialStat.com_num = 0;
     serialStat.BaudRate = 0;    /* Default Baudrate = 9600 */
 
-    if ( argc < 3 || argc > 4) {
-    PrintLog("Usage: sample.exe <com_port> <baudrate> [STB_ON|STB_OFF]\n");
-        return (-1);
-    }
-
-    serialStat.com_num  = atoi(argv[1]);
-    if ( com_init(&serialStat) == 0 ) {
-        PrintLog("Failed to open COM port.\n");
+    if ( argc < 3 || argc > 5) {
+    PrintLog("Usage: sample.exe <com_port> <baudrate> [STB_ON|STB_OFF] [capture_file]\n");
         return (-1);
     }
 
-    serialStat.BaudRate = atoi(argv[2]);
+    /* The given rate is the upper limit */
     for ( inRate = 0; inRate<(int)(sizeof(listBaudRate)/sizeof(int)); inRate++ ) {
-        if ( listBaudRate[inRate] == (int)serialStat.BaudRate ) {
+        if ( listBaudRate[inRate] == atoi(argv[2]) ) {
             break;
         }
     }
@@ -210,19 +320,25 @@ int main(int argc, char *argv[])
         return (-1);
     }
 
-    /* Change Baudrate */
-    ret = HVC_SetBaudRate(UART_GENERAL_TIMEOUT, inRate, &status);
-    if ( (ret != 0) || (status != 0) ) {
-        PrintLog("HVCApi(HVC_SetBaudRate) Error.\n");
+    /* Find the device at whatever rate it is at, then climb to the fastest */
+    /* rate up to the limit that passes the integrity probe                 */
+    port.pPort = argv[1];
+    port.pStat = &serialStat;
+    port.pCapture = (argc == 5) ? argv[4] : NULL;
+    port.nOpened = 0;
+    rate = -1;
+    hCom = HVC_ConnectFastest(OpenAt, &port, inRate, &rate);
+    if ( hCom == NULL ) {
+        PrintLog("Failed to connect to HVC-P2.\n");
         return (-1);
     }
+    printf_s("Connected at %d baud\n", listBaudRate[rate]);
 
-    if ( com_init(&serialStat) == 0 ) {
-        PrintLog("Failed to open COM port.\n");
-        return (-1);
-    }
+    /* Nothing is known about a freshly connected device */
+    memset(&configCache, 0, sizeof(configCache));
+    HVC_ConfigInvalidate(&configCache, HVC_CONFIG_ALL);
 
-    if ( argc == 4 ) {        
+    if ( argc >= 4 ) {        
         /* STB_ON/STB_OFF */
         if (strcmp (argv[3] ,"STB_ON") == 0) {
             stb_use = STB_ON;
@@ -244,11 +360,22 @@ int main(int argc, char *argv[])
     }
     memset(pStr, 0, LOGBUFFERSIZE);
 
+    /*********************************/
+    /* Result frame allocation       */
+    /*********************************/
+    pFrames = (HVC_FRAME *)malloc(sizeof(HVC_FRAME) * SAMPLE_FRAME_NUM);
+    if ( pFrames == NULL ) {
+        PrintLog("Failed to allocate Result Frames.\n");
+        free(pStr);
+        return (-1);
+    }
+    HVC_FramePoolInit(&framePool, pFrames, SAMPLE_FRAME_NUM);
+
     do {
         /*********************************/
         /* Get Model and Version         */
         /*********************************/
-        ret = HVC_GetVersion(UART_GENERAL_TIMEOUT, &version, &status);
+        ret = HVC_GetVersion(hCom, UART_GENERAL_TIMEOUT, &version, &status);
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetVersion) Error : %d\n", ret);
             break;
@@ -268,170 +395,67 @@ int main(int argc, char *argv[])
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "%d.%d.%d.%d", version.major, version.minor, version.relese, revision);
 
         /*********************************/
-        /* Set Camera Angle              */
+        /* Set Configuration             */
         /*********************************/
-        angleNo = SENSOR_ROLL_ANGLE_DEFAULT;
-
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetCameraAngle : 0x%02x", angleNo);
-
-        ret = HVC_SetCameraAngle(UART_GENERAL_TIMEOUT, angleNo, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetCameraAngle) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetCameraAngle Response Error : 0x%02X", status);
-        }
-
-        angleNo = 0xff;
-
-        ret = HVC_GetCameraAngle(UART_GENERAL_TIMEOUT, &angleNo, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetCameraAngle) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetCameraAngle Response Error : 0x%02X", status);
-        }
-        else {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetCameraAngle : 0x%02x", angleNo);
-        }
-
-        /*********************************/
-        /* Set Threshold Values          */
-        /*********************************/
-        threshold.bdThreshold = BODY_THRESHOLD_DEFAULT;
-        threshold.hdThreshold = HAND_THRESHOLD_DEFAULT;
-        threshold.dtThreshold = FACE_THRESHOLD_DEFAULT;
-        threshold.rsThreshold = REC_THRESHOLD_DEFAULT;
-
+        /* Only the fields the device does not hold yet are sent */
+        config.cameraAngle = SENSOR_ROLL_ANGLE_DEFAULT;
+        config.threshold.bdThreshold = BODY_THRESHOLD_DEFAULT;
+        config.threshold.hdThreshold = HAND_THRESHOLD_DEFAULT;
+        config.threshold.dtThreshold = FACE_THRESHOLD_DEFAULT;
+        config.threshold.rsThreshold = REC_THRESHOLD_DEFAULT;
+        config.sizeRange.bdMinSize = BODY_SIZE_RANGE_MIN_DEFAULT;
+        config.sizeRange.bdMaxSize = BODY_SIZE_RANGE_MAX_DEFAULT;
+        config.sizeRange.hdMinSize = HAND_SIZE_RANGE_MIN_DEFAULT;
+        config.sizeRange.hdMaxSize = HAND_SIZE_RANGE_MAX_DEFAULT;
+        config.sizeRange.dtMinSize = FACE_SIZE_RANGE_MIN_DEFAULT;
+        config.sizeRange.dtMaxSize = FACE_SIZE_RANGE_MAX_DEFAULT;
+        config.facePose = FACE_POSE_DEFAULT;
+        config.faceAngle = FACE_ANGLE_DEFAULT;
+        config.verifyThreshold = VERIFY_THRESHOLD_DEFAULT;
+
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetCameraAngle : 0x%02x", config.cameraAngle);
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetThreshold : Body=%4d Hand=%4d Face=%4d Recognition=%4d",
-                         threshold.bdThreshold, threshold.hdThreshold, threshold.dtThreshold, threshold.rsThreshold);
-
-        ret = HVC_SetThreshold(UART_GENERAL_TIMEOUT, &threshold, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetThreshold) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetThreshold Response Error : 0x%02X", status);
-        }
-
-        threshold.bdThreshold = 0;
-        threshold.hdThreshold = 0;
-        threshold.dtThreshold = 0;
-        threshold.rsThreshold = 0;
-
-        ret = HVC_GetThreshold(UART_GENERAL_TIMEOUT, &threshold, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetThreshold) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetThreshold Response Error : 0x%02X", status);
-        }
-        else {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetThreshold : Body=%4d Hand=%4d Face=%4d Recognition=%4d",
-                             threshold.bdThreshold, threshold.hdThreshold, threshold.dtThreshold, threshold.rsThreshold);
-        }
-
-        /*********************************/
-        /* Set Detection Size            */
-        /*********************************/
-        sizeRange.bdMinSize = BODY_SIZE_RANGE_MIN_DEFAULT;
-        sizeRange.bdMaxSize = BODY_SIZE_RANGE_MAX_DEFAULT;
-        sizeRange.hdMinSize = HAND_SIZE_RANGE_MIN_DEFAULT;
-        sizeRange.hdMaxSize = HAND_SIZE_RANGE_MAX_DEFAULT;
-        sizeRange.dtMinSize = FACE_SIZE_RANGE_MIN_DEFAULT;
-        sizeRange.dtMaxSize = FACE_SIZE_RANGE_MAX_DEFAULT;
-
+                         config.threshold.bdThreshold, config.threshold.hdThreshold, config.threshold.dtThreshold, config.threshold.rsThreshold);
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetSizeRange : Body=(%4d,%4d) Hand=(%4d,%4d) Face=(%4d,%4d)",
-                                                            sizeRange.bdMinSize, sizeRange.bdMaxSize,
-                                                            sizeRange.hdMinSize, sizeRange.hdMaxSize,
-                                                            sizeRange.dtMinSize, sizeRange.dtMaxSize);
-
-        ret = HVC_SetSizeRange(UART_GENERAL_TIMEOUT, &sizeRange, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetSizeRange) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetSizeRange Response Error : 0x%02X", status);
-        }
-
-        sizeRange.bdMinSize = 0;
-        sizeRange.bdMaxSize = 0;
-        sizeRange.hdMinSize = 0;
-        sizeRange.hdMaxSize = 0;
-        sizeRange.dtMinSize = 0;
-        sizeRange.dtMaxSize = 0;
+                                                            config.sizeRange.bdMinSize, config.sizeRange.bdMaxSize,
+                                                            config.sizeRange.hdMinSize, config.sizeRange.hdMaxSize,
+                                                            config.sizeRange.dtMinSize, config.sizeRange.dtMaxSize);
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetFaceDetectionAngle : Pose = 0x%02x Angle = 0x%02x", config.facePose, config.faceAngle);
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetVerifyThreshold : Threshold = 0x%02x", config.verifyThreshold);
 
-        ret = HVC_GetSizeRange(UART_GENERAL_TIMEOUT, &sizeRange, &status);
+        ret = HVC_ConfigApply(hCom, UART_GENERAL_TIMEOUT, &configCache, &config, HVC_CONFIG_ALL, &status);
         if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetSizeRange) Error : %d", ret);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ConfigApply) Error : %d", ret);
         }
         else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetSizeRange Response Error : 0x%02X", status);
-        }
-        else {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetSizeRange : Body=(%4d,%4d) Hand=(%4d,%4d) Face=(%4d,%4d)",
-                                                                sizeRange.bdMinSize, sizeRange.bdMaxSize,
-                                                                sizeRange.hdMinSize, sizeRange.hdMaxSize,
-                                                                sizeRange.dtMinSize, sizeRange.dtMaxSize);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_ConfigApply Response Error : 0x%02X", status);
         }
 
         /*********************************/
-        /* Set Face Angle                */
+        /* Get Configuration             */
         /*********************************/
-        pose = FACE_POSE_DEFAULT;
-        angle = FACE_ANGLE_DEFAULT;
+        /* Served from the shadow; only fields that failed above are read back */
+        memset(&config, 0, sizeof(config));
 
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetFaceDetectionAngle : Pose = 0x%02x Angle = 0x%02x", pose, angle);
-
-        ret = HVC_SetFaceDetectionAngle(UART_GENERAL_TIMEOUT, pose, angle, &status);
+        ret = HVC_ConfigRead(hCom, UART_GENERAL_TIMEOUT, &configCache, HVC_CONFIG_ALL, &config, &status);
         if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetFaceDetectionAngle) Error : %d", ret);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ConfigRead) Error : %d", ret);
         }
         else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetFaceDetectionAngle Response Error : 0x%02X", status);
-        }
-
-        pose = 0xff;
-        angle = 0xff;
-
-        ret = HVC_GetFaceDetectionAngle(UART_GENERAL_TIMEOUT, &pose, &angle, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetFaceDetectionAngle) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetFaceDetectionAngle Response Error : 0x%02X", status);
-        }
-        else{
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetFaceDetectionAngle : Pose = 0x%02x Angle = 0x%02x", pose, angle);
-        }
-
-        /*********************************/
-        /* Set Verify Threshold          */
-        /*********************************/
-        verifyTh = VERIFY_THRESHOLD_DEFAULT;
-
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetVerifyThreshold : Threshold = 0x%02x", verifyTh);
-
-        ret = HVC_SetVerifyThreshold(UART_GENERAL_TIMEOUT, verifyTh, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetVerifyThreshold) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_SetVerifyThreshold Response Error : 0x%02X", status);
-        }
-
-        verifyTh = 0xff;
-
-        ret = HVC_GetVerifyThreshold(UART_GENERAL_TIMEOUT, &verifyTh, &status);
-        if ( ret != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_GetVerifyThreshold) Error : %d", ret);
-        }
-        else if ( status != 0 ) {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetVerifyThreshold Response Error : 0x%02X", status);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_ConfigRead Response Error : 0x%02X", status);
         }
         else {
-            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetVerifyThreshold : Threshold = 0x%02x", verifyTh);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetCameraAngle : 0x%02x", config.cameraAngle);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetThreshold : Body=%4d Hand=%4d Face=%4d Recognition=%4d",
+                             config.threshold.bdThreshold, config.threshold.hdThreshold, config.threshold.dtThreshold, config.threshold.rsThreshold);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetSizeRange : Body=(%4d,%4d) Hand=(%4d,%4d) Face=(%4d,%4d)",
+                                                                config.sizeRange.bdMinSize, config.sizeRange.bdMaxSize,
+                                                                config.sizeRange.hdMinSize, config.sizeRange.hdMaxSize,
+                                                                config.sizeRange.dtMinSize, config.sizeRange.dtMaxSize);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetFaceDetectionAngle : Pose = 0x%02x Angle = 0x%02x", config.facePose, config.faceAngle);
+            sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVC_GetVerifyThreshold : Threshold = 0x%02x", config.verifyThreshold);
         }
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nConfiguration commands : %d", configCache.nCommand);
 
         /******************/
         /* Log Output     */
@@ -461,6 +485,7 @@ int main(int argc, char *argv[])
             PrintLog(" 11 : Reformat Flash ROM");
             PrintLog(" 12 : Set Number of registered people in album");
             PrintLog(" 13 : Get Number of registered people in album");
+            PrintLog(" 14 : Transport statistics");
             PrintLog("");
             PrintLog("  0 : Exit");
 
@@ -468,61 +493,68 @@ int main(int argc, char *argv[])
             scanf("%d", &funcNo);
             scanf("%*c");
 
+            com_get_stats(hCom, &stats);
+            nTimeouts = stats.nTimeouts;
+
             /*********************************/
             /* Execute function              */
             /*********************************/
             switch (funcNo) {
             case 1:
                 /* Detection/Estimation */
-                SampleFuncExecution(pStr, stb_use);
+                SampleFuncExecution(hCom, pStr, stb_use, &framePool);
                 break;
             case 2:
                 /* Recognition(Identify) */
-                SampleFuncRecognitionIdentify(pStr, stb_use);
+                SampleFuncRecognitionIdentify(hCom, pStr, stb_use, &framePool);
                 break;
             case 3:
                 /* Recognition(Verify) */
-                SampleFuncRecognitionVerify(pStr);
+                SampleFuncRecognitionVerify(hCom, pStr, &framePool);
                 break;
             case 4:
                 /* Register data */
-                SampleFuncRegisterData(pStr);
+                SampleFuncRegisterData(hCom, pStr);
                 break;
             case 5:
                 /* Delete specified data */
-                SampleFuncDeleteData(pStr);
+                SampleFuncDeleteData(hCom, pStr);
                 break;
             case 6:
                 /* Delete specified User */
-                SampleFuncDeleteUser(pStr);
+                SampleFuncDeleteUser(hCom, pStr);
                 break;
             case 7:
                 /* Delete all data */
-                SampleFuncDeleteAll(pStr);
+                SampleFuncDeleteAll(hCom, pStr);
                 break;
             case 8:
                 /* Save Album */
-                SampleFuncSaveAlbum(pStr);
+                SampleFuncSaveAlbum(hCom, pStr);
                 break;
             case 9:
                 /* Load Album */
-                SampleFuncLoadAlbum(pStr);
+                SampleFuncLoadAlbum(hCom, pStr);
                 break;
             case 10:
                 /* Save Album on Flash ROM */
-                SampleFuncWriteAlbum(pStr);
+                SampleFuncWriteAlbum(hCom, pStr);
                 break;
             case 11:
                 /* Reformat Flash ROM */
-                SampleFuncReformatAlbum(pStr);
+                SampleFuncReformatAlbum(hCom, pStr);
                 break;
             case 12:
                 /* Set Number of registered people in album */
-                SampleFuncSetRegistCount(pStr);
+                SampleFuncSetRegistCount(hCom, pStr);
                 break;
             case 13:
                 /* Get Number of registered people in album */
-                SampleFuncGetRegistCount(pStr);
+                SampleFuncGetRegistCount(hCom, pStr);
+                break;
+            case 14:
+                /* Transport statistics */
+                SampleFuncTransportStats(hCom, pStr);
                 break;
             case 0:
                 /* Exit */
@@ -533,6 +565,20 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            /* Timeouts point at a line that does not hold the rate: fall back */
+            com_get_stats(hCom, &stats);
+            if ( exit == 0 && stats.nTimeouts > nTimeouts && rate > 0 ) {
+                hCom = HVC_ConnectStepDown(OpenAt, &port, hCom, &rate);
+                if ( hCom == NULL ) {
+                    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nLost HVC-P2 while changing baud rate");
+                    exit = 1;
+                } else {
+                    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nCommunication errors: now at %d baud", listBaudRate[rate]);
+                    /* The device was reset to change the rate: it holds nothing now */
+                    HVC_ConfigInvalidate(&configCache, HVC_CONFIG_ALL);
+                }
+            }
+
             /******************/
             /* Log Output     */
             /******************/
@@ -566,7 +612,10 @@ int main(int argc, char *argv[])
     /******************/
     PrintLog(pStr);
 
-    com_close();
+    com_close(hCom);
+
+    /* Free Result Frames */
+    free(pFrames);
 
     /* Free Logging Buffer */
     if ( pStr != NULL ) {
@@ -576,13 +625,36 @@ int main(int argc, char *argv[])
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* SampleFuncPresence                                                         */
+/* param    : void  *pParam     previous frame had someone in view (int)      */
+/*          : INT32 inBodyNum   bodies detected                               */
+/*          : INT32 inHandNum   hands detected                                */
+/*          : INT32 inFaceNum   faces detected                                */
+/* return   : void                                                            */
+/* Count hook: runs as soon as a frame's counts arrive, before its results    */
+/* and image, so a change of presence is printed at the earliest moment.      */
+/*----------------------------------------------------------------------------*/
+static void SampleFuncPresence(void *pParam, INT32 inBodyNum, INT32 inHandNum, INT32 inFaceNum)
+{
+    int *pInView = (int *)pParam;
+    int inView = (inBodyNum + inHandNum + inFaceNum) > 0;
+
+    if ( inView != *pInView ) {
+        PrintLog(inView ? "\n[Someone came into view]" : "\n[Nobody in view]");
+        *pInView = inView;
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 /* SampleFuncExecution                                                        */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /*          : int   stb_use     STB use ON/OFF                                */
+/*          : HVC_FRAME_POOL *pPool result frames                             */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncExecution(char *pStr, int stb_use)
+void SampleFuncExecution(HCOM hCom, char *pStr, int stb_use, HVC_FRAME_POOL *pPool)
 {
     INT32 ret = 0;
     INT32 execFlag;
@@ -590,6 +662,7 @@ void SampleFuncExecution(char *pStr, int stb_use)
     UINT8 status;
 
     HVC_RESULT *pHVCResult = NULL;
+    HVC_STREAM stream;
 
     int nSTBFaceCount;
     int nSTBBodyCount;
@@ -599,6 +672,7 @@ void SampleFuncExecution(char *pStr, int stb_use)
     int nIndex;
     int i;
     int ch = 0;
+    int inView = 0;
    
     char *pExStr[] = {"?", "Neutral", "Happiness", "Surprise", "Anger", "Sadness"};
 
@@ -629,13 +703,16 @@ void SampleFuncExecution(char *pStr, int stb_use)
         }
 
     /*********************************/
-    /* Result Structure Allocation   */
+    /* Start Detection Stream        */
     /*********************************/
-    pHVCResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
-    if ( pHVCResult == NULL ) { /* Error processing */
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nMemory Allocation Error : %08lx\n", sizeof(HVC_RESULT));
-        return;
-    }
+    execFlag = HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_HAND_DETECTION | HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION |
+               HVC_ACTIV_AGE_ESTIMATION | HVC_ACTIV_GENDER_ESTIMATION | HVC_ACTIV_GAZE_ESTIMATION | HVC_ACTIV_BLINK_ESTIMATION |
+               HVC_ACTIV_EXPRESSION_ESTIMATION;
+    imageNo = HVC_EXECUTE_IMAGE_QVGA_HALF; /* HVC_EXECUTE_IMAGE_NONE; */
+
+    /* The device computes the next frame while this one is saved and printed */
+    HVC_StreamStartPool(&stream, hCom, UART_EXECUTE_TIMEOUT, execFlag, imageNo, pPool, SAMPLE_STREAM_DEPTH);
+    HVC_StreamSetCountHook(&stream, SampleFuncPresence, &inView);
 
     do {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nPress Space Key to end: ");
@@ -649,13 +726,10 @@ void SampleFuncExecution(char *pStr, int stb_use)
         /*********************************/
         /* Execute Detection             */
         /*********************************/
-        execFlag = HVC_ACTIV_BODY_DETECTION | HVC_ACTIV_HAND_DETECTION | HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_DIRECTION |
-                   HVC_ACTIV_AGE_ESTIMATION | HVC_ACTIV_GENDER_ESTIMATION | HVC_ACTIV_GAZE_ESTIMATION | HVC_ACTIV_BLINK_ESTIMATION |
-                   HVC_ACTIV_EXPRESSION_ESTIMATION;
-        imageNo = HVC_EXECUTE_IMAGE_QVGA_HALF; /* HVC_EXECUTE_IMAGE_NONE; */
-
-
-        ret = HVC_ExecuteEx(UART_EXECUTE_TIMEOUT, execFlag, imageNo, pHVCResult, &status);
+        /* Every consumer of the previous frame is done with it */
+        HVC_FrameRelease(pHVCResult);
+        pHVCResult = NULL;
+        ret = HVC_StreamGet(&stream, 1, &pHVCResult, &status);
 
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ExecuteEx) Error : %d\n", ret);
@@ -967,12 +1041,13 @@ void SampleFuncExecution(char *pStr, int stb_use)
 #endif
     } while( ch != ' ' );
 
+    /* Leaves the device idle for the next command */
+    HVC_StreamStop(&stream);
+
     /********************************/
-    /* Free result area             */
+    /* Release result frame         */
     /********************************/
-    if ( pHVCResult != NULL ) {
-        free(pHVCResult);
-    }
+    HVC_FrameRelease(pHVCResult);
 
     /*********************************/
     /* STB Finalize                  */
@@ -985,11 +1060,13 @@ void SampleFuncExecution(char *pStr, int stb_use)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncRecognitionIdentify                                              */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /*          : int   stb_use     STB use ON/OFF                                */
+/*          : HVC_FRAME_POOL *pPool result frames                             */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncRecognitionIdentify(char *pStr, int stb_use)
+void SampleFuncRecognitionIdentify(HCOM hCom, char *pStr, int stb_use, HVC_FRAME_POOL *pPool)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1036,11 +1113,11 @@ void SampleFuncRecognitionIdentify(char *pStr, int stb_use)
     }
 
     /*********************************/
-    /* Result Structure Allocation   */
+    /* Result Frame Acquisition      */
     /*********************************/
-    pHVCResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    pHVCResult = HVC_FrameAcquire(pPool);
     if ( pHVCResult == NULL ) { /* Error processing */
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nMemory Allocation Error : %08lx\n", sizeof(HVC_RESULT));
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nNo free result frame\n");
         return;
     }
 
@@ -1079,7 +1156,7 @@ void SampleFuncRecognitionIdentify(char *pStr, int stb_use)
         }
         imageNo = HVC_EXECUTE_IMAGE_QVGA_HALF; /* HVC_EXECUTE_IMAGE_NONE; */
 
-        ret = HVC_ExecuteEx(UART_EXECUTE_TIMEOUT, execFlag, imageNo, pHVCResult, &status);
+        ret = HVC_ExecuteEx(hCom, UART_EXECUTE_TIMEOUT, execFlag, imageNo, pHVCResult, &status);
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ExecuteEx) Error : %d\n", ret);
             continue;
@@ -1160,11 +1237,9 @@ void SampleFuncRecognitionIdentify(char *pStr, int stb_use)
     }
 
     /********************************/
-    /* Free result area             */
+    /* Release result frame         */
     /********************************/
-    if( pHVCResult != NULL ){
-        free(pHVCResult);
-    }
+    HVC_FrameRelease(pHVCResult);
 
     /*********************************/
     /* STB Finalize                  */
@@ -1177,11 +1252,13 @@ void SampleFuncRecognitionIdentify(char *pStr, int stb_use)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncRecognitionVerify                                                */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /*          : int   stb_use     STB use ON/OFF                                */
+/*          : HVC_FRAME_POOL *pPool result frames                             */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncRecognitionVerify(char *pStr)
+void SampleFuncRecognitionVerify(HCOM hCom, char *pStr, HVC_FRAME_POOL *pPool)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1212,7 +1289,7 @@ void SampleFuncRecognitionVerify(char *pStr)
     /*********************************/
     /* Set Verify user ID            */
     /*********************************/
-    ret = HVC_SetVerifyUser(UART_GENERAL_TIMEOUT, userId, &status);
+    ret = HVC_SetVerifyUser(hCom, UART_GENERAL_TIMEOUT, userId, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetVerifyUser) Error : %d\n", ret);
         return;
@@ -1222,7 +1299,7 @@ void SampleFuncRecognitionVerify(char *pStr)
         return;
     }
     userId = 0xff;
-    ret = HVC_GetVerifyUser(UART_GENERAL_TIMEOUT, &userId, &status);
+    ret = HVC_GetVerifyUser(hCom, UART_GENERAL_TIMEOUT, &userId, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetVerifyUser) Error : %d\n", ret);
         return;
@@ -1234,11 +1311,11 @@ void SampleFuncRecognitionVerify(char *pStr)
     sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nVerify user ID = %d\n", userId);
 
     /*********************************/
-    /* Result Structure Allocation   */
+    /* Result Frame Acquisition      */
     /*********************************/
-    pHVCResult = (HVC_RESULT *)malloc(sizeof(HVC_RESULT));
+    pHVCResult = HVC_FrameAcquire(pPool);
     if ( pHVCResult == NULL ) { /* Error processing */
-        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nMemory Allocation Error : %08lx\n", sizeof(HVC_RESULT));
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nNo free result frame\n");
         return;
     }
 
@@ -1273,7 +1350,7 @@ void SampleFuncRecognitionVerify(char *pStr)
         execFlag = HVC_ACTIV_FACE_DETECTION | HVC_ACTIV_FACE_VERIFY;
         imageNo = HVC_EXECUTE_IMAGE_QVGA_HALF; /* HVC_EXECUTE_IMAGE_NONE; */
 
-        ret = HVC_ExecuteEx(UART_EXECUTE_TIMEOUT, execFlag, HVC_EXECUTE_IMAGE_QVGA_HALF, pHVCResult, &status);
+        ret = HVC_ExecuteEx(hCom, UART_EXECUTE_TIMEOUT, execFlag, HVC_EXECUTE_IMAGE_QVGA_HALF, pHVCResult, &status);
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ExecuteEx) Error : %d\n", ret);
             continue;
@@ -1315,20 +1392,19 @@ void SampleFuncRecognitionVerify(char *pStr)
     }
 
     /********************************/
-    /* Free result area             */
+    /* Release result frame         */
     /********************************/
-    if( pHVCResult != NULL ){
-        free(pHVCResult);
-    }
+    HVC_FrameRelease(pHVCResult);
 }
 
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncRegisterData                                                     */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncRegisterData(char *pStr)
+void SampleFuncRegisterData(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1397,7 +1473,7 @@ void SampleFuncRegisterData(char *pStr)
         /*********************************/
         /* Execute Registration          */
         /*********************************/
-        ret = HVC_Registration(UART_GENERAL_TIMEOUT, userId, dataId, pImage, &status);
+        ret = HVC_Registration(hCom, UART_GENERAL_TIMEOUT, userId, dataId, pImage, &status);
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_Registration) Error : %d\n", ret);
             continue;
@@ -1424,10 +1500,11 @@ void SampleFuncRegisterData(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncDeleteData                                                       */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncDeleteData(char *pStr)
+void SampleFuncDeleteData(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1460,7 +1537,7 @@ void SampleFuncDeleteData(char *pStr)
     /*********************************/
     /* Delete data                   */
     /*********************************/
-    ret = HVC_DeleteData(UART_GENERAL_TIMEOUT, userId, dataId, &status);
+    ret = HVC_DeleteData(hCom, UART_GENERAL_TIMEOUT, userId, dataId, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_DeleteData) Error : %d\n", ret);
         return;
@@ -1476,10 +1553,11 @@ void SampleFuncDeleteData(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncDeleteUser                                                       */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncDeleteUser(char *pStr)
+void SampleFuncDeleteUser(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1502,7 +1580,7 @@ void SampleFuncDeleteUser(char *pStr)
     /*********************************/
     /* Delete user                   */
     /*********************************/
-    ret = HVC_DeleteUser(UART_GENERAL_TIMEOUT, userId, &status);
+    ret = HVC_DeleteUser(hCom, UART_GENERAL_TIMEOUT, userId, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_DeleteUser) Error : %d\n", ret);
         return;
@@ -1518,10 +1596,11 @@ void SampleFuncDeleteUser(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncDeleteAll                                                        */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncDeleteAll(char *pStr)
+void SampleFuncDeleteAll(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1530,7 +1609,7 @@ void SampleFuncDeleteAll(char *pStr)
     /*********************************/
     /* Delete all data               */
     /*********************************/
-    ret = HVC_DeleteAll(UART_GENERAL_TIMEOUT, &status);
+    ret = HVC_DeleteAll(hCom, UART_GENERAL_TIMEOUT, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_DeleteAll) Error : %d\n", ret);
         return;
@@ -1546,10 +1625,11 @@ void SampleFuncDeleteAll(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncSaveAlbum                                                        */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncSaveAlbum(char *pStr)
+void SampleFuncSaveAlbum(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1571,7 +1651,7 @@ void SampleFuncSaveAlbum(char *pStr)
         /*********************************/
         /* Save Album                    */
         /*********************************/
-        ret = HVC_SaveAlbum(UART_GENERAL_TIMEOUT, pAlbumData, &albumDataSize, &status);
+        ret = HVC_SaveAlbum(hCom, UART_ALBUM_TIMEOUT, pAlbumData, &albumDataSize, &status);
         if ( ret != 0 ) {
             sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SaveAlbum) Error : %d\n", ret);
             break;
@@ -1602,10 +1682,11 @@ void SampleFuncSaveAlbum(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncLoadAlbum                                                        */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncLoadAlbum(char *pStr)
+void SampleFuncLoadAlbum(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1634,7 +1715,7 @@ void SampleFuncLoadAlbum(char *pStr)
         }
 
         if ( albumDataSize != 0 ) {
-            ret = HVC_LoadAlbum(UART_GENERAL_TIMEOUT, pAlbumData, albumDataSize, &status);
+            ret = HVC_LoadAlbum(hCom, UART_ALBUM_TIMEOUT, pAlbumData, albumDataSize, &status);
             if ( ret != 0 ) {
                 sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_LoadAlbum) Error : %d\n", ret);
                 break;
@@ -1665,10 +1746,11 @@ void SampleFuncLoadAlbum(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncWriteAlbum                                                       */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncWriteAlbum(char *pStr)
+void SampleFuncWriteAlbum(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1677,7 +1759,7 @@ void SampleFuncWriteAlbum(char *pStr)
     /*********************************/
     /* Write Album                   */
     /*********************************/
-    ret = HVC_WriteAlbum(UART_WRITE_ALBUM_TIMEOUT, &status);
+    ret = HVC_WriteAlbum(hCom, UART_WRITE_ALBUM_TIMEOUT, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_WriteAlbum) Error : %d\n", ret);
         return;
@@ -1693,10 +1775,11 @@ void SampleFuncWriteAlbum(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncReformatAlbum                                                    */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncReformatAlbum(char *pStr)
+void SampleFuncReformatAlbum(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1705,7 +1788,7 @@ void SampleFuncReformatAlbum(char *pStr)
     /*********************************/
     /* Write Album                   */
     /*********************************/
-    ret = HVC_ReformatAlbum(UART_REFORMAT_ALBUM_TIMEOUT, &status);
+    ret = HVC_ReformatAlbum(hCom, UART_REFORMAT_ALBUM_TIMEOUT, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_ReformatAlbum) Error : %d\n", ret);
         return;
@@ -1721,10 +1804,11 @@ void SampleFuncReformatAlbum(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncSetRegistCount                                                   */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncSetRegistCount(char *pStr)
+void SampleFuncSetRegistCount(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1747,7 +1831,7 @@ void SampleFuncSetRegistCount(char *pStr)
     /*********************************/
     /* Write Album                   */
     /*********************************/
-    ret = HVC_SetRegistCount(UART_REGIST_COUNT_TIMEOUT, usrCnt, &status);
+    ret = HVC_SetRegistCount(hCom, UART_REGIST_COUNT_TIMEOUT, usrCnt, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(HVC_SetRegistCount) Error : %d\n", ret);
         return;
@@ -1763,10 +1847,11 @@ void SampleFuncSetRegistCount(char *pStr)
 
 /*----------------------------------------------------------------------------*/
 /* SampleFuncGetRegistCount                                                   */
-/* param    : char  *pStr       log strings                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
 /* return   : void                                                            */
 /*----------------------------------------------------------------------------*/
-void SampleFuncGetRegistCount(char *pStr)
+void SampleFuncGetRegistCount(HCOM hCom, char *pStr)
 {
     INT32 ret = 0;
     UINT8 status;
@@ -1777,7 +1862,7 @@ void SampleFuncGetRegistCount(char *pStr)
     /*********************************/
     /* Write Album                   */
     /*********************************/
-    ret = HVC_GetRegistCount(UART_GENERAL_TIMEOUT, &usrCnt, &status);
+    ret = HVC_GetRegistCount(hCom, UART_GENERAL_TIMEOUT, &usrCnt, &status);
     if ( ret != 0 ) {
         sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHVCApi(SampleFuncGetRegistCount) Error : %d\n", ret);
         return;
@@ -1792,6 +1877,34 @@ void SampleFuncGetRegistCount(char *pStr)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* SampleFuncTransportStats                                                   */
+/* param    : HCOM  hCom        device handle                                 */
+/*          : char  *pStr       log strings                                   */
+/* return   : void                                                            */
+/*----------------------------------------------------------------------------*/
+void SampleFuncTransportStats(HCOM hCom, char *pStr)
+{
+    COM_STATS stats;
+
+    if ( com_get_stats(hCom, &stats) != 0 ) {
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\ncom_get_stats Error\n");
+        return;
+    }
+
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nBytes received   : %llu (%llu reads, %llu wakeups)", stats.nBytesIn, stats.nReads, stats.nWakeups);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nBytes sent       : %llu", stats.nBytesOut);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nReceive buffer   : max %u / %u bytes", stats.nMaxBuffered, stats.nBufferSize);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nOverrun          : %llu bytes dropped", stats.nOverrunBytes);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nResync           : %llu (%llu stale bytes)", stats.nResyncs, stats.nResyncBytes);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nHeader resync    : %llu (%llu bytes skipped)", stats.nHeaderResyncs, stats.nHeaderSkips);
+    sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nTimeout          : %llu\n", stats.nTimeouts);
+    if ( stats.nOverrunBytes > 0 ) {
+        sprintf_s(&pStr[strlen(pStr)], LOGBUFFERSIZE-strlen(pStr), "\nThe host is not keeping up with the line; lower the baud rate.\n");
+    }
+}
+
+
 #ifndef WIN32
 /*----------------------------------------------------------------------------*/
 /* kbhit for Linux                                                            */
@@ -0,0 +1,928 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    HVC-P2 device simulator
+
+    Transport-agnostic engine: command bytes go in through HVCSim_Input(),
+    each complete response comes out through the output function together
+    with the processing time the real device would need for it.  Synthetic
+    detections depend only on the seed and the frame number.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "HVCSim.h"
+
+/* Command numbers (HVCApi.c) */
+#define SIM_COM_GET_VERSION             0x00
+#define SIM_COM_SET_CAMERA_ANGLE        0x01
+#define SIM_COM_GET_CAMERA_ANGLE        0x02
+#define SIM_COM_EXECUTE                 0x03
+#define SIM_COM_EXECUTEEX               0x04
+#define SIM_COM_SET_THRESHOLD           0x05
+#define SIM_COM_GET_THRESHOLD           0x06
+#define SIM_COM_SET_SIZE_RANGE          0x07
+#define SIM_COM_GET_SIZE_RANGE          0x08
+#define SIM_COM_SET_DETECTION_ANGLE     0x09
+#define SIM_COM_GET_DETECTION_ANGLE     0x0A
+#define SIM_COM_SET_BAUDRATE            0x0E
+#define SIM_COM_REGISTRATION            0x10
+#define SIM_COM_DELETE_DATA             0x11
+#define SIM_COM_DELETE_USER             0x12
+#define SIM_COM_DELETE_ALL              0x13
+#define SIM_COM_GET_PERSON_DATA         0x15
+#define SIM_COM_SAVE_ALBUM              0x20
+#define SIM_COM_LOAD_ALBUM              0x21
+#define SIM_COM_WRITE_ALBUM             0x22
+#define SIM_COM_REFORMAT_ALBUM          0x30
+#define SIM_COM_SET_VERIFY_THRESHOLD    0x40
+#define SIM_COM_GET_VERIFY_THRESHOLD    0x41
+#define SIM_COM_SET_VERIFY_USER         0x42
+#define SIM_COM_GET_VERIFY_USER         0x43
+#define SIM_COM_SET_REGIST_COUNT        0x44
+#define SIM_COM_GET_REGIST_COUNT        0x45
+
+#define SIM_SEND_HEAD_NUM       4       /* FE, command, length LSB, MSB */
+#define SIM_RECV_HEAD_NUM       6       /* FE, status, length (4 bytes) */
+
+#define SIM_USER_MAX            500     /* User ID 0-499 */
+#define SIM_DATA_MAX            10      /* Data ID 0-9 */
+#define SIM_DETECT_MAX          35
+#define SIM_ALBUM_ENTRY_SIZE    816
+#define SIM_ALBUM_ENTRY_MAX     ((HVC_ALBUM_SIZE_MAX - HVC_ALBUM_SIZE_MIN) / SIM_ALBUM_ENTRY_SIZE)
+#define SIM_ALBUM_HEADER        8       /* size + CRC in front of the album */
+#define SIM_REGIST_IMAGE        64      /* Registration image is 64x64 */
+
+#define SIM_IMAGE_WIDTH         1600    /* Coordinate space of the results */
+#define SIM_IMAGE_HEIGHT        1200
+
+#define SIM_IN_SIZE             (SIM_SEND_HEAD_NUM + 4 + SIM_ALBUM_HEADER + HVC_ALBUM_SIZE_MAX + 4096)
+#define SIM_OUT_SIZE            (SIM_RECV_HEAD_NUM + SIM_ALBUM_HEADER + HVC_ALBUM_SIZE_MAX)
+
+static const INT32 m_baudRate[] = { 9600, 38400, 115200, 230400, 460800, 921600 };
+#define SIM_BAUDRATE_NUM        (INT32)(sizeof(m_baudRate)/sizeof(m_baudRate[0]))
+
+static const char *m_procTimeName[HVCSIM_TIME_NUM] = {
+    "command", "body", "hand", "face", "direction", "age", "gender", "gaze",
+    "blink", "expression", "recognition", "verify", "image", "registration",
+    "savealbum", "loadalbum", "writealbum", "reformat",
+};
+
+/* Default processing time (us); estimations are per detected face */
+static const INT32 m_procTimeDefault[HVCSIM_TIME_NUM] = {
+    1000,       /* command */
+    30000,      /* body */
+    30000,      /* hand */
+    25000,      /* face */
+    3000,       /* direction */
+    8000,       /* age */
+    8000,       /* gender */
+    3000,       /* gaze */
+    3000,       /* blink */
+    8000,       /* expression */
+    15000,      /* recognition */
+    15000,      /* verify */
+    10000,      /* image */
+    300000,     /* registration */
+    100000,     /* savealbum */
+    200000,     /* loadalbum */
+    1500000,    /* writealbum */
+    3000000,    /* reformat */
+};
+
+/* One body/hand/face candidate and everything estimated for it */
+typedef struct {
+    INT32   posX, posY, size, conf;
+    INT32   yaw, pitch, roll, dirConf;
+    INT32   age, ageConf;
+    INT32   gender, genderConf;
+    INT32   gazeLR, gazeUD;
+    INT32   blinkL, blinkR;
+    INT32   score[5], degree;
+    INT32   recogIndex, recogConf;
+} SIM_OBJECT;
+
+struct HVCSIM {
+    HVCSIM_CONFIG       config;
+    HVCSIM_OUTPUT_FUNC  func;
+    void                *pParam;
+
+    UINT8               *pIn;           /* Command assembly buffer */
+    INT32               nIn;            /* Bytes in pIn */
+    INT32               nRead;          /* Bytes of pIn already consumed */
+    UINT8               *pOut;          /* Response buffer */
+
+    INT32               cameraAngle;
+    INT32               threshold[4];   /* body, hand, face, recognition */
+    INT32               sizeRange[6];   /* body, hand, face (min, max) */
+    INT32               pose;
+    INT32               angle;
+    INT32               baudIndex;
+    INT32               verifyThreshold;
+    INT32               verifyUser;
+    INT32               registCount;
+    unsigned short      regist[SIM_USER_MAX];   /* Registered data ID bitmap per user */
+    unsigned short      flash[SIM_USER_MAX];    /* Album written to flash ROM */
+    UINT32              frame;          /* Execute counter */
+    SIM_OBJECT          body[SIM_DETECT_MAX];   /* Work area of the current frame */
+    SIM_OBJECT          hand[SIM_DETECT_MAX];
+    SIM_OBJECT          face[SIM_DETECT_MAX];
+};
+
+/* Little-endian helpers */
+static void SetLE16(UINT8 *p, INT32 v)
+{
+    p[0] = (UINT8)(v & 0xff);
+    p[1] = (UINT8)((v >> 8) & 0xff);
+}
+
+static void SetLE32(UINT8 *p, UINT32 v)
+{
+    p[0] = (UINT8)(v & 0xff);
+    p[1] = (UINT8)((v >> 8) & 0xff);
+    p[2] = (UINT8)((v >> 16) & 0xff);
+    p[3] = (UINT8)((v >> 24) & 0xff);
+}
+
+static INT32 GetLE16(const UINT8 *p)
+{
+    return p[0] + (p[1] << 8);
+}
+
+static UINT32 GetLE32(const UINT8 *p)
+{
+    return (UINT32)p[0] | ((UINT32)p[1] << 8) | ((UINT32)p[2] << 16) | ((UINT32)p[3] << 24);
+}
+
+/* xorshift32; the state must never be zero */
+static UINT32 NextRandom(UINT32 *ioState)
+{
+    UINT32 x = *ioState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *ioState = x;
+    return x;
+}
+
+/* Uniform integer in [inMin, inMax] */
+static INT32 RandomRange(UINT32 *ioState, INT32 inMin, INT32 inMax)
+{
+    return inMin + (INT32)(NextRandom(ioState) % (UINT32)(inMax - inMin + 1));
+}
+
+/* Mixes two words into a non-zero random state (murmur3 finaliser) */
+static UINT32 SeedRandom(UINT32 inA, UINT32 inB)
+{
+    UINT32 h = inA ^ (inB * 0x9E3779B9U);
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+    return (h != 0) ? h : 0x6D2B79F5U;
+}
+
+static UINT32 Crc32(const UINT8 *inData, INT32 inSize)
+{
+    UINT32 crc = 0xFFFFFFFFU;
+    INT32 i, j;
+
+    for ( i = 0; i < inSize; i++ ) {
+        crc ^= inData[i];
+        for ( j = 0; j < 8; j++ ) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Default configuration                                                      */
+/* param    : HVCSIM_CONFIG *outConfig      configuration to fill             */
+/*----------------------------------------------------------------------------*/
+void HVCSim_DefaultConfig(HVCSIM_CONFIG *outConfig)
+{
+    outConfig->seed = 1;
+    outConfig->maxBody = 3;
+    outConfig->maxHand = 3;
+    outConfig->maxFace = 3;
+    memcpy(outConfig->procTime, m_procTimeDefault, sizeof(outConfig->procTime));
+}
+
+/*----------------------------------------------------------------------------*/
+/* Set one processing time by name                                            */
+/* param    : HVCSIM_CONFIG *ioConfig       configuration                     */
+/*          : const char    *inName         function name ("face", ...)       */
+/*          : INT32         inTime          processing time (us)              */
+/* return   : INT32                         0...normal, -1...unknown name     */
+/*----------------------------------------------------------------------------*/
+INT32 HVCSim_SetProcTime(HVCSIM_CONFIG *ioConfig, const char *inName, INT32 inTime)
+{
+    INT32 i;
+
+    if ( inTime < 0 ) return -1;
+    for ( i = 0; i < HVCSIM_TIME_NUM; i++ ) {
+        if ( strcmp(inName, m_procTimeName[i]) == 0 ) {
+            ioConfig->procTime[i] = inTime;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Name of a processing time entry, NULL when out of range */
+const char *HVCSim_GetProcTimeName(INT32 inIndex)
+{
+    if ( inIndex < 0 || inIndex >= HVCSIM_TIME_NUM ) return NULL;
+    return m_procTimeName[inIndex];
+}
+
+/*----------------------------------------------------------------------------*/
+/* Power-on state                                                             */
+/* param    : HVCSIM        *pSim           simulator                         */
+/*----------------------------------------------------------------------------*/
+void HVCSim_Reset(HVCSIM *pSim)
+{
+    pSim->nIn = 0;
+    pSim->nRead = 0;
+    pSim->cameraAngle = 0;
+    pSim->threshold[0] = 500;
+    pSim->threshold[1] = 500;
+    pSim->threshold[2] = 500;
+    pSim->threshold[3] = 500;
+    pSim->sizeRange[0] = 30;
+    pSim->sizeRange[1] = 8192;
+    pSim->sizeRange[2] = 40;
+    pSim->sizeRange[3] = 8192;
+    pSim->sizeRange[4] = 64;
+    pSim->sizeRange[5] = 8192;
+    pSim->pose = 0;
+    pSim->angle = 0;
+    pSim->baudIndex = 0;
+    pSim->verifyThreshold = 500;
+    pSim->verifyUser = 0;
+    pSim->registCount = SIM_DATA_MAX;
+    pSim->frame = 0;
+    /* The album survives only if it was written to flash */
+    memcpy(pSim->regist, pSim->flash, sizeof(pSim->regist));
+}
+
+/*----------------------------------------------------------------------------*/
+/* Create a simulated device                                                  */
+/* param    : const HVCSIM_CONFIG *inConfig configuration, NULL for defaults  */
+/*          : HVCSIM_OUTPUT_FUNC  inFunc    receives every response           */
+/*          : void          *pParam         passed to inFunc                  */
+/* return   : HVCSIM *                      simulator, NULL on failure        */
+/*----------------------------------------------------------------------------*/
+HVCSIM *HVCSim_Create(const HVCSIM_CONFIG *inConfig, HVCSIM_OUTPUT_FUNC inFunc, void *pParam)
+{
+    HVCSIM *pSim;
+
+    if ( inFunc == NULL ) return NULL;
+
+    pSim = (HVCSIM *)calloc(1, sizeof(HVCSIM));
+    if ( pSim == NULL ) return NULL;
+
+    if ( inConfig != NULL ) {
+        pSim->config = *inConfig;
+    }
+    else {
+        HVCSim_DefaultConfig(&pSim->config);
+    }
+    if ( pSim->config.maxBody < 0 ) pSim->config.maxBody = 0;
+    if ( pSim->config.maxBody > SIM_DETECT_MAX ) pSim->config.maxBody = SIM_DETECT_MAX;
+    if ( pSim->config.maxHand < 0 ) pSim->config.maxHand = 0;
+    if ( pSim->config.maxHand > SIM_DETECT_MAX ) pSim->config.maxHand = SIM_DETECT_MAX;
+    if ( pSim->config.maxFace < 0 ) pSim->config.maxFace = 0;
+    if ( pSim->config.maxFace > SIM_DETECT_MAX ) pSim->config.maxFace = SIM_DETECT_MAX;
+    pSim->func = inFunc;
+    pSim->pParam = pParam;
+
+    pSim->pIn = (UINT8 *)malloc(SIM_IN_SIZE);
+    pSim->pOut = (UINT8 *)malloc(SIM_OUT_SIZE);
+    if ( pSim->pIn == NULL || pSim->pOut == NULL ) {
+        HVCSim_Destroy(pSim);
+        return NULL;
+    }
+    HVCSim_Reset(pSim);
+    return pSim;
+}
+
+void HVCSim_Destroy(HVCSIM *pSim)
+{
+    if ( pSim == NULL ) return;
+    free(pSim->pIn);
+    free(pSim->pOut);
+    free(pSim);
+}
+
+/* Current line speed (bps) */
+INT32 HVCSim_GetBaudRate(HVCSIM *pSim)
+{
+    return m_baudRate[pSim->baudIndex];
+}
+
+/* Number of Execute/ExecuteEx commands processed so far */
+UINT32 HVCSim_GetFrameCount(HVCSIM *pSim)
+{
+    return pSim->frame;
+}
+
+/* Hands the response in pOut (data already in place) to the output function */
+static void Respond(HVCSIM *pSim, UINT8 inStatus, INT32 inDataSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    pSim->pOut[0] = 0xFE;
+    pSim->pOut[1] = inStatus;
+    SetLE32(&pSim->pOut[2], (UINT32)inDataSize);
+    pSim->func(pSim->pParam, pSim->pOut, SIM_RECV_HEAD_NUM + inDataSize, inCmdSize, inProcTime);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Synthetic frame                                                            */
+/* Every candidate is drawn in full whatever the execution flags are, so the  */
+/* same seed and frame number give the same people for any flag set.         */
+/*----------------------------------------------------------------------------*/
+static INT32 MakeObjects(HVCSIM *pSim, UINT32 *ioState, INT32 inMax, INT32 inKind,
+                         INT32 inRegistered, SIM_OBJECT *outObj)
+{
+    INT32 i, k, n, num = 0;
+    INT32 total = 0;
+    SIM_OBJECT obj;
+
+    n = RandomRange(ioState, 0, inMax);
+    for ( i = 0; i < n; i++ ) {
+        obj.posX = RandomRange(ioState, 0, SIM_IMAGE_WIDTH - 1);
+        obj.posY = RandomRange(ioState, 0, SIM_IMAGE_HEIGHT - 1);
+        obj.size = RandomRange(ioState, 30, 600);
+        obj.conf = RandomRange(ioState, 300, 1000);
+        obj.yaw = RandomRange(ioState, -90, 90);
+        obj.pitch = RandomRange(ioState, -90, 90);
+        obj.roll = RandomRange(ioState, -180, 179);
+        obj.dirConf = RandomRange(ioState, 0, 1000);
+        obj.age = RandomRange(ioState, 0, 75);
+        obj.ageConf = RandomRange(ioState, 0, 1000);
+        obj.gender = RandomRange(ioState, 0, 1);
+        obj.genderConf = RandomRange(ioState, 0, 1000);
+        obj.gazeLR = RandomRange(ioState, -90, 90);
+        obj.gazeUD = RandomRange(ioState, -90, 90);
+        obj.blinkL = RandomRange(ioState, 1, 1000);
+        obj.blinkR = RandomRange(ioState, 1, 1000);
+        total = 0;
+        for ( k = 0; k < 5; k++ ) {
+            obj.score[k] = RandomRange(ioState, 0, 100);
+            total += obj.score[k];
+        }
+        /* Scores of the five expressions add up to 100 */
+        for ( k = 0; k < 5; k++ ) {
+            obj.score[k] = (total > 0) ? (obj.score[k] * 100) / total : 20;
+        }
+        obj.degree = RandomRange(ioState, -100, 100);
+        obj.recogIndex = (inRegistered > 0) ? RandomRange(ioState, 0, inRegistered * 4 / 3) : -1;
+        obj.recogConf = RandomRange(ioState, 0, 1000);
+
+        /* Threshold and size range apply as on the device */
+        if ( obj.conf < pSim->threshold[inKind] ) continue;
+        if ( obj.size < pSim->sizeRange[inKind * 2] || obj.size > pSim->sizeRange[inKind * 2 + 1] ) continue;
+        outObj[num++] = obj;
+    }
+    return num;
+}
+
+/* User ID of the n-th registered user, -1 if n is past the last one */
+static INT32 GetRegisteredUser(HVCSIM *pSim, INT32 inIndex)
+{
+    INT32 i;
+
+    for ( i = 0; i < SIM_USER_MAX; i++ ) {
+        if ( pSim->regist[i] != 0 && inIndex-- == 0 ) return i;
+    }
+    return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Execute / ExecuteEx                                                        */
+/*----------------------------------------------------------------------------*/
+static void CommandExecute(HVCSIM *pSim, UINT8 inCommand, const UINT8 *inData, INT32 inSize, INT32 inCmdSize)
+{
+    SIM_OBJECT *body = pSim->body;
+    SIM_OBJECT *hand = pSim->hand;
+    SIM_OBJECT *face = pSim->face;
+    const INT32 *t = pSim->config.procTime;
+    INT32 exec, image;
+    INT32 nBody, nHand, nFace;
+    INT32 i, k, x, y, width, height, registered, uid;
+    INT32 time;
+    UINT32 state;
+    UINT8 *d = &pSim->pOut[SIM_RECV_HEAD_NUM];
+    UINT8 *p = d;
+
+    if ( inSize != 3 ) {
+        Respond(pSim, HVCSIM_STATUS_IMPROPER, 0, inCmdSize, t[HVCSIM_TIME_COMMAND]);
+        return;
+    }
+    exec = GetLE16(inData);
+    image = inData[2];
+    if ( (exec & ~0x7FF) != 0 || image > HVC_EXECUTE_IMAGE_QVGA_HALF ) {
+        Respond(pSim, HVCSIM_STATUS_IMPROPER, 0, inCmdSize, t[HVCSIM_TIME_COMMAND]);
+        return;
+    }
+
+    registered = 0;
+    for ( i = 0; i < SIM_USER_MAX; i++ ) {
+        if ( pSim->regist[i] != 0 ) registered++;
+    }
+
+    state = SeedRandom(pSim->config.seed, pSim->frame);
+    nBody = MakeObjects(pSim, &state, pSim->config.maxBody, 0, registered, body);
+    nHand = MakeObjects(pSim, &state, pSim->config.maxHand, 1, registered, hand);
+    nFace = MakeObjects(pSim, &state, pSim->config.maxFace, 2, registered, face);
+    pSim->frame++;
+
+    if ( (exec & HVC_ACTIV_BODY_DETECTION) == 0 ) nBody = 0;
+    if ( (exec & HVC_ACTIV_HAND_DETECTION) == 0 ) nHand = 0;
+    /* Any face function runs face detection underneath */
+    if ( (exec & 0x7FC) == 0 ) nFace = 0;
+
+    p[0] = (UINT8)nBody;
+    p[1] = (UINT8)nHand;
+    p[2] = (UINT8)nFace;
+    p[3] = 0;
+    p += 4;
+    for ( i = 0; i < nBody; i++ ) {
+        SetLE16(&p[0], body[i].posX);
+        SetLE16(&p[2], body[i].posY);
+        SetLE16(&p[4], body[i].size);
+        SetLE16(&p[6], body[i].conf);
+        p += 8;
+    }
+    for ( i = 0; i < nHand; i++ ) {
+        SetLE16(&p[0], hand[i].posX);
+        SetLE16(&p[2], hand[i].posY);
+        SetLE16(&p[4], hand[i].size);
+        SetLE16(&p[6], hand[i].conf);
+        p += 8;
+    }
+    for ( i = 0; i < nFace; i++ ) {
+        if ( exec & HVC_ACTIV_FACE_DETECTION ) {
+            SetLE16(&p[0], face[i].posX);
+            SetLE16(&p[2], face[i].posY);
+            SetLE16(&p[4], face[i].size);
+            SetLE16(&p[6], face[i].conf);
+            p += 8;
+        }
+        if ( exec & HVC_ACTIV_FACE_DIRECTION ) {
+            SetLE16(&p[0], face[i].yaw);
+            SetLE16(&p[2], face[i].pitch);
+            SetLE16(&p[4], face[i].roll);
+            SetLE16(&p[6], face[i].dirConf);
+            p += 8;
+        }
+        if ( exec & HVC_ACTIV_AGE_ESTIMATION ) {
+            p[0] = (UINT8)face[i].age;
+            SetLE16(&p[1], face[i].ageConf);
+            p += 3;
+        }
+        if ( exec & HVC_ACTIV_GENDER_ESTIMATION ) {
+            p[0] = (UINT8)face[i].gender;
+            SetLE16(&p[1], face[i].genderConf);
+            p += 3;
+        }
+        if ( exec & HVC_ACTIV_GAZE_ESTIMATION ) {
+            p[0] = (UINT8)face[i].gazeLR;
+            p[1] = (UINT8)face[i].gazeUD;
+            p += 2;
+        }
+        if ( exec & HVC_ACTIV_BLINK_ESTIMATION ) {
+            SetLE16(&p[0], face[i].blinkL);
+            SetLE16(&p[2], face[i].blinkR);
+            p += 4;
+        }
+        if ( exec & HVC_ACTIV_EXPRESSION_ESTIMATION ) {
+            if ( inCommand == SIM_COM_EXECUTEEX ) {
+                for ( k = 0; k < 5; k++ ) {
+                    p[k] = (UINT8)face[i].score[k];
+                }
+                p[5] = (UINT8)face[i].degree;
+                p += 6;
+            }
+            else {
+                x = 0;
+                for ( k = 1; k < 5; k++ ) {
+                    if ( face[i].score[k] > face[i].score[x] ) x = k;
+                }
+                p[0] = (UINT8)(EX_NEUTRAL + x);
+                p[1] = (UINT8)face[i].score[x];
+                p[2] = (UINT8)face[i].degree;
+                p += 3;
+            }
+        }
+        if ( exec & HVC_ACTIV_FACE_RECOGNITION ) {
+            /* -127: album empty, -1: nobody matched */
+            uid = (registered == 0) ? -127 : GetRegisteredUser(pSim, face[i].recogIndex);
+            if ( uid >= 0 && face[i].recogConf < pSim->threshold[3] ) uid = -1;
+            SetLE16(&p[0], uid);
+            SetLE16(&p[2], (uid >= 0) ? face[i].recogConf : 0);
+            p += 4;
+        }
+        if ( exec & HVC_ACTIV_FACE_VERIFY ) {
+            uid = (registered == 0) ? -1 : GetRegisteredUser(pSim, face[i].recogIndex);
+            SetLE16(&p[0], (uid == pSim->verifyUser && face[i].recogConf >= pSim->verifyThreshold) ? 1 : 0);
+            SetLE16(&p[2], face[i].recogConf);
+            p += 4;
+        }
+    }
+    if ( image != HVC_EXECUTE_IMAGE_NONE ) {
+        width = (image == HVC_EXECUTE_IMAGE_QVGA) ? 320 : 160;
+        height = (image == HVC_EXECUTE_IMAGE_QVGA) ? 240 : 120;
+        SetLE16(&p[0], width);
+        SetLE16(&p[2], height);
+        p += 4;
+        /* Moving gradient, so consecutive frames differ */
+        for ( y = 0; y < height; y++ ) {
+            for ( x = 0; x < width; x++ ) {
+                *p++ = (UINT8)(x + y * 2 + pSim->frame * 3);
+            }
+        }
+    }
+
+    /* Detectors cost a fixed time, estimators cost time per face */
+    time = t[HVCSIM_TIME_COMMAND];
+    if ( exec & HVC_ACTIV_BODY_DETECTION ) time += t[HVCSIM_TIME_BODY];
+    if ( exec & HVC_ACTIV_HAND_DETECTION ) time += t[HVCSIM_TIME_HAND];
+    if ( exec & 0x7FC ) time += t[HVCSIM_TIME_FACE];
+    if ( exec & HVC_ACTIV_FACE_DIRECTION ) time += t[HVCSIM_TIME_DIRECTION] * nFace;
+    if ( exec & HVC_ACTIV_AGE_ESTIMATION ) time += t[HVCSIM_TIME_AGE] * nFace;
+    if ( exec & HVC_ACTIV_GENDER_ESTIMATION ) time += t[HVCSIM_TIME_GENDER] * nFace;
+    if ( exec & HVC_ACTIV_GAZE_ESTIMATION ) time += t[HVCSIM_TIME_GAZE] * nFace;
+    if ( exec & HVC_ACTIV_BLINK_ESTIMATION ) time += t[HVCSIM_TIME_BLINK] * nFace;
+    if ( exec & HVC_ACTIV_EXPRESSION_ESTIMATION ) time += t[HVCSIM_TIME_EXPRESSION] * nFace;
+    if ( exec & HVC_ACTIV_FACE_RECOGNITION ) time += t[HVCSIM_TIME_RECOGNITION] * nFace;
+    if ( exec & HVC_ACTIV_FACE_VERIFY ) time += t[HVCSIM_TIME_VERIFY] * nFace;
+    if ( image != HVC_EXECUTE_IMAGE_NONE ) time += t[HVCSIM_TIME_IMAGE];
+
+    Respond(pSim, HVCSIM_STATUS_NORMAL, (INT32)(p - d), inCmdSize, time);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Album image: 8-byte header (size, CRC32) + 32-byte album header            */
+/*              + 816 bytes per registered data                               */
+/*----------------------------------------------------------------------------*/
+static INT32 MakeAlbum(HVCSIM *pSim, UINT8 *outAlbum)
+{
+    UINT8 *body = &outAlbum[SIM_ALBUM_HEADER];
+    UINT8 *p = &body[HVC_ALBUM_SIZE_MIN];
+    INT32 uid, did, i, num = 0;
+    INT32 size;
+    UINT32 state;
+
+    for ( uid = 0; uid < SIM_USER_MAX; uid++ ) {
+        for ( did = 0; did < SIM_DATA_MAX; did++ ) {
+            if ( (pSim->regist[uid] & (1 << did)) == 0 ) continue;
+            SetLE16(&p[0], uid);
+            p[2] = (UINT8)did;
+            p[3] = 0;
+            /* Feature vector stands in for the real template */
+            state = SeedRandom((UINT32)uid, (UINT32)did);
+            for ( i = 4; i < SIM_ALBUM_ENTRY_SIZE; i++ ) {
+                p[i] = (UINT8)NextRandom(&state);
+            }
+            p += SIM_ALBUM_ENTRY_SIZE;
+            num++;
+        }
+    }
+    memset(body, 0, HVC_ALBUM_SIZE_MIN);
+    memcpy(body, "HVCSIMAL", 8);
+    SetLE32(&body[8], (UINT32)num);
+    SetLE16(&body[12], pSim->registCount);
+
+    size = HVC_ALBUM_SIZE_MIN + num * SIM_ALBUM_ENTRY_SIZE;
+    SetLE32(&outAlbum[0], (UINT32)size);
+    SetLE32(&outAlbum[4], Crc32(body, size));
+    return SIM_ALBUM_HEADER + size;
+}
+
+/* Rebuilds the registration table from an album; 0 on success */
+static INT32 ParseAlbum(HVCSIM *pSim, const UINT8 *inAlbum, INT32 inSize)
+{
+    const UINT8 *body = &inAlbum[SIM_ALBUM_HEADER];
+    const UINT8 *p;
+    unsigned short regist[SIM_USER_MAX];
+    INT32 size, num, i, uid, did;
+
+    if ( inSize < SIM_ALBUM_HEADER + HVC_ALBUM_SIZE_MIN ) return -1;
+    size = (INT32)GetLE32(&inAlbum[0]);
+    if ( size != inSize - SIM_ALBUM_HEADER ) return -1;
+    if ( GetLE32(&inAlbum[4]) != Crc32(body, size) ) return -1;
+    if ( memcmp(body, "HVCSIMAL", 8) != 0 ) return -1;
+    num = (INT32)GetLE32(&body[8]);
+    if ( num < 0 || num > SIM_ALBUM_ENTRY_MAX ) return -1;
+    if ( size != HVC_ALBUM_SIZE_MIN + num * SIM_ALBUM_ENTRY_SIZE ) return -1;
+
+    memset(regist, 0, sizeof(regist));
+    p = &body[HVC_ALBUM_SIZE_MIN];
+    for ( i = 0; i < num; i++ ) {
+        uid = GetLE16(&p[0]);
+        did = p[2];
+        if ( uid >= SIM_USER_MAX || did >= SIM_DATA_MAX ) return -1;
+        regist[uid] |= (unsigned short)(1 << did);
+        p += SIM_ALBUM_ENTRY_SIZE;
+    }
+    memcpy(pSim->regist, regist, sizeof(regist));
+    pSim->registCount = GetLE16(&body[12]);
+    return 0;
+}
+
+static INT32 CountEntries(HVCSIM *pSim)
+{
+    INT32 i, k, num = 0;
+
+    for ( i = 0; i < SIM_USER_MAX; i++ ) {
+        for ( k = 0; k < SIM_DATA_MAX; k++ ) {
+            if ( pSim->regist[i] & (1 << k) ) num++;
+        }
+    }
+    return num;
+}
+
+/*----------------------------------------------------------------------------*/
+/* One complete command                                                       */
+/* param    : HVCSIM        *pSim           simulator                         */
+/*          : UINT8         inCommand       command number                    */
+/*          : const UINT8   *inData         command data                      */
+/*          : INT32         inSize          command data size                 */
+/*          : INT32         inCmdSize       whole command size on the wire    */
+/*----------------------------------------------------------------------------*/
+static void Command(HVCSIM *pSim, UINT8 inCommand, const UINT8 *inData, INT32 inSize, INT32 inCmdSize)
+{
+    static const UINT8 version[12] = { 'B','5','T','-','0','0','7','0','0','1',' ',' ' };
+    const INT32 *t = pSim->config.procTime;
+    UINT8 *d = &pSim->pOut[SIM_RECV_HEAD_NUM];
+    UINT8 status = HVCSIM_STATUS_NORMAL;
+    INT32 size = 0;
+    INT32 time = t[HVCSIM_TIME_COMMAND];
+    INT32 baudIndex = -1;
+    INT32 i, uid, did;
+
+/* Parameter check shorthand: answer "improper" and return */
+#define SIM_CHECK(cond) \
+    if ( !(cond) ) { Respond(pSim, HVCSIM_STATUS_IMPROPER, 0, inCmdSize, time); return; }
+
+    switch ( inCommand ) {
+    case SIM_COM_GET_VERSION:
+        SIM_CHECK(inSize == 0);
+        memcpy(d, version, sizeof(version));
+        d[12] = 2;                      /* major */
+        d[13] = 1;                      /* minor */
+        d[14] = 0;                      /* release */
+        memset(&d[15], 0, 4);           /* revision */
+        size = 19;
+        break;
+    case SIM_COM_SET_CAMERA_ANGLE:
+        SIM_CHECK(inSize == 1 && inData[0] <= 3);
+        pSim->cameraAngle = inData[0];
+        break;
+    case SIM_COM_GET_CAMERA_ANGLE:
+        SIM_CHECK(inSize == 0);
+        d[0] = (UINT8)pSim->cameraAngle;
+        size = 1;
+        break;
+    case SIM_COM_EXECUTE:
+    case SIM_COM_EXECUTEEX:
+        CommandExecute(pSim, inCommand, inData, inSize, inCmdSize);
+        return;
+    case SIM_COM_SET_THRESHOLD:
+        SIM_CHECK(inSize == 8);
+        for ( i = 0; i < 4; i++ ) {
+            SIM_CHECK(GetLE16(&inData[i * 2]) >= 1 && GetLE16(&inData[i * 2]) <= 1000);
+        }
+        for ( i = 0; i < 4; i++ ) {
+            pSim->threshold[i] = GetLE16(&inData[i * 2]);
+        }
+        break;
+    case SIM_COM_GET_THRESHOLD:
+        SIM_CHECK(inSize == 0);
+        for ( i = 0; i < 4; i++ ) {
+            SetLE16(&d[i * 2], pSim->threshold[i]);
+        }
+        size = 8;
+        break;
+    case SIM_COM_SET_SIZE_RANGE:
+        SIM_CHECK(inSize == 12);
+        for ( i = 0; i < 6; i += 2 ) {
+            SIM_CHECK(GetLE16(&inData[i * 2]) <= GetLE16(&inData[i * 2 + 2]));
+        }
+        for ( i = 0; i < 6; i++ ) {
+            pSim->sizeRange[i] = GetLE16(&inData[i * 2]);
+        }
+        break;
+    case SIM_COM_GET_SIZE_RANGE:
+        SIM_CHECK(inSize == 0);
+        for ( i = 0; i < 6; i++ ) {
+            SetLE16(&d[i * 2], pSim->sizeRange[i]);
+        }
+        size = 12;
+        break;
+    case SIM_COM_SET_DETECTION_ANGLE:
+        SIM_CHECK(inSize == 2 && inData[0] <= 2 && inData[1] <= 1);
+        pSim->pose = inData[0];
+        pSim->angle = inData[1];
+        break;
+    case SIM_COM_GET_DETECTION_ANGLE:
+        SIM_CHECK(inSize == 0);
+        d[0] = (UINT8)pSim->pose;
+        d[1] = (UINT8)pSim->angle;
+        size = 2;
+        break;
+    case SIM_COM_SET_BAUDRATE:
+        SIM_CHECK(inSize == 1 && inData[0] < SIM_BAUDRATE_NUM);
+        /* The answer still goes out at the old speed */
+        baudIndex = inData[0];
+        break;
+    case SIM_COM_REGISTRATION:
+        SIM_CHECK(inSize == 3);
+        uid = GetLE16(inData);
+        did = inData[2];
+        SIM_CHECK(uid < SIM_USER_MAX && did < SIM_DATA_MAX && did < pSim->registCount);
+        time = t[HVCSIM_TIME_REGISTRATION];
+        if ( pSim->config.maxFace == 0 ) {
+            status = HVCSIM_STATUS_NO_FACE;
+            break;
+        }
+        if ( (pSim->regist[uid] & (1 << did)) == 0 && CountEntries(pSim) >= SIM_ALBUM_ENTRY_MAX ) {
+            status = HVCSIM_STATUS_ALBUM_FULL;
+            break;
+        }
+        pSim->regist[uid] |= (unsigned short)(1 << did);
+        SetLE16(&d[0], SIM_REGIST_IMAGE);
+        SetLE16(&d[2], SIM_REGIST_IMAGE);
+        for ( i = 0; i < SIM_REGIST_IMAGE * SIM_REGIST_IMAGE; i++ ) {
+            d[4 + i] = (UINT8)(i + uid * 7 + did * 31);
+        }
+        size = 4 + SIM_REGIST_IMAGE * SIM_REGIST_IMAGE;
+        break;
+    case SIM_COM_DELETE_DATA:
+        SIM_CHECK(inSize == 3);
+        uid = GetLE16(inData);
+        did = inData[2];
+        SIM_CHECK(uid < SIM_USER_MAX && did < SIM_DATA_MAX);
+        pSim->regist[uid] &= (unsigned short)~(1 << did);
+        break;
+    case SIM_COM_DELETE_USER:
+        SIM_CHECK(inSize == 2 && GetLE16(inData) < SIM_USER_MAX);
+        pSim->regist[GetLE16(inData)] = 0;
+        break;
+    case SIM_COM_DELETE_ALL:
+        SIM_CHECK(inSize == 0);
+        memset(pSim->regist, 0, sizeof(pSim->regist));
+        break;
+    case SIM_COM_GET_PERSON_DATA:
+        SIM_CHECK(inSize == 2 && GetLE16(inData) < SIM_USER_MAX);
+        SetLE16(d, pSim->regist[GetLE16(inData)]);
+        size = 2;
+        break;
+    case SIM_COM_SAVE_ALBUM:
+        SIM_CHECK(inSize == 0);
+        time = t[HVCSIM_TIME_SAVE_ALBUM];
+        size = MakeAlbum(pSim, d);
+        break;
+    case SIM_COM_LOAD_ALBUM:
+        time = t[HVCSIM_TIME_LOAD_ALBUM];
+        SIM_CHECK(inSize >= 4 && (INT32)GetLE32(inData) == inSize - 4);
+        SIM_CHECK(ParseAlbum(pSim, &inData[4], inSize - 4) == 0);
+        break;
+    case SIM_COM_WRITE_ALBUM:
+        SIM_CHECK(inSize == 0);
+        time = t[HVCSIM_TIME_WRITE_ALBUM];
+        memcpy(pSim->flash, pSim->regist, sizeof(pSim->flash));
+        break;
+    case SIM_COM_REFORMAT_ALBUM:
+        SIM_CHECK(inSize == 0);
+        time = t[HVCSIM_TIME_REFORMAT_ALBUM];
+        memset(pSim->flash, 0, sizeof(pSim->flash));
+        break;
+    case SIM_COM_SET_VERIFY_THRESHOLD:
+        SIM_CHECK(inSize == 2 && GetLE16(inData) >= 1 && GetLE16(inData) <= 1000);
+        pSim->verifyThreshold = GetLE16(inData);
+        break;
+    case SIM_COM_GET_VERIFY_THRESHOLD:
+        SIM_CHECK(inSize == 0);
+        SetLE16(d, pSim->verifyThreshold);
+        size = 2;
+        break;
+    case SIM_COM_SET_VERIFY_USER:
+        SIM_CHECK(inSize == 2 && GetLE16(inData) < SIM_USER_MAX);
+        pSim->verifyUser = GetLE16(inData);
+        break;
+    case SIM_COM_GET_VERIFY_USER:
+        SIM_CHECK(inSize == 0);
+        SetLE16(d, pSim->verifyUser);
+        size = 2;
+        break;
+    case SIM_COM_SET_REGIST_COUNT:
+        SIM_CHECK(inSize == 1 && inData[0] >= 1 && inData[0] <= SIM_DATA_MAX);
+        /* Changing the layout empties the album */
+        time = t[HVCSIM_TIME_REFORMAT_ALBUM];
+        pSim->registCount = inData[0];
+        memset(pSim->regist, 0, sizeof(pSim->regist));
+        memset(pSim->flash, 0, sizeof(pSim->flash));
+        break;
+    case SIM_COM_GET_REGIST_COUNT:
+        SIM_CHECK(inSize == 0);
+        d[0] = (UINT8)pSim->registCount;
+        size = 1;
+        break;
+    default:
+        status = HVCSIM_STATUS_UNKNOWN_COMMAND;
+        break;
+    }
+#undef SIM_CHECK
+
+    Respond(pSim, status, size, inCmdSize, time);
+    if ( baudIndex >= 0 ) {
+        pSim->baudIndex = baudIndex;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/* Feed bytes sent by the host                                                */
+/* param    : HVCSIM        *pSim           simulator                         */
+/*          : const UINT8   *inData         received bytes                    */
+/*          : INT32         inSize          number of bytes                   */
+/* return   : INT32                         number of commands answered       */
+/*----------------------------------------------------------------------------*/
+INT32 HVCSim_Input(HVCSIM *pSim, const UINT8 *inData, INT32 inSize)
+{
+    INT32 num = 0;
+    INT32 copy, rest, len, total;
+    UINT8 *p;
+
+    if ( pSim == NULL || inData == NULL || inSize < 0 ) return 0;
+
+    while ( inSize > 0 ) {
+        /* Compact before appending */
+        if ( pSim->nRead > 0 ) {
+            memmove(pSim->pIn, &pSim->pIn[pSim->nRead], pSim->nIn - pSim->nRead);
+            pSim->nIn -= pSim->nRead;
+            pSim->nRead = 0;
+        }
+        copy = SIM_IN_SIZE - pSim->nIn;
+        if ( copy > inSize ) copy = inSize;
+        memcpy(&pSim->pIn[pSim->nIn], inData, copy);
+        pSim->nIn += copy;
+        inData += copy;
+        inSize -= copy;
+
+        for ( ;; ) {
+            p = &pSim->pIn[pSim->nRead];
+            rest = pSim->nIn - pSim->nRead;
+
+            /* Anything before a sync byte is line noise */
+            while ( rest > 0 && p[0] != 0xFE ) {
+                p++;
+                rest--;
+                pSim->nRead++;
+            }
+            if ( rest < SIM_SEND_HEAD_NUM ) break;
+
+            len = GetLE16(&p[2]);
+            total = SIM_SEND_HEAD_NUM + len;
+            /* LoadAlbum: the album follows the 4-byte size it declares */
+            if ( p[1] == SIM_COM_LOAD_ALBUM && len == 4 ) {
+                if ( rest < SIM_SEND_HEAD_NUM + 4 ) break;
+                len = (INT32)GetLE32(&p[SIM_SEND_HEAD_NUM]);
+                if ( len >= 0 && len <= SIM_ALBUM_HEADER + HVC_ALBUM_SIZE_MAX ) {
+                    total += len;
+                    len += 4;
+                }
+                else {
+                    len = 4;
+                }
+            }
+            if ( rest < total ) break;
+
+            Command(pSim, p[1], &p[SIM_SEND_HEAD_NUM], len, total);
+            pSim->nRead += total;
+            num++;
+        }
+        if ( pSim->nRead == pSim->nIn ) {
+            pSim->nRead = 0;
+            pSim->nIn = 0;
+        }
+    }
+    return num;
+}
@@ -0,0 +1,100 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    HVC-P2 device simulator
+*/
+
+#ifndef HVCSim_H__
+#define HVCSim_H__
+
+#include "HVCApi.h"
+#include "HVCDef.h"
+
+/* Response status codes returned by the simulated device */
+#define HVCSIM_STATUS_NORMAL            0x00
+#define HVCSIM_STATUS_NO_FACE           0x02    /* Registration without a face */
+#define HVCSIM_STATUS_ALBUM_FULL        0x03    /* No room for another entry */
+#define HVCSIM_STATUS_IMPROPER          0xFD    /* Invalid parameter or album */
+#define HVCSIM_STATUS_UNKNOWN_COMMAND   0xFF
+
+/* Processing time table index */
+typedef enum {
+    HVCSIM_TIME_COMMAND = 0,            /* Any command not listed below */
+    HVCSIM_TIME_BODY,
+    HVCSIM_TIME_HAND,
+    HVCSIM_TIME_FACE,
+    HVCSIM_TIME_DIRECTION,
+    HVCSIM_TIME_AGE,
+    HVCSIM_TIME_GENDER,
+    HVCSIM_TIME_GAZE,
+    HVCSIM_TIME_BLINK,
+    HVCSIM_TIME_EXPRESSION,
+    HVCSIM_TIME_RECOGNITION,
+    HVCSIM_TIME_VERIFY,
+    HVCSIM_TIME_IMAGE,                  /* Output image capture */
+    HVCSIM_TIME_REGISTRATION,
+    HVCSIM_TIME_SAVE_ALBUM,
+    HVCSIM_TIME_LOAD_ALBUM,
+    HVCSIM_TIME_WRITE_ALBUM,
+    HVCSIM_TIME_REFORMAT_ALBUM,
+    HVCSIM_TIME_NUM
+} HVCSIM_TIME;
+
+/*----------------------------------------------------------------------------*/
+/* Simulator configuration                                                    */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    UINT32  seed;                       /* Seed of the synthetic detections */
+    INT32   maxBody;                    /* Upper bound of bodies per frame (0-35) */
+    INT32   maxHand;                    /* Upper bound of hands per frame (0-35) */
+    INT32   maxFace;                    /* Upper bound of faces per frame (0-35) */
+    INT32   procTime[HVCSIM_TIME_NUM];  /* Processing time per function (us) */
+} HVCSIM_CONFIG;
+
+typedef struct HVCSIM HVCSIM;
+
+/*----------------------------------------------------------------------------*/
+/* Response sink                                                              */
+/* param    : void          *pParam         user parameter                    */
+/*          : const UINT8   *inData         complete response (header + data) */
+/*          : INT32         inSize          response size                     */
+/*          : INT32         inCmdSize       size of the command it answers    */
+/*          : INT32         inProcTime      device processing time (us)       */
+/*----------------------------------------------------------------------------*/
+typedef void (*HVCSIM_OUTPUT_FUNC)(void *pParam, const UINT8 *inData, INT32 inSize,
+                                   INT32 inCmdSize, INT32 inProcTime);
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+void HVCSim_DefaultConfig(HVCSIM_CONFIG *outConfig);
+INT32 HVCSim_SetProcTime(HVCSIM_CONFIG *ioConfig, const char *inName, INT32 inTime);
+const char *HVCSim_GetProcTimeName(INT32 inIndex);
+
+HVCSIM *HVCSim_Create(const HVCSIM_CONFIG *inConfig, HVCSIM_OUTPUT_FUNC inFunc, void *pParam);
+void HVCSim_Destroy(HVCSIM *pSim);
+INT32 HVCSim_Input(HVCSIM *pSim, const UINT8 *inData, INT32 inSize);
+void HVCSim_Reset(HVCSIM *pSim);
+INT32 HVCSim_GetBaudRate(HVCSIM *pSim);
+UINT32 HVCSim_GetFrameCount(HVCSIM *pSim);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* HVCSim_H__ */
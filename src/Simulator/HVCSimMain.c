@@ -0,0 +1,282 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    HVC-P2 simulator on a pseudo-terminal (Linux)
+
+    Prints the slave device path; the host opens it like a real HVC-P2
+    (e.g. Sample tty:/dev/pts/3).  Every response is held back for the
+    command's wire time plus the device processing time, then written out
+    at the current baud rate.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include "HVCSim.h"
+
+#define SIM_READ_SIZE       65536
+#define SIM_BITS_PER_BYTE   10          /* start + 8 data + stop */
+#define SIM_PACE_SLICE_US   1000        /* Granularity of the paced writer */
+
+typedef struct {
+    int         fdMaster;
+    HVCSIM      *pSim;
+    double      dScale;                 /* Processing time multiplier */
+    int         bWireTime;              /* Emulate the line speed */
+    int         bVerbose;
+    unsigned long nResponses;
+} SIM_PTY;
+
+static volatile sig_atomic_t m_bStop = 0;
+
+static void OnSignal(int sig)
+{
+    (void)sig;
+    m_bStop = 1;
+}
+
+static void AddUs(struct timespec *ioTime, long long inUs)
+{
+    long long ns = (long long)ioTime->tv_nsec + (inUs % 1000000) * 1000;
+
+    ioTime->tv_sec += (time_t)(inUs / 1000000 + ns / 1000000000);
+    ioTime->tv_nsec = (long)(ns % 1000000000);
+}
+
+static void SleepUntil(const struct timespec *inTime)
+{
+    while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, inTime, NULL) == EINTR ) {
+        if ( m_bStop ) break;
+    }
+}
+
+static int WriteAll(int fd, const unsigned char *buf, int len)
+{
+    int n, done = 0;
+
+    while ( done < len ) {
+        n = write(fd, &buf[done], len - done);
+        if ( n < 0 ) {
+            if ( errno == EINTR ) continue;
+            return -1;
+        }
+        done += n;
+    }
+    return done;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Response sink: waits as long as the device would, then paces the bytes     */
+/*----------------------------------------------------------------------------*/
+static void OnResponse(void *pParam, const UINT8 *inData, INT32 inSize, INT32 inCmdSize, INT32 inProcTime)
+{
+    SIM_PTY *pPty = (SIM_PTY *)pParam;
+    struct timespec start, next;
+    long long baud = HVCSim_GetBaudRate(pPty->pSim);
+    long long delay;
+    int chunk, done;
+
+    if ( pPty->bVerbose ) {
+        printf("response status=0x%02X size=%d command=%d bytes proc=%dus\n",
+               inData[1], (int)inSize, (int)inCmdSize, (int)inProcTime);
+    }
+    pPty->nResponses++;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    delay = (long long)(inProcTime * pPty->dScale);
+    if ( pPty->bWireTime ) {
+        /* The pty delivered the command at once; a UART would not have */
+        delay += (long long)inCmdSize * SIM_BITS_PER_BYTE * 1000000 / baud;
+    }
+    AddUs(&start, delay);
+    SleepUntil(&start);
+
+    if ( !pPty->bWireTime ) {
+        WriteAll(pPty->fdMaster, inData, inSize);
+        return;
+    }
+
+    /* About one slice worth of bytes per write, on an absolute schedule */
+    chunk = (int)(baud * SIM_PACE_SLICE_US / (SIM_BITS_PER_BYTE * 1000000LL));
+    if ( chunk < 1 ) chunk = 1;
+    for ( done = 0; done < inSize && !m_bStop; ) {
+        if ( chunk > inSize - done ) chunk = inSize - done;
+        if ( WriteAll(pPty->fdMaster, &inData[done], chunk) < 0 ) return;
+        done += chunk;
+        next = start;
+        AddUs(&next, (long long)done * SIM_BITS_PER_BYTE * 1000000 / baud);
+        SleepUntil(&next);
+    }
+}
+
+static int OpenMaster(char *outSlaveName, int inNameSize)
+{
+    int fd;
+    struct termios tio;
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ( fd < 0 ) return -1;
+    if ( grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, outSlaveName, inNameSize) != 0 ) {
+        close(fd);
+        return -1;
+    }
+    if ( tcgetattr(fd, &tio) == 0 ) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static void PrintUsage(void)
+{
+    int i;
+
+    printf("Usage: HVCSim [options]\n");
+    printf("    -s seed          seed of the synthetic detections (default 1)\n");
+    printf("    -n body,hand,face  maximum detections per frame (default 3,3,3)\n");
+    printf("    -t name=us       processing time of one function\n");
+    printf("    -x scale         multiply every processing time (0: answer at once)\n");
+    printf("    -w               no wire time, write responses at full speed\n");
+    printf("    -l path          symbolic link to the slave device\n");
+    printf("    -v               print every response\n");
+    printf("  processing time names:");
+    for ( i = 0; HVCSim_GetProcTimeName(i) != NULL; i++ ) {
+        printf(" %s", HVCSim_GetProcTimeName(i));
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    HVCSIM_CONFIG config;
+    SIM_PTY pty;
+    char slave[64];
+    char *pLink = NULL;
+    char *pEq;
+    unsigned char *pBuf;
+    int fdSlave;
+    int i, n;
+    struct pollfd pfd;
+    struct sigaction sa;
+
+    HVCSim_DefaultConfig(&config);
+    memset(&pty, 0, sizeof(pty));
+    pty.dScale = 1.0;
+    pty.bWireTime = 1;
+
+    for ( i = 1; i < argc; i++ ) {
+        if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) {
+            config.seed = (UINT32)strtoul(argv[++i], NULL, 0);
+        }
+        else if ( strcmp(argv[i], "-n") == 0 && i + 1 < argc ) {
+            if ( sscanf(argv[++i], "%d,%d,%d", &config.maxBody, &config.maxHand, &config.maxFace) != 3 ) {
+                PrintUsage();
+                return -1;
+            }
+        }
+        else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) {
+            pEq = strchr(argv[++i], '=');
+            if ( pEq == NULL ) {
+                PrintUsage();
+                return -1;
+            }
+            *pEq = '\0';
+            if ( HVCSim_SetProcTime(&config, argv[i], atoi(pEq + 1)) != 0 ) {
+                printf("Unknown processing time: %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if ( strcmp(argv[i], "-x") == 0 && i + 1 < argc ) {
+            pty.dScale = atof(argv[++i]);
+            if ( pty.dScale < 0 ) pty.dScale = 0;
+        }
+        else if ( strcmp(argv[i], "-w") == 0 ) {
+            pty.bWireTime = 0;
+        }
+        else if ( strcmp(argv[i], "-l") == 0 && i + 1 < argc ) {
+            pLink = argv[++i];
+        }
+        else if ( strcmp(argv[i], "-v") == 0 ) {
+            pty.bVerbose = 1;
+        }
+        else {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    pBuf = (unsigned char *)malloc(SIM_READ_SIZE);
+    pty.pSim = HVCSim_Create(&config, OnResponse, &pty);
+    if ( pBuf == NULL || pty.pSim == NULL ) {
+        printf("Out of memory.\n");
+        return -1;
+    }
+    pty.fdMaster = OpenMaster(slave, sizeof(slave));
+    if ( pty.fdMaster < 0 ) {
+        printf("Failed to open pty.\n");
+        return -1;
+    }
+    /* Keep one slave descriptor open so the master never sees a hang-up */
+    /* while the host closes and reopens the port (baud rate change).   */
+    fdSlave = open(slave, O_RDWR | O_NOCTTY);
+    if ( pLink != NULL ) {
+        unlink(pLink);
+        if ( symlink(slave, pLink) != 0 ) {
+            printf("Failed to link %s.\n", pLink);
+            pLink = NULL;
+        }
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("%s\n", slave);
+    fflush(stdout);
+
+    pfd.fd = pty.fdMaster;
+    pfd.events = POLLIN;
+    while ( !m_bStop ) {
+        if ( poll(&pfd, 1, 200) <= 0 ) continue;
+        n = read(pty.fdMaster, pBuf, SIM_READ_SIZE);
+        if ( n <= 0 ) {
+            if ( n < 0 && errno != EINTR && errno != EAGAIN ) usleep(10000);
+            continue;
+        }
+        HVCSim_Input(pty.pSim, pBuf, n);
+        if ( pty.bVerbose ) fflush(stdout);
+    }
+
+    if ( pty.bVerbose ) {
+        printf("%lu responses, %u frames\n", pty.nResponses, HVCSim_GetFrameCount(pty.pSim));
+    }
+    if ( pLink != NULL ) unlink(pLink);
+    if ( fdSlave >= 0 ) close(fdSlave);
+    close(pty.fdMaster);
+    HVCSim_Destroy(pty.pSim);
+    free(pBuf);
+    return 0;
+}
@@ -23,18 +23,166 @@ typedef struct {
     unsigned long BaudRate;     /* Baud rate 9600-921600 */
 } S_STAT;
 
+/* Handle of one opened port (NULL...not opened).    */
+/* Every port has its own buffers and receive state. */
+typedef struct COM_DEVICE *HCOM;
+
+/* One region of bytes: received data exposed in place by com_peek()     */
+/* (the buffer can wrap around once, so up to two regions), or one part   */
+/* of a block handed to com_sendv().                                      */
+typedef struct {
+    const unsigned char *pData;
+    int                 nSize;
+} COM_SPAN;
+
+/* Receive thread settings (com_set_rx_config()) */
+#define COM_SCHED_OTHER     0       /* Normal time-sharing (default) */
+#define COM_SCHED_FIFO      1       /* Real-time, runs until it blocks */
+#define COM_SCHED_RR        2       /* Real-time, round robin among equal priorities */
+
+typedef struct {
+    int                 nPolicy;        /* COM_SCHED_* */
+    int                 nPriority;      /* 1-99 for FIFO/RR, ignored for OTHER */
+    unsigned long long  nCpuMask;       /* Bit n...may run on CPU n, 0...any CPU */
+    int                 bLockMemory;    /* Keep the receive buffer resident (mlock) */
+} COM_RX_CONFIG;
+
+/* How tty/pty ports opened afterwards are read (com_set_rx_mode(), Linux) */
+#define COM_RX_THREAD       0       /* One receive thread per port (default) */
+#define COM_RX_REACTOR      1       /* One epoll thread shared by all ports */
+
+/* com_set_rx_config() results; each setting is tried even if another fails */
+#define COM_RX_CONFIG_UNSUPPORTED   -1  /* Backend has no receive thread */
+#define COM_RX_CONFIG_ERR_SCHED     -2  /* Policy/priority refused (needs CAP_SYS_NICE or RLIMIT_RTPRIO) */
+#define COM_RX_CONFIG_ERR_AFFINITY  -3  /* No usable CPU in the mask */
+#define COM_RX_CONFIG_ERR_MLOCK     -4  /* Lock refused (needs CAP_IPC_LOCK or RLIMIT_MEMLOCK) */
+
+/*----------------------------------------------------------------------------*/
+/* Transport backend                                                          */
+/* A backend allocates its own device struct with struct COM_DEVICE as the    */
+/* first member; com_send()/com_recv()/... dispatch through pOps.             */
+/*----------------------------------------------------------------------------*/
+typedef struct {
+    const char  *name;          /* Prefix selecting the backend: "<name>:<target>" */
+    HCOM (*open)(const char *target, unsigned long BaudRate);
+    void (*close)(HCOM hCom);
+    int  (*send)(HCOM hCom, unsigned char *buf, int len);
+    int  (*recv)(HCOM hCom, int inTimeOutTimer, unsigned char *buf, int len);
+    int  (*length)(HCOM hCom);
+    /* Optional (NULL...com_peek() is not supported by the backend) */
+    int  (*peek)(HCOM hCom, int inTimeOutTimer, int len, COM_SPAN *outSpan);
+    void (*consume)(HCOM hCom, int len);
+    /* Optional (NULL...com_sendv() calls send for each region) */
+    int  (*sendv)(HCOM hCom, const COM_SPAN *pVec, int nVec);
+    /* Optional (NULL...the backend has no receive thread) */
+    int  (*rxconfig)(HCOM hCom, const COM_RX_CONFIG *pConfig);
+} COM_OPS;
+
+#define COM_SENDV_MAX   16      /* Most regions in one com_sendv() */
+
+/* com_sendv_flags() flags */
+#define COM_SEND_KEEP_RX    0x0001  /* Keep unread received bytes: the answers */
+                                    /* to commands sent before are still due   */
+
+/* Transport counters of one port (com_get_stats()). They only grow until */
+/* com_reset_stats(); compare two snapshots to get rates.                 */
+typedef struct {
+    unsigned long long  nBytesIn;       /* Bytes received from the line */
+    unsigned long long  nBytesOut;      /* Bytes sent */
+    unsigned long long  nReads;         /* Reads from the line that returned data */
+    unsigned long long  nWakeups;       /* Waiting com_recv()/com_peek() callers woken up */
+    unsigned long long  nOverrunBytes;  /* Received bytes dropped: receive buffer full */
+    unsigned long long  nResyncs;       /* Commands sent while stale bytes were still unread */
+    unsigned long long  nResyncBytes;   /* Stale bytes discarded by those commands */
+    unsigned long long  nHeaderResyncs; /* Response headers searched for past stray bytes */
+    unsigned long long  nHeaderSkips;   /* Stray bytes skipped by those searches */
+    unsigned long long  nTimeouts;      /* com_recv()/com_peek() calls that came back short */
+    unsigned int        nMaxBuffered;   /* Highest receive buffer occupancy (bytes) */
+    unsigned int        nBufferSize;    /* Receive buffer capacity, 0...none on the host */
+} COM_STATS;
+
+struct COM_CAPTURE;
+
+struct COM_DEVICE {
+    const COM_OPS       *pOps;      /* Backend of this port */
+    struct COM_CAPTURE  *pCapture;  /* Wire capture, NULL...off (uart_capture.c) */
+    COM_STATS           stats;      /* Updated by the backend and com_send()/com_recv() */
+    int                 nSendFlags; /* COM_SEND_* of the send in progress, read by the backend */
+};
+
+/* Counter update from the backends. The receive thread and the caller  */
+/* update different counters, but com_get_stats() may run on any thread. */
+#ifdef WIN32
+#define COM_STATS_ADD(counter, n)   ((counter) += (n))
+#define COM_STATS_GET(counter)      (counter)
+#define COM_STATS_SET(counter, n)   ((counter) = (n))
+#define COM_STATS_MAX(counter, n)   do { if ( (n) > (counter) ) (counter) = (n); } while ( 0 )
+#else
+#define COM_STATS_ADD(counter, n)   ((void)__atomic_add_fetch(&(counter), (n), __ATOMIC_RELAXED))
+#define COM_STATS_GET(counter)      __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define COM_STATS_SET(counter, n)   __atomic_store_n(&(counter), (n), __ATOMIC_RELAXED)
+#define COM_STATS_MAX(counter, n)   do { if ( (n) > COM_STATS_GET(counter) ) \
+                                        __atomic_store_n(&(counter), (n), __ATOMIC_RELAXED); } while ( 0 )
+#endif
+
+/* Built-in backends */
+extern const COM_OPS com_tty_ops;       /* "tty:"      serial port (default)              */
+#ifndef WIN32
+extern const COM_OPS com_pty_ops;       /* "pty"       master side of a new pseudo-terminal */
+#endif
+extern const COM_OPS com_loopback_ops;  /* "loopback"  in-memory, no device               */
+extern const COM_OPS com_replay_ops;    /* "replay:"   received bytes read from a file    */
+
+/* Device side of the loopback backend.                                       */
+/* Called with every block the host sends; answer with com_loopback_inject(). */
+typedef void (*COM_LOOPBACK_FUNC)(void *pParam, HCOM hCom, const unsigned char *buf, int len);
+
+/* Wire capture file (see uart_capture.c for the layout) */
+#define COM_CAPTURE_MAGIC       "HVCCAP1"
+#define COM_CAPTURE_MAGIC_SIZE  8
+#define COM_CAPTURE_TX          1       /* host -> device, as passed to com_send() */
+#define COM_CAPTURE_RX          2       /* device -> host, as read from the line */
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
 
 #ifndef WIN32
 void com_sleep(int nSleep);
+HCOM com_init_device(const char *device, unsigned long BaudRate);
+const char *com_pty_name(HCOM hCom);
+int com_set_rx_mode(int nMode);
 #endif
 
-void com_close(void);
-int com_init(S_STAT *stat);
-int com_send(unsigned char *buf, int len);
-int com_recv(int inTimeOutTimer, unsigned char *buf, int len);
+void com_close(HCOM hCom);
+HCOM com_init(S_STAT *stat);
+HCOM com_open(const char *spec, unsigned long BaudRate);
+int com_register_transport(const COM_OPS *pOps);
+int com_send(HCOM hCom, unsigned char *buf, int len);
+int com_sendv(HCOM hCom, const COM_SPAN *pVec, int nVec);
+int com_sendv_flags(HCOM hCom, const COM_SPAN *pVec, int nVec, int nFlags);
+int com_recv(HCOM hCom, int inTimeOutTimer, unsigned char *buf, int len);
+int com_length(HCOM hCom);
+int com_peek(HCOM hCom, int inTimeOutTimer, int len, COM_SPAN *outSpan);
+void com_consume(HCOM hCom, int len);
+int com_get_stats(HCOM hCom, COM_STATS *outStats);
+int com_set_rx_config(HCOM hCom, const COM_RX_CONFIG *pConfig);
+void com_reset_stats(HCOM hCom);
+void com_count_resync(HCOM hCom, int nSkipBytes);
+
+void com_loopback_attach(HCOM hCom, COM_LOOPBACK_FUNC func, void *pParam);
+int com_loopback_inject(HCOM hCom, const unsigned char *buf, int len);
+
+int com_capture_start(HCOM hCom, const char *path, int bAppend);
+void com_capture_stop(HCOM hCom);
+
+/* Used by the backends */
+void com_capture_write(HCOM hCom, int type, const unsigned char *buf, int len);
+void com_capture_writev(HCOM hCom, int type, const COM_SPAN *pVec, int nVec);
+void com_capture_free(struct COM_CAPTURE *pCap);
+int com_capture_parse(const unsigned char *buf, int len, int *outType,
+                      unsigned long long *outDeltaUs, int *outDataLen);
+unsigned long long com_capture_time(void);
 
 #ifdef  __cplusplus
 }
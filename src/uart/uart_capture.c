@@ -0,0 +1,285 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Raw wire capture
+*/
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart.h"
+
+/* Capture file layout (all integers little-endian)                     */
+/*   header : "HVCCAP1" + '\0'                                          */
+/*   record : type (1 byte, COM_CAPTURE_TX/RX)                          */
+/*            time since the previous record, us (varint)               */
+/*            length (varint), then the bytes themselves                */
+/* varint: 7 bits per byte, low group first, bit 7 set on all but last. */
+struct COM_CAPTURE {
+#ifdef WIN32
+    CRITICAL_SECTION    cs;
+#else
+    pthread_mutex_t     cs;             /* TX and RX come from different threads */
+#endif
+    FILE                *fp;            /* NULL...capture stopped */
+    unsigned long long  nLastUs;        /* Time of the previous record */
+};
+
+/* Monotonic clock (us) */
+unsigned long long com_capture_time(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER freq, count;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (unsigned long long)(count.QuadPart / freq.QuadPart) * 1000000 +
+           (unsigned long long)((count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000 + (unsigned long long)(ts.tv_nsec / 1000);
+#endif
+}
+
+static int PutVarint(unsigned char *buf, unsigned long long v)
+{
+    int n = 0;
+
+    while ( v >= 0x80 ) {
+        buf[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (unsigned char)v;
+    return n;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Start recording everything a port sends and receives                       */
+/* param    : HCOM          hCom    port                                      */
+/*          : const char    *path   capture file                              */
+/*          : int           bAppend 0...create a new file,                    */
+/*                                  1...continue an existing capture          */
+/*                                  (e.g. after reopening the port)           */
+/* return   : int                   0...normal, -1...cannot open the file     */
+/*----------------------------------------------------------------------------*/
+int com_capture_start(HCOM hCom, const char *path, int bAppend)
+{
+    struct COM_CAPTURE *pCap;
+    FILE *fp;
+    long nSize = 0;
+
+    if ( hCom == NULL || path == NULL ) return -1;
+
+    fp = fopen(path, bAppend ? "ab" : "wb");
+    if ( fp == NULL ) return -1;
+    if ( bAppend ) {
+        fseek(fp, 0, SEEK_END);
+        nSize = ftell(fp);
+    }
+    if ( nSize <= 0 && fwrite(COM_CAPTURE_MAGIC, 1, COM_CAPTURE_MAGIC_SIZE, fp) != COM_CAPTURE_MAGIC_SIZE ) {
+        fclose(fp);
+        return -1;
+    }
+
+    pCap = hCom->pCapture;
+    if ( pCap == NULL ) {
+        pCap = (struct COM_CAPTURE *)calloc(1, sizeof(struct COM_CAPTURE));
+        if ( pCap == NULL ) {
+            fclose(fp);
+            return -1;
+        }
+#ifdef WIN32
+        InitializeCriticalSection(&pCap->cs);
+#else
+        pthread_mutex_init(&pCap->cs, NULL);
+#endif
+    }
+    else {
+        com_capture_stop(hCom);
+    }
+
+#ifdef WIN32
+    EnterCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_lock(&pCap->cs);
+#endif
+    pCap->fp = fp;
+    pCap->nLastUs = com_capture_time();
+#ifdef WIN32
+    LeaveCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_unlock(&pCap->cs);
+#endif
+    /* Published last: the receive thread may look at it any time */
+#ifdef WIN32
+    hCom->pCapture = pCap;
+#else
+    __atomic_store_n(&hCom->pCapture, pCap, __ATOMIC_RELEASE);
+#endif
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Stop recording and flush the capture file                                  */
+/* param    : HCOM          hCom    port                                      */
+/*----------------------------------------------------------------------------*/
+void com_capture_stop(HCOM hCom)
+{
+    struct COM_CAPTURE *pCap;
+
+    if ( hCom == NULL || hCom->pCapture == NULL ) return;
+    pCap = hCom->pCapture;
+
+#ifdef WIN32
+    EnterCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_lock(&pCap->cs);
+#endif
+    if ( pCap->fp != NULL ) {
+        fclose(pCap->fp);
+        pCap->fp = NULL;
+    }
+#ifdef WIN32
+    LeaveCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_unlock(&pCap->cs);
+#endif
+}
+
+/* Releases the capture of a port that is being closed (com_close) */
+void com_capture_free(struct COM_CAPTURE *pCap)
+{
+    if ( pCap == NULL ) return;
+    if ( pCap->fp != NULL ) {
+        fclose(pCap->fp);
+    }
+#ifdef WIN32
+    DeleteCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_destroy(&pCap->cs);
+#endif
+    free(pCap);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Append one record                                                          */
+/* param    : HCOM          hCom    port                                      */
+/*          : int           type    COM_CAPTURE_TX or COM_CAPTURE_RX          */
+/*          : unsigned char *buf    bytes on the wire                         */
+/*          : int           len     number of bytes                           */
+/*----------------------------------------------------------------------------*/
+void com_capture_write(HCOM hCom, int type, const unsigned char *buf, int len)
+{
+    COM_SPAN vec;
+
+    vec.pData = buf;
+    vec.nSize = len;
+    com_capture_writev(hCom, type, &vec, 1);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Append one record gathered from several regions (com_sendv())              */
+/* param    : HCOM          hCom    port                                      */
+/*          : int           type    COM_CAPTURE_TX or COM_CAPTURE_RX          */
+/*          : COM_SPAN      *pVec   bytes on the wire, in order               */
+/*          : int           nVec    number of regions                         */
+/*----------------------------------------------------------------------------*/
+void com_capture_writev(HCOM hCom, int type, const COM_SPAN *pVec, int nVec)
+{
+    struct COM_CAPTURE *pCap = hCom->pCapture;
+    unsigned char head[24];
+    unsigned long long now;
+    int i, n;
+    int len = 0;
+
+    for ( i = 0; i < nVec; i++ ) {
+        if ( pVec[i].nSize > 0 ) len += pVec[i].nSize;
+    }
+    if ( pCap == NULL || len <= 0 ) return;
+
+    now = com_capture_time();
+#ifdef WIN32
+    EnterCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_lock(&pCap->cs);
+#endif
+    if ( pCap->fp != NULL ) {
+        head[0] = (unsigned char)type;
+        n = 1;
+        n += PutVarint(&head[n], (now > pCap->nLastUs) ? now - pCap->nLastUs : 0);
+        n += PutVarint(&head[n], (unsigned long long)len);
+        fwrite(head, 1, n, pCap->fp);
+        for ( i = 0; i < nVec; i++ ) {
+            if ( pVec[i].nSize > 0 ) fwrite(pVec[i].pData, 1, pVec[i].nSize, pCap->fp);
+        }
+        /* A command is the natural point to make the log durable */
+        if ( type == COM_CAPTURE_TX ) {
+            fflush(pCap->fp);
+        }
+        if ( now > pCap->nLastUs ) pCap->nLastUs = now;
+    }
+#ifdef WIN32
+    LeaveCriticalSection(&pCap->cs);
+#else
+    pthread_mutex_unlock(&pCap->cs);
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/* Read one record back (replay transport)                                    */
+/* param    : const unsigned char *buf  capture data after the header         */
+/*          : int           len         bytes left in buf                     */
+/*          : int           *outType    COM_CAPTURE_TX or COM_CAPTURE_RX      */
+/*          : unsigned long long *outDeltaUs  time since previous record      */
+/*          : int           *outDataLen number of data bytes                  */
+/* return   : int                       size of the record header,            */
+/*                                      0...end of data, -1...broken record   */
+/*----------------------------------------------------------------------------*/
+int com_capture_parse(const unsigned char *buf, int len, int *outType,
+                      unsigned long long *outDeltaUs, int *outDataLen)
+{
+    unsigned long long v[2];
+    int k, shift;
+    int n = 1;
+
+    if ( len <= 0 ) return 0;
+    *outType = buf[0];
+    if ( *outType != COM_CAPTURE_TX && *outType != COM_CAPTURE_RX ) return -1;
+
+    for ( k = 0; k < 2; k++ ) {
+        v[k] = 0;
+        shift = 0;
+        for ( ;; ) {
+            if ( n >= len || shift > 63 ) return -1;
+            v[k] |= (unsigned long long)(buf[n] & 0x7F) << shift;
+            shift += 7;
+            if ( (buf[n++] & 0x80) == 0 ) break;
+        }
+    }
+    if ( v[1] > (unsigned long long)(len - n) ) return -1;
+    *outDeltaUs = v[0];
+    *outDataLen = (int)v[1];
+    return n;
+}
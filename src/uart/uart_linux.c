@@ -14,38 +14,88 @@
 /* limitations under the License.                                            */
 /*---------------------------------------------------------------------------*/
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <memory.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
 #include <pthread.h>
 #include <termios.h>
+#include <time.h>
+#include <sys/epoll.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include "uart.h"
+#include "uart_ring.h"
 
 typedef pthread_mutex_t CRITICAL_SECTION;
 
 #define	SIZE_RCVBUF	(1 * 1024 * 1024)
-
-static void ExecThread(void *pParam);
-
-static CRITICAL_SECTION cs;
-
-static int hCom = -1;
-static struct termios save_options;
-
-static int m_bThread = 0;	    		// stO
-static pthread_t m_hThread = (pthread_t)NULL;		// MXbh
-
-static int m_ptrRead = 0;
-static int m_ptrReceive = 0;
-static unsigned char m_acRcvBuf[SIZE_RCVBUF];
-static int m_nReceiveCount = 0;
+#define	SIZE_RXCHUNK	(4 * 1024)      /* Max bytes moved per read() in the receive thread */
+#define	REACTOR_EVENTS	64              /* Ready ports handled per epoll_wait() */
+
+/* One opened serial port (tty/pty backends). Everything the receive  */
+/* thread and the API callers share lives here, so any number of ports */
+/* can be driven from one process.                                     */
+typedef struct {
+    struct COM_DEVICE   base;           /* Must be first */
+    int                 fd;             /* Serial port */
+    struct termios      save_options;   /* Settings restored on close */
+
+    CRITICAL_SECTION    cs;
+    pthread_cond_t      condRecv;       /* Signalled by the receive thread when bytes are buffered */
+    int                 bSync;          /* cs and condRecv are initialised */
+    int                 nWaiters;       /* Callers sleeping in com_recv() (atomic) */
+    int                 bRxAlive;       /* Receive thread is still reading the line (atomic) */
+
+    int                 bThread;        // stO
+    pthread_t           hThread;        // MXbh
+    int                 fdWake[2];      /* Self-pipe used to wake the receive thread on close */
+    int                 bReactor;       /* Read by the shared reactor thread instead */
+    void                *pReactorNext;  /* Next registered port (under the reactor's cs) */
+
+    /* Receive ring: ExecThread is the only producer, the com_recv() caller */
+    /* the only consumer, so the data path itself takes no lock.            */
+    UART_RING           ring;
+    unsigned char       *pRcvBuf;       /* SIZE_RCVBUF bytes */
+    int                 bLocked;        /* pRcvBuf is mlock()ed */
+
+    char                acPtyName[64];  /* pty: slave path for the device side */
+} TTY_DEVICE;
+
+static void *ExecThread(void *pParam);
+static void *ReactorThread(void *pParam);
+
+/* Shared receive thread of the COM_RX_REACTOR mode: one epoll set holds   */
+/* every port, each ready descriptor is read into its own port's ring.     */
+/* It runs while at least one port is registered.                          */
+typedef struct {
+    pthread_mutex_t     lock;           /* Start/stop and port registration */
+    pthread_mutex_t     cs;             /* Held by the thread while it dispatches */
+    pthread_cond_t      condRound;      /* Signalled after each dispatch round */
+    unsigned int        nRound;         /* Completed dispatch rounds (under cs) */
+    int                 bRun;           /* Thread keeps going (under cs) */
+    int                 bAlive;         /* Thread is still dispatching (under cs) */
+    void                *pPorts;        /* Registered ports, TTY_DEVICE list (under cs) */
+    int                 fdEpoll;
+    int                 fdWake[2];      /* Wakes the thread out of epoll_wait() */
+    int                 nPorts;         /* Registered ports (under lock) */
+    pthread_t           hThread;
+} TTY_REACTOR;
+
+static TTY_REACTOR m_reactor = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    0, 0, 0, NULL, -1, { -1, -1 }, 0, 0
+};
+static int m_nRxMode = COM_RX_THREAD;  /* Mode for ports opened from now on */
 
 void InitializeCriticalSection(CRITICAL_SECTION *section)
 {
@@ -64,58 +114,155 @@ void LeaveCriticalSection(CRITICAL_SECTION *section)
     pthread_mutex_unlock(section);
 }
 
+/* Condition variable timed against CLOCK_MONOTONIC */
+static void InitializeCondition(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
 void com_sleep(int nSleep)
 {
     usleep(nSleep*1000);
 }
 
+static void reactor_remove(TTY_DEVICE *hCom);
+
 /* UART */
-void com_close(void)
+static void tty_close(HCOM hDev)
 {
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+    char cWake = 0;
+
+    if ( hCom->bReactor ) {
+        reactor_remove(hCom);
+    }
     // MvZXI
-    if (m_hThread != NULL)
-    {
-        (void)pthread_cancel(m_hThread);
+    if ( hCom->bThread ) {
+        hCom->bThread = 0;
+        /* Wake the receive thread out of poll() and wait for it to exit */
+        if ( write(hCom->fdWake[1], &cWake, 1) < 0 ) {
+            (void)pthread_cancel(hCom->hThread);
+        }
+        (void)pthread_join(hCom->hThread, NULL);
+    }
+    if ( hCom->fdWake[0] != -1 ) {
+        close(hCom->fdWake[0]);
+        close(hCom->fdWake[1]);
+    }
+    if ( hCom->fd != -1 ) {
+        tcsetattr(hCom->fd, TCSANOW, &hCom->save_options);    // ̐ݒ𕜋A
+        close(hCom->fd);
     }
-    if ( hCom != -1 ) {
-		m_bThread = 0;
+    if ( hCom->bSync ) {
+        pthread_cond_destroy(&hCom->condRecv);
+        pthread_mutex_destroy(&hCom->cs);
+    }
+    if ( hCom->bLocked ) {
+        munlock(hCom->pRcvBuf, SIZE_RCVBUF);
+    }
+    free(hCom->pRcvBuf);
+    free(hCom);
+}
 
-        tcsetattr(hCom, TCSANOW, &save_options);    // ̐ݒ𕜋A
-        close(hCom);
-        hCom = -1;
+static TTY_DEVICE *tty_alloc(const COM_OPS *pOps)
+{
+    TTY_DEVICE *hCom;
+
+    hCom = (TTY_DEVICE *)calloc(1, sizeof(TTY_DEVICE));
+    if ( hCom == NULL ) {
+        return NULL;
     }
+    hCom->base.pOps = pOps;
+    hCom->fd = -1;
+    hCom->fdWake[0] = hCom->fdWake[1] = -1;
+    return hCom;
 }
 
-int com_init(S_STAT *stat)
+static int reactor_add(TTY_DEVICE *hCom);
+
+/* Buffers and receive thread for an opened descriptor */
+static HCOM tty_start(TTY_DEVICE *hCom)
 {
     int rtn;
+
+    /* The ring is only touched as data arrives, so an idle port costs */
+    /* little resident memory despite its size (unless it is locked).   */
+    hCom->pRcvBuf = (unsigned char *)malloc(SIZE_RCVBUF);
+    if ( hCom->pRcvBuf == NULL ) {
+        tty_close(&hCom->base);
+        return NULL;
+    }
+    ring_init(&hCom->ring, hCom->pRcvBuf, SIZE_RCVBUF);
+    hCom->base.stats.nBufferSize = SIZE_RCVBUF;
+
+    //NeBJZNV쐬
+    InitializeCriticalSection(&hCom->cs);
+    InitializeCondition(&hCom->condRecv);
+    hCom->bSync = 1;
+
+    if ( __atomic_load_n(&m_nRxMode, __ATOMIC_RELAXED) == COM_RX_REACTOR ) {
+        if ( reactor_add(hCom) != 0 ) {
+            tty_close(&hCom->base);
+            return NULL;
+        }
+        return &hCom->base;
+    }
+
+    if ( pipe(hCom->fdWake) != 0 ) {
+        hCom->fdWake[0] = hCom->fdWake[1] = -1;
+        tty_close(&hCom->base);
+        return NULL;
+    }
+	hCom->bThread = 1;
+	hCom->bRxAlive = 1;
+
+    /* The thread inherits the caller's scheduling; a priority set on the */
+    /* attribute alone would be ignored. com_set_rx_config() changes it.  */
+    rtn = pthread_create(&hCom->hThread, NULL, ExecThread, hCom);
+    if ( rtn != 0 ) {
+        hCom->bThread = 0;
+        hCom->bRxAlive = 0;
+        tty_close(&hCom->base);
+        return NULL;
+    }
+    return &hCom->base;
+}
+
+static HCOM tty_open(const char *device, unsigned long BaudRate)
+{
     int nBaud;
-    char device[16];
     struct termios tio;
+    TTY_DEVICE *hCom;
 
-    pthread_attr_t tattr;
-    struct sched_param spp;
-
-    com_close();
+    hCom = tty_alloc(&com_tty_ops);
+    if ( hCom == NULL ) {
+        return NULL;
+    }
 
-    sprintf(device, "/dev/ttyACM%d", stat->com_num);
-    hCom = open(device,O_RDWR | O_NOCTTY);          // foCXt@CiVA|[gjI[v
-    if ( hCom == -1 ) {
-        fprintf(stderr, "Can't open (%s) hCom = %d\n", device, hCom);
-        return 0;
+    hCom->fd = open(device,O_RDWR | O_NOCTTY);          // foCXt@CiVA|[gjI[v
+    if ( hCom->fd == -1 ) {
+        fprintf(stderr, "Can't open (%s) hCom = %d\n", device, hCom->fd);
+        tty_close(&hCom->base);
+        return NULL;
     }
 
-    tcgetattr(hCom, &save_options);
+    tcgetattr(hCom->fd, &hCom->save_options);
 
+    /* Raw 8N1. The receive thread sleeps in poll() until bytes arrive, */
+    /* after which read() returns whatever is buffered (VMIN=1).        */
     memset(&tio,0,sizeof(tio));
     tio.c_cflag = CS8 | CLOCAL | CREAD;
     tio.c_lflag &= ~(/*ICANON |*/ ECHO | ECHOE | ISIG);
-    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VMIN] = 1;
     tio.c_cc[VTIME] = 0;
 
     // {[[g̐ݒ
-    //fprintf(stderr, "Set Baudrate = %ld\n", stat->BaudRate);
-    switch(stat->BaudRate) {
+    //fprintf(stderr, "Set Baudrate = %ld\n", BaudRate);
+    switch(BaudRate) {
     case 9600:
         nBaud = B9600;
         break;
@@ -142,36 +289,120 @@ int com_init(S_STAT *stat)
     cfsetospeed(&tio,nBaud);
 
     // foCXɐݒs
-    tcsetattr(hCom,TCSANOW,&tio);
+    tcsetattr(hCom->fd,TCSANOW,&tio);
 
-    //NeBJZNV쐬
-    InitializeCriticalSection(&cs);
-	m_bThread = 1;
-
-    /* ftHgŏ */
-    rtn = pthread_attr_init(&tattr);
-    /* ̃XPW[Op^擾 */
-    rtn = pthread_attr_getschedparam(&tattr, &spp);
-    /* D揇ʂݒ肷BȊO͕ύXȂ */
-    spp.sched_priority = 50;
-    /* VXPW[Op^ݒ肷 */
-    rtn = pthread_attr_setschedparam(&tattr, &spp);
-    /* w肵VD揇ʂgp */
-    rtn = pthread_create(&m_hThread, &tattr, ExecThread, NULL);
-    return 1;
+    return tty_start(hCom);
 }
 
-void com_clear();
-int com_send(unsigned char *buf, int len)
+/*----------------------------------------------------------------------------*/
+/* Open the master side of a new pseudo-terminal                              */
+/* The device side (a simulator or test tool) opens com_pty_name().          */
+/*----------------------------------------------------------------------------*/
+static HCOM pty_open(const char *target, unsigned long BaudRate)
 {
+    struct termios tio;
+    TTY_DEVICE *hCom;
+
+    (void)target;
+    (void)BaudRate;
+
+    hCom = tty_alloc(&com_pty_ops);
+    if ( hCom == NULL ) {
+        return NULL;
+    }
+
+    hCom->fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ( hCom->fd == -1 || grantpt(hCom->fd) != 0 || unlockpt(hCom->fd) != 0 ||
+         ptsname_r(hCom->fd, hCom->acPtyName, sizeof(hCom->acPtyName)) != 0 ) {
+        tty_close(&hCom->base);
+        return NULL;
+    }
+
+    tcgetattr(hCom->fd, &hCom->save_options);
+    tio = hCom->save_options;
+    cfmakeraw(&tio);
+    tcsetattr(hCom->fd, TCSANOW, &tio);
+
+    return tty_start(hCom);
+}
+
+HCOM com_init_device(const char *device, unsigned long BaudRate)
+{
+    return tty_open(device, BaudRate);
+}
+
+/* Slave path of a "pty" port, NULL for any other backend */
+const char *com_pty_name(HCOM hCom)
+{
+    if ( hCom == NULL || hCom->pOps != &com_pty_ops ) return NULL;
+    return ((TTY_DEVICE *)hCom)->acPtyName;
+}
+
+static void com_clear(TTY_DEVICE *hCom);
+
+/*----------------------------------------------------------------------------*/
+/* Write a block gathered from several regions with writev()                  */
+/* return   : int                   bytes written; short writes are resumed,  */
+/*                                  so less than the total means the line     */
+/*                                  failed                                    */
+/*----------------------------------------------------------------------------*/
+static int tty_sendv(HCOM hDev, const COM_SPAN *pVec, int nVec)
+{
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+    struct iovec iov[COM_SENDV_MAX];
+    int i;
+    int n = 0;
+    int nSent = 0;
+    unsigned int nStale;
+    ssize_t ret;
+
+    if ( hCom->fd == -1 ) return 0;
+
+    for ( i = 0; i < nVec; i++ ) {
+        if ( pVec[i].nSize <= 0 ) continue;
+        iov[n].iov_base = (void *)pVec[i].pData;
+        iov[n].iov_len = (size_t)pVec[i].nSize;
+        n++;
+    }
+    if ( n == 0 ) return 0;
+    if ( ((const unsigned char *)iov[0].iov_base)[0] == 0xFE && !(hDev->nSendFlags & COM_SEND_KEEP_RX) ) {
+        /* Leftovers of an earlier response would be read as the answer */
+        nStale = ring_length(&hCom->ring);
+        if ( nStale > 0 ) {
+            COM_STATS_ADD(hCom->base.stats.nResyncs, 1);
+            COM_STATS_ADD(hCom->base.stats.nResyncBytes, (unsigned long long)nStale);
+        }
+        com_clear(hCom);
+    }
+
+    i = 0;
+    while ( i < n ) {
+        ret = writev(hCom->fd, &iov[i], n - i);
+        if ( ret < 0 && errno == EINTR ) continue;
+        if ( ret <= 0 ) break;
+        nSent += (int)ret;
+        /* Skip what went out and carry on from the first unsent byte */
+        while ( i < n && (size_t)ret >= iov[i].iov_len ) {
+            ret -= (ssize_t)iov[i].iov_len;
+            i++;
+        }
+        if ( i < n ) {
+            iov[i].iov_base = (unsigned char *)iov[i].iov_base + ret;
+            iov[i].iov_len -= (size_t)ret;
+        }
+    }
+    return nSent;
+}
+
+static int tty_send(HCOM hDev, unsigned char *buf, int len)
+{
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
     int i;
     int nSize = 0;
     char strBuf[256];
+    COM_SPAN vec;
 
-    if ( hCom != -1 ) {
-        if ( buf[0] == 0xFE ) {
-            com_clear();
-        }
+    if ( hCom->fd != -1 ) {
 #if 0
         strBuf[0] = 0;
         sprintf(&strBuf[strlen(strBuf)], "com_send =");
@@ -183,158 +414,482 @@ int com_send(unsigned char *buf, int len)
         sprintf(&strBuf[strlen(strBuf)], "\n");
         fprintf(stderr, "%s", strBuf);
 #endif
-        nSize = write(hCom, buf, len);
+        vec.pData = buf;
+        vec.nSize = len;
+        nSize = tty_sendv(hDev, &vec, 1);
     }
     return nSize;
 }
 
-int _com_recv(int inTimeOutTimer, unsigned char *buf, int len)
+/*----------------------------------------------------------------------------*/
+/* Wait for received bytes and read what is available                         */
+/* param    : TTY_DEVICE *hCom      port                                      */
+/*          : int   inTimeOutTimer  timeout time (ms), -1 waits forever       */
+/*          : unsigned char *buf    receive buffer                            */
+/*          : int   len             receive buffer size                       */
+/* return   : int                   received bytes, 0 on timeout,             */
+/*                                  -1 on close request or line hang-up       */
+/*----------------------------------------------------------------------------*/
+static int _com_recv(TTY_DEVICE *hCom, int inTimeOutTimer, unsigned char *buf, int len)
 {
-    int i;
     int nSize = 0;
-    int nTotalSize = 0;
-    char strBuf[256];
+    struct pollfd fds[2];
 
-    time_t start,end;
+    if ( hCom->fd == -1 ) return -1;
 
-    if ( hCom != -1 ) {
-        //Start timer
-        time(&start);
-        while ( nTotalSize < len ) {
-            nSize = read(hCom, &buf[nTotalSize], len-nTotalSize);
-            nTotalSize += nSize;
+    fds[0].fd = hCom->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = hCom->fdWake[0];
+    fds[1].events = POLLIN;
 
-            //Time Out Check
-            time(&end);
-            if( (end - start)*1000 > inTimeOutTimer){
-                break;
-            }
-        }
-#if 0
-        strBuf[0] = 0;
-        sprintf(&strBuf[strlen(strBuf)], "com_recv =");
-        for (i = 0; i < 16 && i < nTotalSize; i++)
-        {
-            unsigned char ch = buf[i];
-            sprintf(&strBuf[strlen(strBuf)], " %02X", ch);
-        }
-        sprintf(&strBuf[strlen(strBuf)], "\n");
-        fprintf(stderr, "%s", strBuf);
-#endif
+    do {
+        fds[0].revents = fds[1].revents = 0;
+        nSize = poll(fds, 2, inTimeOutTimer);
+    } while ( nSize < 0 && errno == EINTR );
+
+    if ( nSize < 0 || fds[1].revents != 0 ) return -1;
+    if ( nSize == 0 ) return 0;
+
+    if ( fds[0].revents & POLLIN ) {
+        do {
+            nSize = read(hCom->fd, buf, len);
+        } while ( nSize < 0 && errno == EINTR );
+        if ( nSize > 0 ) return nSize;
+        if ( nSize < 0 && errno == EAGAIN ) return 0;
     }
-    return nTotalSize;
+    /* POLLHUP/POLLERR without data, or EOF: the line is gone */
+    return -1;
+}
+
+/* Hand bytes read from the line to the port's ring and its readers */
+static void tty_deliver(TTY_DEVICE *hCom, const unsigned char *rxbuf, int rlen)
+{
+	unsigned int nStored;
+	COM_STATS *pStats = &hCom->base.stats;
+
+	/* Bytes that do not fit are dropped; the ring is sized well */
+	/* above the largest response (album data, ~816 KB).         */
+	nStored = ring_write(&hCom->ring, rxbuf, (unsigned int)rlen);
+	COM_STATS_ADD(pStats->nBytesIn, (unsigned long long)rlen);
+	COM_STATS_ADD(pStats->nReads, 1);
+	if ( nStored < (unsigned int)rlen ) {
+		COM_STATS_ADD(pStats->nOverrunBytes, (unsigned long long)(rlen - nStored));
+	}
+	nStored = ring_length(&hCom->ring);
+	COM_STATS_MAX(pStats->nMaxBuffered, nStored);
+	if ( __atomic_load_n(&hCom->base.pCapture, __ATOMIC_ACQUIRE) != NULL ) {
+		com_capture_write(&hCom->base, COM_CAPTURE_RX, rxbuf, rlen);
+	}
+
+	/* Wake com_recv() only when somebody is actually waiting.  */
+	/* The fence orders the head store above against the read  */
+	/* of nWaiters (the reader does the mirror image).         */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if ( __atomic_load_n(&hCom->nWaiters, __ATOMIC_RELAXED) > 0 ) {
+		EnterCriticalSection(&hCom->cs);
+		pthread_cond_broadcast(&hCom->condRecv);
+		LeaveCriticalSection(&hCom->cs);
+		COM_STATS_ADD(pStats->nWakeups, 1);
+	}
+}
+
+/* Nothing more will arrive; release any waiting readers now */
+static void tty_rx_end(TTY_DEVICE *hCom)
+{
+	EnterCriticalSection(&hCom->cs);
+	__atomic_store_n(&hCom->bRxAlive, 0, __ATOMIC_SEQ_CST);
+	pthread_cond_broadcast(&hCom->condRecv);
+	LeaveCriticalSection(&hCom->cs);
 }
 
 /********************************************************************/
 /* Xbhs                                                     */
 /********************************************************************/
-void ExecThread(void *pParam)
+static void *ExecThread(void *pParam)
 {
-	int i;
+	TTY_DEVICE *hCom = (TTY_DEVICE *)pParam;
 	int rlen;
-	unsigned char rxbuf[1024];
-
-	m_ptrRead = 0;
-	m_ptrReceive = 0;
-	m_nReceiveCount = 0;
+	unsigned char rxbuf[SIZE_RXCHUNK];
 
 	// Ms
-	while ( hCom != -1 ) {
-		rlen = _com_recv(0, rxbuf, sizeof(rxbuf));
+	while ( hCom->bThread ) {
+		/* Sleeps in poll() until bytes arrive or com_close() wakes us */
+		rlen = _com_recv(hCom, -1, rxbuf, sizeof(rxbuf));
+		if ( rlen < 0 ) {
+			break;
+		}
 
 		if ( rlen > 0 ) {
-		    EnterCriticalSection(&cs);
 			// Mf[^
-			for ( i = 0 ; i < (int)rlen ; i++ ) {
-				m_acRcvBuf[m_ptrReceive++] = rxbuf[i];
-				if ( m_ptrReceive >= SIZE_RCVBUF ) {
-					m_ptrReceive = 0;
-				}
-				m_nReceiveCount++;
-				if ( m_nReceiveCount > SIZE_RCVBUF ) {
-					m_nReceiveCount--;
-
-					m_ptrRead++;
-					if ( m_ptrRead >= SIZE_RCVBUF ) {
-						m_ptrRead = 0;
-					}
-				}
+			tty_deliver(hCom, rxbuf, rlen);
+		}
+	}
+
+	tty_rx_end(hCom);
+	return NULL;
+}
+
+/********************************************************************/
+/* Reactor: one thread for all ports (COM_RX_REACTOR)               */
+/********************************************************************/
+static void *ReactorThread(void *pParam)
+{
+	TTY_REACTOR *pReactor = (TTY_REACTOR *)pParam;
+	struct epoll_event events[REACTOR_EVENTS];
+	unsigned char rxbuf[SIZE_RXCHUNK];
+	TTY_DEVICE *hCom;
+	int n, i;
+	int rlen;
+
+	for ( ;; ) {
+		n = epoll_wait(pReactor->fdEpoll, events, REACTOR_EVENTS, -1);
+		if ( n < 0 && errno != EINTR ) {
+			/* Nothing will be read any more: end every port's receive */
+			/* and release anyone waiting for a round                  */
+			EnterCriticalSection(&pReactor->cs);
+			pReactor->bAlive = 0;
+			for ( hCom = (TTY_DEVICE *)pReactor->pPorts; hCom != NULL; hCom = (TTY_DEVICE *)hCom->pReactorNext ) {
+				tty_rx_end(hCom);
+			}
+			pthread_cond_broadcast(&pReactor->condRound);
+			LeaveCriticalSection(&pReactor->cs);
+			break;
+		}
+
+		/* A port leaving the set waits for the end of this round, so */
+		/* every pointer in events[] stays valid until then           */
+		EnterCriticalSection(&pReactor->cs);
+		if ( !pReactor->bRun ) {
+			LeaveCriticalSection(&pReactor->cs);
+			break;
+		}
+		for ( i = 0; i < n; i++ ) {
+			hCom = (TTY_DEVICE *)events[i].data.ptr;
+			if ( hCom == NULL ) {
+				/* Wake-up only; drain the pipe */
+				if ( read(pReactor->fdWake[0], rxbuf, sizeof(rxbuf)) < 0 ) { /* Nothing to do */ }
+				continue;
+			}
+			/* Level-triggered: one read per round keeps a busy port */
+			/* from starving the others                              */
+			rlen = -1;
+			if ( events[i].events & EPOLLIN ) {
+				do {
+					rlen = read(hCom->fd, rxbuf, sizeof(rxbuf));
+				} while ( rlen < 0 && errno == EINTR );
+				if ( rlen < 0 && errno == EAGAIN ) rlen = 0;
+			}
+			if ( rlen > 0 ) {
+				tty_deliver(hCom, rxbuf, rlen);
+			}
+			else if ( rlen < 0 || (events[i].events & (EPOLLHUP | EPOLLERR)) ) {
+				/* The line is gone: stop watching it */
+				epoll_ctl(pReactor->fdEpoll, EPOLL_CTL_DEL, hCom->fd, NULL);
+				tty_rx_end(hCom);
 			}
-		    LeaveCriticalSection(&cs);
-		} else {
-			//usleep(1000);
 		}
+		pReactor->nRound++;
+		pthread_cond_broadcast(&pReactor->condRound);
+		LeaveCriticalSection(&pReactor->cs);
+	}
+	return NULL;
+}
+
+/* Stop the reactor thread and release its descriptors (lock held) */
+static void reactor_stop(TTY_REACTOR *pReactor)
+{
+	char cWake = 0;
+
+	if ( pReactor->bRun ) {
+		EnterCriticalSection(&pReactor->cs);
+		pReactor->bRun = 0;
+		LeaveCriticalSection(&pReactor->cs);
+		if ( write(pReactor->fdWake[1], &cWake, 1) < 0 ) {
+			(void)pthread_cancel(pReactor->hThread);
+		}
+		(void)pthread_join(pReactor->hThread, NULL);
+		pReactor->bAlive = 0;
+	}
+	if ( pReactor->fdWake[0] != -1 ) {
+		close(pReactor->fdWake[0]);
+		close(pReactor->fdWake[1]);
+		pReactor->fdWake[0] = pReactor->fdWake[1] = -1;
+	}
+	if ( pReactor->fdEpoll != -1 ) {
+		close(pReactor->fdEpoll);
+		pReactor->fdEpoll = -1;
+	}
+}
+
+/* Register a port, starting the reactor thread with the first one */
+static int reactor_add(TTY_DEVICE *hCom)
+{
+	TTY_REACTOR *pReactor = &m_reactor;
+	struct epoll_event ev;
+
+	pthread_mutex_lock(&pReactor->lock);
+	if ( pReactor->nPorts == 0 ) {
+		pReactor->fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+		if ( pReactor->fdEpoll == -1 || pipe(pReactor->fdWake) != 0 ) {
+			reactor_stop(pReactor);
+			pthread_mutex_unlock(&pReactor->lock);
+			return -1;
+		}
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = NULL;
+		pReactor->bRun = 1;
+		pReactor->bAlive = 1;
+		if ( epoll_ctl(pReactor->fdEpoll, EPOLL_CTL_ADD, pReactor->fdWake[0], &ev) != 0 ||
+			 pthread_create(&pReactor->hThread, NULL, ReactorThread, pReactor) != 0 ) {
+			pReactor->bRun = 0;
+			reactor_stop(pReactor);
+			pthread_mutex_unlock(&pReactor->lock);
+			return -1;
+		}
+	}
+	else if ( !pReactor->bAlive ) {
+		/* The thread ended on an epoll error; it is restarted once */
+		/* every port using it has been closed                      */
+		pthread_mutex_unlock(&pReactor->lock);
+		return -1;
+	}
+
+	hCom->bRxAlive = 1;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.ptr = hCom;
+	if ( epoll_ctl(pReactor->fdEpoll, EPOLL_CTL_ADD, hCom->fd, &ev) != 0 ) {
+		hCom->bRxAlive = 0;
+		if ( pReactor->nPorts == 0 ) {
+			reactor_stop(pReactor);
+		}
+		pthread_mutex_unlock(&pReactor->lock);
+		return -1;
+	}
+	hCom->bReactor = 1;
+	pReactor->nPorts++;
+	EnterCriticalSection(&pReactor->cs);
+	hCom->pReactorNext = pReactor->pPorts;
+	pReactor->pPorts = hCom;
+	LeaveCriticalSection(&pReactor->cs);
+	pthread_mutex_unlock(&pReactor->lock);
+	return 0;
+}
 
-		if ( !m_bThread ) {
+/* Unregister a port; the thread stops with the last one */
+static void reactor_remove(TTY_DEVICE *hCom)
+{
+	TTY_REACTOR *pReactor = &m_reactor;
+	unsigned int nRound;
+	char cWake = 0;
+	void **ppLink;
+
+	pthread_mutex_lock(&pReactor->lock);
+	EnterCriticalSection(&pReactor->cs);
+	for ( ppLink = &pReactor->pPorts; *ppLink != NULL; ppLink = &((TTY_DEVICE *)*ppLink)->pReactorNext ) {
+		if ( *ppLink == hCom ) {
+			*ppLink = hCom->pReactorNext;
 			break;
 		}
 	}
+	LeaveCriticalSection(&pReactor->cs);
+	if ( --pReactor->nPorts == 0 ) {
+		/* The thread goes away, and with it any reference to the port */
+		reactor_stop(pReactor);
+	}
+	else {
+		EnterCriticalSection(&pReactor->cs);
+		epoll_ctl(pReactor->fdEpoll, EPOLL_CTL_DEL, hCom->fd, NULL);
+		/* Let the thread finish a round that may still refer to this port; */
+		/* a thread ended by an epoll error has no round left to finish     */
+		nRound = pReactor->nRound;
+		if ( pReactor->bAlive && write(pReactor->fdWake[1], &cWake, 1) == 1 ) {
+			while ( pReactor->nRound == nRound && pReactor->bAlive ) {
+				pthread_cond_wait(&pReactor->condRound, &pReactor->cs);
+			}
+		}
+		LeaveCriticalSection(&pReactor->cs);
+	}
+	hCom->bReactor = 0;
+	pthread_mutex_unlock(&pReactor->lock);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Choose how tty/pty ports opened from now on are read                       */
+/* param    : int   nMode       COM_RX_THREAD or COM_RX_REACTOR               */
+/* return   : int               0...normal, -1...unknown mode                 */
+/* Ports already open keep the mode they were opened with.                    */
+/*----------------------------------------------------------------------------*/
+int com_set_rx_mode(int nMode)
+{
+	if ( nMode != COM_RX_THREAD && nMode != COM_RX_REACTOR ) return -1;
+	__atomic_store_n(&m_nRxMode, nMode, __ATOMIC_RELAXED);
+	return 0;
 }
 
 /********************************************************************/
 /* MAPI֐                                                      */
 /********************************************************************/
 // MZbg
-void com_clear()
+static void com_clear(TTY_DEVICE *hCom)
 {
-    EnterCriticalSection(&cs);
+	ring_clear(&hCom->ring);
+}
 
-    m_ptrRead = 0;
-	m_ptrReceive = 0;
-	m_nReceiveCount = 0;
+// MmF
+static int tty_length(HCOM hDev)
+{
+	TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
 
-	LeaveCriticalSection(&cs);
+	return (int)ring_length(&hCom->ring);
 }
 
-// MmF
-int com_length()
+/* Sleep until the receive thread has buffered len bytes or the timeout */
+/* passes (a negative timeout waits with no deadline); the caller then  */
+/* takes whatever is there                                              */
+static void tty_wait(TTY_DEVICE *hCom, int inTimeOutTimer, int len)
 {
-	int nCount = 0;
+	int rtn;
+	struct timespec deadline;
 
-	EnterCriticalSection(&cs);
+	/* Fast path: everything is already buffered */
+	if ( (int)ring_length(&hCom->ring) >= len ) {
+		return;
+	}
 
-	nCount = m_nReceiveCount;
+	//Deadline for the timeout check
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += inTimeOutTimer / 1000;
+	deadline.tv_nsec += (long)(inTimeOutTimer % 1000) * 1000000L;
+	if ( deadline.tv_nsec >= 1000000000L ) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
 
-	LeaveCriticalSection(&cs);
-	return nCount;
+	EnterCriticalSection(&hCom->cs);
+	__atomic_add_fetch(&hCom->nWaiters, 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while ( (int)ring_length(&hCom->ring) < len && __atomic_load_n(&hCom->bRxAlive, __ATOMIC_SEQ_CST) ) {
+		if ( inTimeOutTimer < 0 ) {
+			pthread_cond_wait(&hCom->condRecv, &hCom->cs);
+			continue;
+		}
+		rtn = pthread_cond_timedwait(&hCom->condRecv, &hCom->cs, &deadline);
+		if ( rtn == ETIMEDOUT ) break;
+	}
+	__atomic_sub_fetch(&hCom->nWaiters, 1, __ATOMIC_RELAXED);
+	LeaveCriticalSection(&hCom->cs);
 }
 
 // f[^M
-int com_recv(int inTimeOutTimer, unsigned char *buf, int len)
+static int tty_recv(HCOM hDev, int inTimeOutTimer, unsigned char *buf, int len)
+{
+	TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+
+	tty_wait(hCom, inTimeOutTimer, len);
+	return (int)ring_read(&hCom->ring, buf, (unsigned int)len);
+}
+
+/* Received bytes straight out of the ring */
+static int tty_peek(HCOM hDev, int inTimeOutTimer, int len, COM_SPAN *outSpan)
 {
-	int nSize = 0;
+	TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+	UART_SPAN span[2];
+	unsigned int nSize;
+
+	tty_wait(hCom, inTimeOutTimer, len);
+	nSize = ring_peek(&hCom->ring, span);
+	outSpan[0].pData = span[0].pData;
+	outSpan[0].nSize = (int)span[0].nSize;
+	outSpan[1].pData = span[1].pData;
+	outSpan[1].nSize = (int)span[1].nSize;
+	return (int)nSize;
+}
 
-    time_t start,end;
+static void tty_consume(HCOM hDev, int len)
+{
+	TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
 
-    //Start timer
-    time(&start);
-    do{
-        usleep(10000);
-        if ( com_length() >= len ) break;
+	ring_consume(&hCom->ring, (unsigned int)len);
+}
 
-        //Time Out Check
-        time(&end);
-        if( (end - start)*1000 > inTimeOutTimer){
-            break;
-        }
-    }while(1);
+/*----------------------------------------------------------------------------*/
+/* Scheduling, CPU affinity and memory locking of the receive thread          */
+/* (for a COM_RX_REACTOR port: of the thread shared by all of them)           */
+/* A real-time reader keeps draining the kernel tty buffer while the rest of  */
+/* the process (or the box) is busy; locking the ring keeps page faults off   */
+/* the receive path.                                                          */
+/*----------------------------------------------------------------------------*/
+static int tty_rxconfig(HCOM hDev, const COM_RX_CONFIG *pConfig)
+{
+	TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+	struct sched_param param;
+	cpu_set_t cpus;
+	pthread_t hThread;
+	int policy;
+	int i;
+	int ret = 0;
 
-	EnterCriticalSection(&cs);
+	if ( hCom->bReactor ) {
+		/* The reactor thread reads every COM_RX_REACTOR port */
+		hThread = m_reactor.hThread;
+	}
+	else if ( hCom->bThread ) {
+		hThread = hCom->hThread;
+	}
+	else {
+		return COM_RX_CONFIG_UNSUPPORTED;
+	}
 
-	if ( len > m_nReceiveCount ) {
-		len = m_nReceiveCount;
+	switch ( pConfig->nPolicy ) {
+	case COM_SCHED_FIFO:
+		policy = SCHED_FIFO;
+		break;
+	case COM_SCHED_RR:
+		policy = SCHED_RR;
+		break;
+	default:
+		policy = SCHED_OTHER;
+		break;
+	}
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = (policy == SCHED_OTHER) ? 0 : pConfig->nPriority;
+	if ( pthread_setschedparam(hThread, policy, &param) != 0 ) {
+		ret = COM_RX_CONFIG_ERR_SCHED;
 	}
 
-	if ( m_ptrRead + len > SIZE_RCVBUF ) {
-		memcpy(&buf[nSize], &m_acRcvBuf[m_ptrRead], SIZE_RCVBUF - m_ptrRead);
-		nSize += (SIZE_RCVBUF - m_ptrRead);
-		m_ptrRead = 0;
+	CPU_ZERO(&cpus);
+	for ( i = 0; i < CPU_SETSIZE; i++ ) {
+		if ( pConfig->nCpuMask == 0 || (i < 64 && (pConfig->nCpuMask >> i) & 1) ) {
+			CPU_SET(i, &cpus);
+		}
+	}
+	if ( pthread_setaffinity_np(hThread, sizeof(cpus), &cpus) != 0 && ret == 0 ) {
+		ret = COM_RX_CONFIG_ERR_AFFINITY;
 	}
-	memcpy(&buf[nSize], &m_acRcvBuf[m_ptrRead], len - nSize);
-	m_ptrRead += (len - nSize);
-	nSize += (len - nSize);
-	m_nReceiveCount -= nSize;
 
-	LeaveCriticalSection(&cs);
-	return nSize;
+	if ( pConfig->bLockMemory && !hCom->bLocked ) {
+		if ( mlock(hCom->pRcvBuf, SIZE_RCVBUF) == 0 ) {
+			hCom->bLocked = 1;
+		}
+		else if ( ret == 0 ) {
+			ret = COM_RX_CONFIG_ERR_MLOCK;
+		}
+	}
+	else if ( !pConfig->bLockMemory && hCom->bLocked ) {
+		munlock(hCom->pRcvBuf, SIZE_RCVBUF);
+		hCom->bLocked = 0;
+	}
+	return ret;
 }
+
+const COM_OPS com_tty_ops = {
+    "tty", tty_open, tty_close, tty_send, tty_recv, tty_length, tty_peek, tty_consume,
+    tty_sendv, tty_rxconfig
+};
+
+const COM_OPS com_pty_ops = {
+    "pty", pty_open, tty_close, tty_send, tty_recv, tty_length, tty_peek, tty_consume,
+    tty_sendv, tty_rxconfig
+};
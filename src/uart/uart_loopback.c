@@ -0,0 +1,217 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    In-memory loopback transport
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "uart.h"
+
+#define LOOPBACK_BUF_INIT   (64 * 1024)
+
+/* Bytes queued for the host are kept in one linear buffer; the read */
+/* offset is folded back to the start whenever the buffer runs dry.  */
+/* Everything runs on the caller's thread: the device function       */
+/* answers from inside com_send(), so com_recv() never has to wait.  */
+typedef struct {
+    struct COM_DEVICE   base;           /* Must be first */
+    unsigned char       *pBuf;          /* Bytes for the host */
+    int                 nSize;          /* Allocated size of pBuf */
+    int                 nRead;          /* Next byte handed to com_recv() */
+    int                 nWrite;         /* End of queued bytes */
+    COM_LOOPBACK_FUNC   func;           /* Device side, NULL...echo */
+    void                *pParam;
+} LOOPBACK_DEVICE;
+
+static HCOM loopback_open(const char *target, unsigned long BaudRate)
+{
+    LOOPBACK_DEVICE *hCom;
+
+    (void)target;
+    (void)BaudRate;
+
+    hCom = (LOOPBACK_DEVICE *)calloc(1, sizeof(LOOPBACK_DEVICE));
+    if ( hCom == NULL ) {
+        return NULL;
+    }
+    hCom->base.pOps = &com_loopback_ops;
+    return &hCom->base;
+}
+
+static void loopback_close(HCOM hDev)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    free(hCom->pBuf);
+    free(hCom);
+}
+
+/* Regions go to the device side one by one, like pieces of a */
+/* block arriving over the line                               */
+static int loopback_sendv(HCOM hDev, const COM_SPAN *pVec, int nVec)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+    int i;
+    int nSent = 0;
+
+    for ( i = 0; i < nVec; i++ ) {
+        if ( pVec[i].nSize <= 0 ) continue;
+        /* A new command discards unread bytes, as on the serial port */
+        if ( nSent == 0 && pVec[i].pData[0] == 0xFE && !(hDev->nSendFlags & COM_SEND_KEEP_RX) ) {
+            if ( hCom->nWrite > hCom->nRead ) {
+                hDev->stats.nResyncs++;
+                hDev->stats.nResyncBytes += (unsigned long long)(hCom->nWrite - hCom->nRead);
+            }
+            hCom->nRead = hCom->nWrite = 0;
+        }
+        if ( hCom->func != NULL ) {
+            hCom->func(hCom->pParam, hDev, pVec[i].pData, pVec[i].nSize);
+        }
+        else {
+            com_loopback_inject(hDev, pVec[i].pData, pVec[i].nSize);
+        }
+        nSent += pVec[i].nSize;
+    }
+    return nSent;
+}
+
+static int loopback_send(HCOM hDev, unsigned char *buf, int len)
+{
+    COM_SPAN vec;
+
+    vec.pData = buf;
+    vec.nSize = len;
+    return loopback_sendv(hDev, &vec, 1);
+}
+
+static int loopback_peek(HCOM hDev, int inTimeOutTimer, int len, COM_SPAN *outSpan)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    (void)inTimeOutTimer;
+    (void)len;
+
+    /* The queue is linear: one region holds everything */
+    outSpan[0].pData = &hCom->pBuf[hCom->nRead];
+    outSpan[0].nSize = hCom->nWrite - hCom->nRead;
+    outSpan[1].pData = hCom->pBuf;
+    outSpan[1].nSize = 0;
+    return outSpan[0].nSize;
+}
+
+static void loopback_consume(HCOM hDev, int len)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    if ( len > hCom->nWrite - hCom->nRead ) {
+        len = hCom->nWrite - hCom->nRead;
+    }
+    hCom->nRead += len;
+    if ( hCom->nRead == hCom->nWrite ) {
+        hCom->nRead = hCom->nWrite = 0;
+    }
+}
+
+static int loopback_recv(HCOM hDev, int inTimeOutTimer, unsigned char *buf, int len)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    (void)inTimeOutTimer;
+
+    if ( len > hCom->nWrite - hCom->nRead ) {
+        len = hCom->nWrite - hCom->nRead;
+    }
+    memcpy(buf, &hCom->pBuf[hCom->nRead], len);
+    loopback_consume(hDev, len);
+    return len;
+}
+
+static int loopback_length(HCOM hDev)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    return hCom->nWrite - hCom->nRead;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Install the device side of a loopback port                                 */
+/* param    : HCOM              hCom    loopback port                         */
+/*          : COM_LOOPBACK_FUNC func    called with every sent block,         */
+/*                                      NULL echoes sent bytes back           */
+/*          : void              *pParam passed to func                        */
+/*----------------------------------------------------------------------------*/
+void com_loopback_attach(HCOM hDev, COM_LOOPBACK_FUNC func, void *pParam)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+
+    if ( hDev == NULL || hDev->pOps != &com_loopback_ops ) return;
+    hCom->func = func;
+    hCom->pParam = pParam;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Queue bytes for the host side of a loopback port                           */
+/* param    : HCOM          hCom    loopback port                             */
+/*          : unsigned char *buf    bytes the device "sends"                  */
+/*          : int           len     number of bytes                           */
+/* return   : int                   queued bytes, -1...not a loopback port    */
+/*                                  or out of memory                          */
+/*----------------------------------------------------------------------------*/
+int com_loopback_inject(HCOM hDev, const unsigned char *buf, int len)
+{
+    LOOPBACK_DEVICE *hCom = (LOOPBACK_DEVICE *)hDev;
+    unsigned char *pNew;
+    int nSize;
+
+    if ( hDev == NULL || hDev->pOps != &com_loopback_ops ) return -1;
+    if ( len <= 0 ) return 0;
+
+    if ( hCom->nWrite + len > hCom->nSize ) {
+        /* Reclaim the consumed head first, grow only if still short */
+        if ( hCom->nRead > 0 ) {
+            memmove(hCom->pBuf, &hCom->pBuf[hCom->nRead], hCom->nWrite - hCom->nRead);
+            hCom->nWrite -= hCom->nRead;
+            hCom->nRead = 0;
+        }
+        if ( hCom->nWrite + len > hCom->nSize ) {
+            nSize = (hCom->nSize > 0) ? hCom->nSize : LOOPBACK_BUF_INIT;
+            while ( nSize < hCom->nWrite + len ) nSize *= 2;
+            pNew = (unsigned char *)realloc(hCom->pBuf, nSize);
+            if ( pNew == NULL ) return -1;
+            hCom->pBuf = pNew;
+            hCom->nSize = nSize;
+        }
+    }
+    memcpy(&hCom->pBuf[hCom->nWrite], buf, len);
+    hCom->nWrite += len;
+    hDev->stats.nBytesIn += (unsigned long long)len;
+    hDev->stats.nReads++;
+    if ( (unsigned int)(hCom->nWrite - hCom->nRead) > hDev->stats.nMaxBuffered ) {
+        hDev->stats.nMaxBuffered = (unsigned int)(hCom->nWrite - hCom->nRead);
+    }
+    if ( hDev->pCapture != NULL ) {
+        com_capture_write(hDev, COM_CAPTURE_RX, buf, len);
+    }
+    return len;
+}
+
+const COM_OPS com_loopback_ops = {
+    "loopback", loopback_open, loopback_close, loopback_send, loopback_recv, loopback_length,
+    loopback_peek, loopback_consume, loopback_sendv,
+    NULL                /* Runs on the caller's thread */
+};
@@ -0,0 +1,396 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    File replay transport
+*/
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart.h"
+
+#define REPLAY_PATH_MAX     1024
+#define REPLAY_MATCH_SIZE   8           /* Command bytes compared against TX records */
+
+/* A capture file (uart_capture.c) is replayed by its RX records. Each  */
+/* com_send() is matched with the next TX record that starts with the    */
+/* same bytes, and the stream jumps to the answer recorded after it, so  */
+/* a host issuing only some of the captured commands still gets the      */
+/* right responses. Any other file is the received byte stream itself.   */
+/*                                                                        */
+/* Options after the path, e.g. "replay:log.cap,paced,loop":              */
+/*   paced  hand out each RX chunk at its recorded time, measured from    */
+/*          the com_send() matched with the preceding TX record           */
+/*   loop   wrap around to the start when the capture is exhausted        */
+/* Without "paced" the stream goes out as fast as the caller reads.       */
+typedef struct {
+    int                 nEnd;           /* Stream offset after the chunk / at the send */
+    unsigned long long  nTimeUs;        /* Capture time since the first record */
+    int                 nChunk;         /* TX: number of RX chunks before it */
+    int                 nHead;          /* TX: valid bytes in acHead */
+    unsigned char       acHead[REPLAY_MATCH_SIZE];  /* TX: start of the command */
+} REPLAY_MARK;
+
+typedef struct {
+    struct COM_DEVICE   base;           /* Must be first */
+    unsigned char       *pData;         /* Received byte stream */
+    int                 nSize;          /* Stream size */
+    int                 nRead;          /* Next byte handed to com_recv() */
+    REPLAY_MARK         *pChunk;        /* RX chunks (capture files only) */
+    int                 nChunk;
+    int                 nNextChunk;     /* First chunk not released yet */
+    REPLAY_MARK         *pSend;         /* TX records (capture files only) */
+    int                 nSend;
+    int                 nNextSend;      /* TX record to match the next com_send() from */
+    int                 bPaced;
+    int                 bLoop;
+    unsigned long long  nBaseLogUs;     /* Capture time that corresponds to ... */
+    unsigned long long  nBaseNowUs;     /* ... this wall time (com_capture_time()) */
+} REPLAY_DEVICE;
+
+static void replay_close(HCOM hDev)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+
+    free(hCom->pData);
+    free(hCom->pChunk);
+    free(hCom->pSend);
+    free(hCom);
+}
+
+static void replay_sleep(unsigned long long nUs)
+{
+#ifdef WIN32
+    Sleep((DWORD)((nUs + 999) / 1000));
+#else
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(nUs / 1000000);
+    ts.tv_nsec = (long)(nUs % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/* Turn a capture file into the RX stream plus chunk and send marks, in place */
+/* return   : int                   0...normal, -1...broken file              */
+/*----------------------------------------------------------------------------*/
+static int replay_load_capture(REPLAY_DEVICE *hCom)
+{
+    unsigned char *p = &hCom->pData[COM_CAPTURE_MAGIC_SIZE];
+    int nLeft = hCom->nSize - COM_CAPTURE_MAGIC_SIZE;
+    int nStream = 0;
+    int nMax = 0;
+    int nHead, type, len;
+    unsigned long long delta, t = 0;
+    REPLAY_MARK *pMark;
+
+    /* Upper bound for both mark tables: one per record */
+    while ( (nHead = com_capture_parse(&p[nMax], nLeft - nMax, &type, &delta, &len)) > 0 ) {
+        nMax += nHead + len;
+        nStream++;
+    }
+    if ( nHead < 0 ) return -1;
+
+    hCom->pChunk = (REPLAY_MARK *)malloc(sizeof(REPLAY_MARK) * (nStream + 1));
+    hCom->pSend = (REPLAY_MARK *)malloc(sizeof(REPLAY_MARK) * (nStream + 1));
+    if ( hCom->pChunk == NULL || hCom->pSend == NULL ) return -1;
+
+    /* RX data moves towards the front; it never overtakes the parser */
+    nStream = 0;
+    while ( (nHead = com_capture_parse(p, nLeft, &type, &delta, &len)) > 0 ) {
+        t += delta;
+        if ( type == COM_CAPTURE_RX ) {
+            memmove(&hCom->pData[nStream], &p[nHead], len);
+            nStream += len;
+            pMark = &hCom->pChunk[hCom->nChunk++];
+        }
+        else {
+            pMark = &hCom->pSend[hCom->nSend++];
+            pMark->nChunk = hCom->nChunk;
+            pMark->nHead = (len < REPLAY_MATCH_SIZE) ? len : REPLAY_MATCH_SIZE;
+            memcpy(pMark->acHead, &p[nHead], pMark->nHead);
+        }
+        pMark->nEnd = nStream;
+        pMark->nTimeUs = t;
+        p += nHead + len;
+        nLeft -= nHead + len;
+    }
+    hCom->nSize = nStream;
+    return 0;
+}
+
+static HCOM replay_open(const char *target, unsigned long BaudRate)
+{
+    FILE *fp;
+    long nSize;
+    char path[REPLAY_PATH_MAX];
+    char *pOpt;
+    REPLAY_DEVICE *hCom;
+
+    (void)BaudRate;
+
+    hCom = (REPLAY_DEVICE *)calloc(1, sizeof(REPLAY_DEVICE));
+    if ( hCom == NULL ) {
+        return NULL;
+    }
+    hCom->base.pOps = &com_replay_ops;
+
+    /* Options are peeled off the end of the target */
+    strncpy(path, target, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    while ( (pOpt = strrchr(path, ',')) != NULL ) {
+        if ( strcmp(pOpt + 1, "paced") == 0 ) {
+            hCom->bPaced = 1;
+        }
+        else if ( strcmp(pOpt + 1, "loop") == 0 ) {
+            hCom->bLoop = 1;
+        }
+        else {
+            break;
+        }
+        *pOpt = '\0';
+    }
+
+    fp = fopen(path, "rb");
+    if ( fp == NULL ) {
+        fprintf(stderr, "Can't open (%s)\n", path);
+        replay_close(&hCom->base);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    nSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    hCom->pData = (unsigned char *)malloc(nSize > 0 ? nSize : 1);
+    if ( nSize < 0 || hCom->pData == NULL || (long)fread(hCom->pData, 1, nSize, fp) != nSize ) {
+        fclose(fp);
+        replay_close(&hCom->base);
+        return NULL;
+    }
+    fclose(fp);
+    hCom->nSize = (int)nSize;
+
+    if ( hCom->nSize >= COM_CAPTURE_MAGIC_SIZE &&
+         memcmp(hCom->pData, COM_CAPTURE_MAGIC, COM_CAPTURE_MAGIC_SIZE) == 0 ) {
+        if ( replay_load_capture(hCom) != 0 ) {
+            fprintf(stderr, "Broken capture (%s)\n", path);
+            replay_close(&hCom->base);
+            return NULL;
+        }
+    }
+    else {
+        /* A raw stream has no timing to follow */
+        hCom->bPaced = 0;
+    }
+    hCom->nBaseNowUs = com_capture_time();
+    return &hCom->base;
+}
+
+/* Back to the start of a raw stream ("loop") */
+static void replay_rewind(REPLAY_DEVICE *hCom)
+{
+    hCom->nRead = 0;
+}
+
+/* Index of the first TX record in [nFrom, nTo) that the command matches, -1 if none */
+static int replay_match(REPLAY_DEVICE *hCom, int nFrom, int nTo, const unsigned char *buf, int len)
+{
+    int i;
+    REPLAY_MARK *pMark;
+
+    for ( i = nFrom; i < nTo; i++ ) {
+        pMark = &hCom->pSend[i];
+        if ( memcmp(pMark->acHead, buf, (len < pMark->nHead) ? len : pMark->nHead) == 0 ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* End of the bytes released so far                                          */
+/* param    : REPLAY_DEVICE *hCom       replay port                           */
+/*          : unsigned long long *outNextUs  wall time the next chunk is due  */
+/*                                      (unchanged when none is left)         */
+/* return   : int                       stream offset                         */
+/*----------------------------------------------------------------------------*/
+static int replay_released(REPLAY_DEVICE *hCom, unsigned long long *outNextUs)
+{
+    unsigned long long now;
+    REPLAY_MARK *pMark;
+
+    if ( !hCom->bPaced ) return hCom->nSize;
+
+    now = com_capture_time();
+    while ( hCom->nNextChunk < hCom->nChunk ) {
+        pMark = &hCom->pChunk[hCom->nNextChunk];
+        if ( pMark->nTimeUs > hCom->nBaseLogUs &&
+             pMark->nTimeUs - hCom->nBaseLogUs > now - hCom->nBaseNowUs ) {
+            *outNextUs = hCom->nBaseNowUs + (pMark->nTimeUs - hCom->nBaseLogUs);
+            break;
+        }
+        hCom->nNextChunk++;
+    }
+    return (hCom->nNextChunk > 0) ? hCom->pChunk[hCom->nNextChunk - 1].nEnd : 0;
+}
+
+static int replay_send(HCOM hDev, unsigned char *buf, int len)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+    REPLAY_MARK *pMark;
+    int i;
+
+    if ( hCom->nSend == 0 ) {
+        if ( hCom->bLoop && hCom->nRead >= hCom->nSize ) {
+            replay_rewind(hCom);
+        }
+        return len;
+    }
+
+    i = replay_match(hCom, hCom->nNextSend, hCom->nSend, buf, len);
+    if ( i < 0 && hCom->bLoop ) {
+        i = replay_match(hCom, 0, hCom->nNextSend, buf, len);
+    }
+    if ( i < 0 ) {
+        /* Not in the capture: the stream just carries on */
+        return len;
+    }
+
+    /* Unread bytes are dropped, as a new command does on the serial port, */
+    /* unless answers to earlier commands are still due (COM_SEND_KEEP_RX); */
+    /* the device answers relative to the moment the command went out.     */
+    pMark = &hCom->pSend[i];
+    if ( !(hDev->nSendFlags & COM_SEND_KEEP_RX) ) {
+        hCom->nRead = pMark->nEnd;
+    }
+    hCom->nNextChunk = pMark->nChunk;
+    hCom->nNextSend = i + 1;
+    hCom->nBaseLogUs = pMark->nTimeUs;
+    hCom->nBaseNowUs = com_capture_time();
+    return len;
+}
+
+/* Matched by the first region, which starts with the command header */
+static int replay_sendv(HCOM hDev, const COM_SPAN *pVec, int nVec)
+{
+    int i;
+    int nSent = 0;
+
+    for ( i = 0; i < nVec; i++ ) {
+        if ( pVec[i].nSize <= 0 ) continue;
+        if ( nSent == 0 ) {
+            replay_send(hDev, (unsigned char *)pVec[i].pData, pVec[i].nSize);
+        }
+        nSent += pVec[i].nSize;
+    }
+    return nSent;
+}
+
+/* Wait (paced replay) until len bytes are released or the timeout passes */
+/* return   : int                   end of the released bytes                */
+static int replay_wait(REPLAY_DEVICE *hCom, int inTimeOutTimer, int len)
+{
+    unsigned long long deadline = com_capture_time() + (unsigned long long)(inTimeOutTimer > 0 ? inTimeOutTimer : 0) * 1000;
+    unsigned long long now, next;
+    int nEnd;
+
+    if ( hCom->bLoop && hCom->nSend == 0 && hCom->nRead >= hCom->nSize ) {
+        replay_rewind(hCom);
+    }
+    for ( ;; ) {
+        next = deadline;
+        nEnd = replay_released(hCom, &next);
+        if ( nEnd - hCom->nRead >= len || nEnd >= hCom->nSize ) break;
+        now = com_capture_time();
+        if ( now >= deadline ) break;
+        replay_sleep(((next < deadline) ? next : deadline) - now);
+    }
+    return nEnd;
+}
+
+static int replay_recv(HCOM hDev, int inTimeOutTimer, unsigned char *buf, int len)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+    int nEnd = replay_wait(hCom, inTimeOutTimer, len);
+
+    if ( len > nEnd - hCom->nRead ) {
+        len = nEnd - hCom->nRead;
+    }
+    memcpy(buf, &hCom->pData[hCom->nRead], len);
+    hCom->nRead += len;
+    /* The file stands in for the line */
+    if ( len > 0 ) {
+        hDev->stats.nBytesIn += (unsigned long long)len;
+        hDev->stats.nReads++;
+    }
+    if ( hDev->pCapture != NULL ) {
+        com_capture_write(hDev, COM_CAPTURE_RX, buf, len);
+    }
+    return len;
+}
+
+static int replay_peek(HCOM hDev, int inTimeOutTimer, int len, COM_SPAN *outSpan)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+    int nEnd = replay_wait(hCom, inTimeOutTimer, len);
+
+    /* The whole stream is in memory: one region */
+    outSpan[0].pData = &hCom->pData[hCom->nRead];
+    outSpan[0].nSize = nEnd - hCom->nRead;
+    outSpan[1].pData = hCom->pData;
+    outSpan[1].nSize = 0;
+    return outSpan[0].nSize;
+}
+
+static void replay_consume(HCOM hDev, int len)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+    unsigned long long next;
+    int nEnd = replay_released(hCom, &next);
+
+    if ( len > nEnd - hCom->nRead ) {
+        len = nEnd - hCom->nRead;
+    }
+    if ( hDev->pCapture != NULL ) {
+        com_capture_write(hDev, COM_CAPTURE_RX, &hCom->pData[hCom->nRead], len);
+    }
+    hCom->nRead += len;
+    if ( len > 0 ) {
+        hDev->stats.nBytesIn += (unsigned long long)len;
+        hDev->stats.nReads++;
+    }
+}
+
+static int replay_length(HCOM hDev)
+{
+    REPLAY_DEVICE *hCom = (REPLAY_DEVICE *)hDev;
+    unsigned long long next;
+
+    return replay_released(hCom, &next) - hCom->nRead;
+}
+
+const COM_OPS com_replay_ops = {
+    "replay", replay_open, replay_close, replay_send, replay_recv, replay_length,
+    replay_peek, replay_consume, replay_sendv,
+    NULL                /* Runs on the caller's thread */
+};
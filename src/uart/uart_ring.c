@@ -0,0 +1,144 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Single-producer / single-consumer receive ring
+*/
+
+#include <string.h>
+#include "uart_ring.h"
+
+/*----------------------------------------------------------------------------*/
+/* Initialise the ring                                                        */
+/* param    : UART_RING     *ring   ring                                      */
+/*          : unsigned char *buf    storage                                   */
+/*          : unsigned int  size    storage size (power of two)               */
+/* return   : int                   0...normal, -1...size is not 2^n          */
+/*----------------------------------------------------------------------------*/
+int ring_init(UART_RING *ring, unsigned char *buf, unsigned int size)
+{
+    if ( size == 0 || (size & (size - 1)) != 0 || size > 0x80000000U ) {
+        return -1;
+    }
+    ring->pBuf  = buf;
+    ring->nSize = size;
+    ring->nMask = size - 1;
+    ring->nHead = 0;
+    ring->nTail = 0;
+    return 0;
+}
+
+/* Bytes currently buffered (either side) */
+unsigned int ring_length(UART_RING *ring)
+{
+    unsigned int tail = __atomic_load_n(&ring->nTail, __ATOMIC_ACQUIRE);
+    unsigned int head = __atomic_load_n(&ring->nHead, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Producer: append bytes with at most two memcpy()                           */
+/* return   : unsigned int      bytes stored; the remainder did not fit       */
+/*----------------------------------------------------------------------------*/
+unsigned int ring_write(UART_RING *ring, const unsigned char *data, unsigned int len)
+{
+    unsigned int head = ring->nHead;
+    unsigned int tail = __atomic_load_n(&ring->nTail, __ATOMIC_ACQUIRE);
+    unsigned int space = ring->nSize - (head - tail);
+    unsigned int pos = head & ring->nMask;
+    unsigned int first;
+
+    if ( len > space ) len = space;
+    if ( len == 0 ) return 0;
+
+    first = ring->nSize - pos;
+    if ( first > len ) first = len;
+    memcpy(&ring->pBuf[pos], data, first);
+    memcpy(&ring->pBuf[0], &data[first], len - first);
+
+    /* Publish the bytes before the new head becomes visible */
+    __atomic_store_n(&ring->nHead, head + len, __ATOMIC_RELEASE);
+    return len;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Consumer: take up to len bytes with at most two memcpy()                   */
+/* return   : unsigned int      bytes copied to buf                           */
+/*----------------------------------------------------------------------------*/
+unsigned int ring_read(UART_RING *ring, unsigned char *buf, unsigned int len)
+{
+    unsigned int tail = ring->nTail;
+    unsigned int head = __atomic_load_n(&ring->nHead, __ATOMIC_ACQUIRE);
+    unsigned int pos = tail & ring->nMask;
+    unsigned int first;
+
+    if ( len > head - tail ) len = head - tail;
+    if ( len == 0 ) return 0;
+
+    first = ring->nSize - pos;
+    if ( first > len ) first = len;
+    memcpy(buf, &ring->pBuf[pos], first);
+    memcpy(&buf[first], &ring->pBuf[0], len - first);
+
+    /* Hand the space back only after the copy is complete */
+    __atomic_store_n(&ring->nTail, tail + len, __ATOMIC_RELEASE);
+    return len;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Consumer: expose the buffered bytes in place, without copying             */
+/* param    : UART_RING     *ring       ring                                  */
+/*          : UART_SPAN     outSpan[2]  [0] from the tail up to the wrap      */
+/*                                      point, [1] the rest from the start    */
+/*                                      of the storage (nSize 0 if unwrapped) */
+/* return   : unsigned int              bytes covered by both spans           */
+/*----------------------------------------------------------------------------*/
+unsigned int ring_peek(UART_RING *ring, UART_SPAN *outSpan)
+{
+    unsigned int tail = ring->nTail;
+    unsigned int head = __atomic_load_n(&ring->nHead, __ATOMIC_ACQUIRE);
+    unsigned int pos = tail & ring->nMask;
+    unsigned int len = head - tail;
+    unsigned int first;
+
+    first = ring->nSize - pos;
+    if ( first > len ) first = len;
+    outSpan[0].pData = &ring->pBuf[pos];
+    outSpan[0].nSize = first;
+    outSpan[1].pData = &ring->pBuf[0];
+    outSpan[1].nSize = len - first;
+    return len;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Consumer: release bytes looked at through ring_peek()                      */
+/* param    : unsigned int  len         bytes to drop, clamped to the length  */
+/*----------------------------------------------------------------------------*/
+void ring_consume(UART_RING *ring, unsigned int len)
+{
+    unsigned int tail = ring->nTail;
+    unsigned int head = __atomic_load_n(&ring->nHead, __ATOMIC_ACQUIRE);
+
+    if ( len > head - tail ) len = head - tail;
+    /* The producer may reuse the space as soon as it sees the new tail */
+    __atomic_store_n(&ring->nTail, tail + len, __ATOMIC_RELEASE);
+}
+
+/* Consumer: discard everything buffered so far */
+void ring_clear(UART_RING *ring)
+{
+    __atomic_store_n(&ring->nTail, __atomic_load_n(&ring->nHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
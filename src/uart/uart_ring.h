@@ -0,0 +1,62 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Single-producer / single-consumer receive ring
+*/
+
+#ifndef UART_RING_H__
+#define UART_RING_H__
+
+#define RING_CACHE_LINE     64
+
+/* head and tail are free-running byte counters; (head - tail) is the    */
+/* number of buffered bytes. Only the producer stores head and only the  */
+/* consumer stores tail, so neither side needs a lock.                   */
+typedef struct {
+    unsigned char   *pBuf;          /* Storage, nSize bytes */
+    unsigned int    nSize;          /* Capacity, power of two */
+    unsigned int    nMask;          /* nSize - 1 */
+    char            pad0[RING_CACHE_LINE];
+    unsigned int    nHead;          /* Total bytes written (producer) */
+    char            pad1[RING_CACHE_LINE];
+    unsigned int    nTail;          /* Total bytes consumed (consumer) */
+    char            pad2[RING_CACHE_LINE];
+} UART_RING;
+
+/* One contiguous readable region of the ring (ring_peek()) */
+typedef struct {
+    const unsigned char *pData;
+    unsigned int        nSize;
+} UART_SPAN;
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+int ring_init(UART_RING *ring, unsigned char *buf, unsigned int size);
+unsigned int ring_length(UART_RING *ring);
+unsigned int ring_write(UART_RING *ring, const unsigned char *data, unsigned int len);
+unsigned int ring_read(UART_RING *ring, unsigned char *buf, unsigned int len);
+unsigned int ring_peek(UART_RING *ring, UART_SPAN *outSpan);
+void ring_consume(UART_RING *ring, unsigned int len);
+void ring_clear(UART_RING *ring);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  /* UART_RING_H__ */
@@ -0,0 +1,302 @@
+/*---------------------------------------------------------------------------*/
+/* Copyright(C)  2026  OMRON Corporation                                     */
+/*                                                                           */
+/* Licensed under the Apache License, Version 2.0 (the "License");           */
+/* you may not use this file except in compliance with the License.          */
+/* You may obtain a copy of the License at                                   */
+/*                                                                           */
+/*     http://www.apache.org/licenses/LICENSE-2.0                            */
+/*                                                                           */
+/* Unless required by applicable law or agreed to in writing, software       */
+/* distributed under the License is distributed on an "AS IS" BASIS,         */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  */
+/* See the License for the specific language governing permissions and       */
+/* limitations under the License.                                            */
+/*---------------------------------------------------------------------------*/
+
+/*
+    Transport selection and dispatch
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "uart.h"
+
+#define COM_OPS_MAX     16
+
+/* Backends searched by com_open(); com_register_transport() appends */
+static const COM_OPS *m_pOpsList[COM_OPS_MAX] = {
+    &com_tty_ops,
+#ifndef WIN32
+    &com_pty_ops,
+#endif
+    &com_loopback_ops,
+    &com_replay_ops,
+};
+
+/*----------------------------------------------------------------------------*/
+/* Register an additional transport backend                                   */
+/* param    : const COM_OPS *pOps   backend (must stay valid)                 */
+/* return   : int                   0...normal, -1...table full or bad name   */
+/*----------------------------------------------------------------------------*/
+int com_register_transport(const COM_OPS *pOps)
+{
+    int i;
+
+    if ( pOps == NULL || pOps->name == NULL || pOps->open == NULL ) return -1;
+
+    for ( i = 0; i < COM_OPS_MAX; i++ ) {
+        if ( m_pOpsList[i] == NULL ) {
+            m_pOpsList[i] = pOps;
+            return 0;
+        }
+        if ( strcmp(m_pOpsList[i]->name, pOps->name) == 0 ) {
+            /* A later registration replaces a backend of the same name */
+            m_pOpsList[i] = pOps;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Open a port through the backend named in the spec string                   */
+/* param    : const char    *spec   "<backend>:<target>" or "<backend>";      */
+/*                                  a spec without a known prefix is a tty    */
+/*                                  device path                               */
+/*          : unsigned long BaudRate    baud rate (tty only)                  */
+/* return   : HCOM                  port handle, NULL on failure              */
+/*----------------------------------------------------------------------------*/
+HCOM com_open(const char *spec, unsigned long BaudRate)
+{
+    int i;
+    size_t nLen;
+
+    if ( spec == NULL ) return NULL;
+
+    for ( i = 0; i < COM_OPS_MAX && m_pOpsList[i] != NULL; i++ ) {
+        nLen = strlen(m_pOpsList[i]->name);
+        if ( strncmp(spec, m_pOpsList[i]->name, nLen) != 0 ) continue;
+        if ( spec[nLen] == ':' ) {
+            return m_pOpsList[i]->open(&spec[nLen+1], BaudRate);
+        }
+        if ( spec[nLen] == '\0' ) {
+            return m_pOpsList[i]->open("", BaudRate);
+        }
+    }
+    return com_tty_ops.open(spec, BaudRate);
+}
+
+HCOM com_init(S_STAT *stat)
+{
+    char device[16];
+
+#ifdef WIN32
+    sprintf_s(device, 16, "\\\\.\\COM%d", stat->com_num);
+#else
+    sprintf(device, "/dev/ttyACM%d", stat->com_num);
+#endif
+    return com_tty_ops.open(device, stat->BaudRate);
+}
+
+void com_close(HCOM hCom)
+{
+    struct COM_CAPTURE *pCap;
+
+    if ( hCom == NULL ) return;
+    /* The backend stops its receive thread first; only then can the */
+    /* capture go away                                                */
+    pCap = hCom->pCapture;
+    hCom->pOps->close(hCom);
+    com_capture_free(pCap);
+}
+
+int com_send(HCOM hCom, unsigned char *buf, int len)
+{
+    int ret;
+
+    if ( hCom == NULL || len <= 0 ) return 0;
+    /* Logged before it goes out: the answer may be read (and logged) */
+    /* before the backend even returns                                */
+    if ( hCom->pCapture != NULL ) {
+        com_capture_write(hCom, COM_CAPTURE_TX, buf, len);
+    }
+    ret = hCom->pOps->send(hCom, buf, len);
+    if ( ret > 0 ) COM_STATS_ADD(hCom->stats.nBytesOut, (unsigned long long)ret);
+    return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Send one block gathered from several regions, without joining them first  */
+/* param    : HCOM          hCom    port                                      */
+/*          : COM_SPAN      *pVec   regions, in wire order                    */
+/*          : int           nVec    number of regions (COM_SENDV_MAX at most) */
+/* return   : int                   bytes actually sent; less than the total  */
+/*                                  when the line stopped taking data         */
+/*----------------------------------------------------------------------------*/
+int com_sendv(HCOM hCom, const COM_SPAN *pVec, int nVec)
+{
+    return com_sendv_flags(hCom, pVec, nVec, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/* com_sendv() with COM_SEND_* flags                                          */
+/* param    : int           nFlags  COM_SEND_KEEP_RX...a block that starts    */
+/*                                  with a sync byte leaves unread bytes in   */
+/*                                  place, for commands sent while answers to */
+/*                                  earlier ones are still due                */
+/* return   : int                   as com_sendv()                            */
+/*----------------------------------------------------------------------------*/
+int com_sendv_flags(HCOM hCom, const COM_SPAN *pVec, int nVec, int nFlags)
+{
+    int i, ret;
+    int nSent = 0;
+
+    if ( hCom == NULL || pVec == NULL || nVec <= 0 || nVec > COM_SENDV_MAX ) return 0;
+    if ( hCom->pCapture != NULL ) {
+        com_capture_writev(hCom, COM_CAPTURE_TX, pVec, nVec);
+    }
+    hCom->nSendFlags = nFlags;
+    if ( hCom->pOps->sendv != NULL ) {
+        nSent = hCom->pOps->sendv(hCom, pVec, nVec);
+    }
+    else {
+        for ( i = 0; i < nVec; i++ ) {
+            if ( pVec[i].nSize <= 0 ) continue;
+            ret = hCom->pOps->send(hCom, (unsigned char *)pVec[i].pData, pVec[i].nSize);
+            if ( ret > 0 ) nSent += ret;
+            if ( ret != pVec[i].nSize ) break;
+        }
+    }
+    hCom->nSendFlags = 0;
+    if ( nSent > 0 ) COM_STATS_ADD(hCom->stats.nBytesOut, (unsigned long long)nSent);
+    return nSent;
+}
+
+int com_recv(HCOM hCom, int inTimeOutTimer, unsigned char *buf, int len)
+{
+    int ret;
+
+    if ( hCom == NULL || len <= 0 ) return 0;
+    ret = hCom->pOps->recv(hCom, inTimeOutTimer, buf, len);
+    if ( ret < len ) COM_STATS_ADD(hCom->stats.nTimeouts, 1);
+    return ret;
+}
+
+int com_length(HCOM hCom)
+{
+    if ( hCom == NULL ) return 0;
+    return hCom->pOps->length(hCom);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Look at received bytes without copying them out                            */
+/* param    : HCOM      hCom            port                                  */
+/*          : int       inTimeOutTimer  timeout time (ms)                     */
+/*          : int       len             bytes to wait for                     */
+/*          : COM_SPAN  outSpan[2]      everything buffered, in order; the    */
+/*                                      second region is empty unless the     */
+/*                                      data wraps around                     */
+/* return   : int                       bytes covered by outSpan, less than   */
+/*                                      len on timeout; -1...not supported by */
+/*                                      the backend (use com_recv())          */
+/*                                                                            */
+/* The regions stay valid until com_consume(), com_recv() or com_send() on    */
+/* the same port. Nothing is removed until com_consume() is called.           */
+/*----------------------------------------------------------------------------*/
+int com_peek(HCOM hCom, int inTimeOutTimer, int len, COM_SPAN *outSpan)
+{
+    int ret;
+
+    if ( hCom == NULL || hCom->pOps->peek == NULL ) return -1;
+    ret = hCom->pOps->peek(hCom, inTimeOutTimer, len, outSpan);
+    if ( ret < len ) COM_STATS_ADD(hCom->stats.nTimeouts, 1);
+    return ret;
+}
+
+/* Drop len bytes from the front of what com_peek() exposed */
+void com_consume(HCOM hCom, int len)
+{
+    if ( hCom == NULL || len <= 0 || hCom->pOps->consume == NULL ) return;
+    hCom->pOps->consume(hCom, len);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Scheduling, CPU affinity and memory locking of the receive thread          */
+/* param    : HCOM          hCom        port                                  */
+/*          : COM_RX_CONFIG *pConfig    settings, applied at once             */
+/* return   : int                       0...normal, COM_RX_CONFIG_* on error  */
+/*                                      (first failing setting)               */
+/*----------------------------------------------------------------------------*/
+int com_set_rx_config(HCOM hCom, const COM_RX_CONFIG *pConfig)
+{
+    if ( hCom == NULL || pConfig == NULL || hCom->pOps->rxconfig == NULL ) {
+        return COM_RX_CONFIG_UNSUPPORTED;
+    }
+    return hCom->pOps->rxconfig(hCom, pConfig);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Snapshot of the transport counters of a port                               */
+/* param    : HCOM      hCom        port                                      */
+/*          : COM_STATS *outStats   counters                                  */
+/* return   : int                   0...normal, -1...no port                  */
+/*                                                                            */
+/* nOverrunBytes > 0 means the host did not keep up with the line; it shows   */
+/* here before it shows up as broken responses.                               */
+/*----------------------------------------------------------------------------*/
+int com_get_stats(HCOM hCom, COM_STATS *outStats)
+{
+    COM_STATS *pStats;
+
+    if ( hCom == NULL || outStats == NULL ) return -1;
+    pStats = &hCom->stats;
+    outStats->nBytesIn      = COM_STATS_GET(pStats->nBytesIn);
+    outStats->nBytesOut     = COM_STATS_GET(pStats->nBytesOut);
+    outStats->nReads        = COM_STATS_GET(pStats->nReads);
+    outStats->nWakeups      = COM_STATS_GET(pStats->nWakeups);
+    outStats->nOverrunBytes = COM_STATS_GET(pStats->nOverrunBytes);
+    outStats->nResyncs      = COM_STATS_GET(pStats->nResyncs);
+    outStats->nResyncBytes  = COM_STATS_GET(pStats->nResyncBytes);
+    outStats->nHeaderResyncs = COM_STATS_GET(pStats->nHeaderResyncs);
+    outStats->nHeaderSkips  = COM_STATS_GET(pStats->nHeaderSkips);
+    outStats->nTimeouts     = COM_STATS_GET(pStats->nTimeouts);
+    outStats->nMaxBuffered  = COM_STATS_GET(pStats->nMaxBuffered);
+    outStats->nBufferSize   = pStats->nBufferSize;
+    return 0;
+}
+
+/* Start counting again from zero (nBufferSize is kept). Each counter is */
+/* cleared on its own, as the receive thread may be updating the others. */
+void com_reset_stats(HCOM hCom)
+{
+    COM_STATS *pStats;
+
+    if ( hCom == NULL ) return;
+    pStats = &hCom->stats;
+    COM_STATS_SET(pStats->nBytesIn, 0);
+    COM_STATS_SET(pStats->nBytesOut, 0);
+    COM_STATS_SET(pStats->nReads, 0);
+    COM_STATS_SET(pStats->nWakeups, 0);
+    COM_STATS_SET(pStats->nOverrunBytes, 0);
+    COM_STATS_SET(pStats->nResyncs, 0);
+    COM_STATS_SET(pStats->nResyncBytes, 0);
+    COM_STATS_SET(pStats->nHeaderResyncs, 0);
+    COM_STATS_SET(pStats->nHeaderSkips, 0);
+    COM_STATS_SET(pStats->nTimeouts, 0);
+    COM_STATS_SET(pStats->nMaxBuffered, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Count a response header found (or given up on) past stray bytes            */
+/* Called by the application's UART_NotifyResync() hook: HVCApi skips the     */
+/* bytes itself, so the port cannot tell them from a response.                */
+/* param    : HCOM      hCom        port                                      */
+/*          : int       nSkipBytes  bytes skipped before the header           */
+/*----------------------------------------------------------------------------*/
+void com_count_resync(HCOM hCom, int nSkipBytes)
+{
+    if ( hCom == NULL || nSkipBytes <= 0 ) return;
+    COM_STATS_ADD(hCom->stats.nHeaderResyncs, 1);
+    COM_STATS_ADD(hCom->stats.nHeaderSkips, (unsigned long long)nSkipBytes);
+}
@@ -17,29 +17,42 @@
 #include <windows.h>
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "uart.h"
 
-static HANDLE hCom = INVALID_HANDLE_VALUE;
+/* One opened serial port */
+typedef struct {
+    struct COM_DEVICE   base;       /* Must be first */
+    HANDLE              hFile;
+} TTY_DEVICE;
 
 /* UART */
-void com_close(void)
+static void tty_close(HCOM hDev)
 {
-    if ( hCom != INVALID_HANDLE_VALUE ) {
-        CloseHandle(hCom);
-        hCom = INVALID_HANDLE_VALUE;
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+
+    if ( hCom->hFile != INVALID_HANDLE_VALUE ) {
+        CloseHandle(hCom->hFile);
     }
+    free(hCom);
 }
 
-int com_init(S_STAT *stat)
+static HCOM tty_open(const char *device, unsigned long BaudRate)
 {
     DCB dcb;
     BOOL fSuccess;
-    char device[16];
+    TTY_DEVICE *hCom;
 
-    com_close();
+    hCom = (TTY_DEVICE *)malloc(sizeof(TTY_DEVICE));
+    if ( hCom == NULL ) {
+        return NULL;
+    }
+    hCom->base.pOps = &com_tty_ops;
+    hCom->base.pCapture = NULL;
+    memset(&hCom->base.stats, 0, sizeof(hCom->base.stats));
 
-    sprintf_s(device, 16, "\\\\.\\COM%d", stat->com_num);
-    hCom = CreateFile(device,
+    hCom->hFile = CreateFile(device,
                         GENERIC_READ | GENERIC_WRITE,
                         0,
                         NULL,
@@ -47,17 +60,18 @@ int com_init(S_STAT *stat)
                         0,
                         NULL);
 
-    if ( hCom == INVALID_HANDLE_VALUE ) {
-        return(FALSE);
+    if ( hCom->hFile == INVALID_HANDLE_VALUE ) {
+        tty_close(&hCom->base);
+        return NULL;
     }
 
-    fSuccess = GetCommState(hCom,&dcb);
+    fSuccess = GetCommState(hCom->hFile,&dcb);
     if ( !fSuccess ) {
-        com_close();
-        return(FALSE);
+        tty_close(&hCom->base);
+        return NULL;
     }
 
-    dcb.BaudRate = stat->BaudRate;
+    dcb.BaudRate = BaudRate;
     dcb.ByteSize = 8;
     dcb.Parity   = NOPARITY;
     dcb.StopBits = ONESTOPBIT;
@@ -67,34 +81,35 @@ int com_init(S_STAT *stat)
     dcb.fRtsControl = RTS_CONTROL_DISABLE;
     dcb.fDtrControl = DTR_CONTROL_DISABLE;
 
-    fSuccess = SetCommState(hCom,&dcb);
+    fSuccess = SetCommState(hCom->hFile,&dcb);
     if ( !fSuccess ) {
-        com_close();
-        return(FALSE);
+        tty_close(&hCom->base);
+        return NULL;
     }
 
-    fSuccess = SetupComm(hCom, 10240, 10240);
+    fSuccess = SetupComm(hCom->hFile, 10240, 10240);
     if ( !fSuccess ) {
-        com_close();
-        return(FALSE);
+        tty_close(&hCom->base);
+        return NULL;
     }
 
-    return TRUE;
+    return &hCom->base;
 }
 
-int com_send(unsigned char *buf, int len)
+static int tty_send(HCOM hDev, unsigned char *buf, int len)
 {
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
     DWORD dwSize = 0;
     DWORD dwTotal = 0;
 
-    if ( hCom != INVALID_HANDLE_VALUE ) {
+    if ( hCom->hFile != INVALID_HANDLE_VALUE ) {
 		while ((DWORD)len > 0) {
 			dwSize = 0;
 			if (len > 63) {
-		        WriteFile(hCom,&buf[dwTotal],63,&dwSize,NULL);
+		        WriteFile(hCom->hFile,&buf[dwTotal],63,&dwSize,NULL);
 			}
 			else {
-		        WriteFile(hCom,&buf[dwTotal],len,&dwSize,NULL);
+		        WriteFile(hCom->hFile,&buf[dwTotal],len,&dwSize,NULL);
 			}
 			if (dwSize == 0) {
 				break;
@@ -106,8 +121,9 @@ int com_send(unsigned char *buf, int len)
     return (int)dwTotal;
 }
 
-int com_recv(int inTimeOutTimer, unsigned char *buf, int len)
+static int tty_recv(HCOM hDev, int inTimeOutTimer, unsigned char *buf, int len)
 {
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
     DWORD ierr;
     COMSTAT stat;
     DWORD dwSize = 0;
@@ -123,14 +139,19 @@ int com_recv(int inTimeOutTimer, unsigned char *buf, int len)
 
     QueryPerformanceFrequency(&timeFreq);
 
-    if ( hCom != INVALID_HANDLE_VALUE ) {
+    if ( hCom->hFile != INVALID_HANDLE_VALUE ) {
         QueryPerformanceCounter(&startTime);
         do{
-            ClearCommError(hCom,&ierr,&stat);
+            ClearCommError(hCom->hFile,&ierr,&stat);
             if ( stat.cbInQue >= 1 ) {
                 ret = len - totalSize;
                 if ( ret > (int)stat.cbInQue ) ret = stat.cbInQue;
-                ReadFile(hCom,&buf[totalSize],ret,&dwSize,NULL);
+                ReadFile(hCom->hFile,&buf[totalSize],ret,&dwSize,NULL);
+                COM_STATS_ADD(hCom->base.stats.nBytesIn, dwSize);
+                COM_STATS_ADD(hCom->base.stats.nReads, 1);
+                if ( hCom->base.pCapture != NULL ) {
+                    com_capture_write(hDev, COM_CAPTURE_RX, &buf[totalSize], (int)dwSize);
+                }
                 totalSize += (int)dwSize;
             }
             if ( totalSize >= len ) break;
@@ -142,3 +163,20 @@ int com_recv(int inTimeOutTimer, unsigned char *buf, int len)
     }
     return totalSize;
 }
+
+static int tty_length(HCOM hDev)
+{
+    TTY_DEVICE *hCom = (TTY_DEVICE *)hDev;
+    DWORD ierr;
+    COMSTAT stat;
+
+    if ( !ClearCommError(hCom->hFile,&ierr,&stat) ) return 0;
+    return (int)stat.cbInQue;
+}
+
+const COM_OPS com_tty_ops = {
+    "tty", tty_open, tty_close, tty_send, tty_recv, tty_length,
+    NULL, NULL,     /* No host-side buffer to peek into */
+    NULL,           /* com_sendv() goes through tty_send() */
+    NULL            /* Read on the caller's thread */
+};